@@ -0,0 +1,250 @@
+#include "stdafx.h"
+#include "Animator.h"
+#include "Texture.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace
+{
+	// A frame of 0 seconds would keep Advance from ever leaving it
+	const float g_MinFrameSec{ 0.001f };
+	// secLeft of a finished animation: Advance skips it
+	const float g_Never{ std::numeric_limits<float>::max( ) };
+}
+
+AnimationClip::AnimationClip( )
+	:srcRects{ }
+	,frameSecs{ }
+	,loop{ AnimationLoop::loop }
+{
+}
+
+AnimationClip::AnimationClip( const Rectf& firstFrame, int nrCols, int nrFrames, float frameSec, AnimationLoop loop )
+	:AnimationClip{ }
+{
+	this->loop = loop;
+	nrCols = std::max( nrCols, 1 );
+	for ( int idx{ 0 }; idx < nrFrames; ++idx )
+	{
+		// srcRect.bottom counts from the top of the image, so the next row is further down the sheet
+		const Rectf srcRect{ firstFrame.left + ( idx % nrCols ) * firstFrame.width, firstFrame.bottom + ( idx / nrCols ) * firstFrame.height,
+			firstFrame.width, firstFrame.height };
+		AddFrame( srcRect, frameSec );
+	}
+}
+
+void AnimationClip::AddFrame( const Rectf& srcRect, float frameSec )
+{
+	srcRects.push_back( srcRect );
+	frameSecs.push_back( frameSec );
+}
+
+Animator::Animator( int capacity )
+	:m_Animations{ capacity }
+	,m_Clips{ }
+	,m_Frames{ }
+	,m_DestRects{ }
+	,m_SrcRects{ }
+{
+}
+
+int Animator::AddClip( const AnimationClip& clip )
+{
+	if ( clip.srcRects.empty( ) || clip.srcRects.size( ) != clip.frameSecs.size( ) )
+	{
+		std::cerr << "Animator::AddClip( ), a clip needs at least one frame and a time for each frame, got " << clip.srcRects.size( )
+			<< " srcRects and " << clip.frameSecs.size( ) << " frameSecs\n";
+		return -1;
+	}
+
+	Clip newClip{ int( m_Frames.size( ) ), int( clip.srcRects.size( ) ), clip.loop, 0.0f };
+	for ( size_t idx{ 0 }; idx < clip.srcRects.size( ); ++idx )
+	{
+		const float sec{ std::max( clip.frameSecs[idx], g_MinFrameSec ) };
+		m_Frames.push_back( Frame{ clip.srcRects[idx], sec } );
+		newClip.cycleSec += sec;
+	}
+	if ( clip.loop == AnimationLoop::pingPong && newClip.nrFrames > 1 )
+	{
+		// The first and last frames show once per cycle, the others twice
+		newClip.cycleSec = 2.0f * newClip.cycleSec - m_Frames[newClip.firstFrame].sec - m_Frames.back( ).sec;
+	}
+	m_Clips.push_back( newClip );
+	return int( m_Clips.size( ) ) - 1;
+}
+
+int Animator::GetNrClips( ) const
+{
+	return int( m_Clips.size( ) );
+}
+
+PoolHandle Animator::Play( int clipId, const Rectf& destRect, float speed )
+{
+	if ( clipId < 0 || clipId >= int( m_Clips.size( ) ) )
+	{
+		std::cerr << "Animator::Play( ), unknown clip id: " << clipId << '\n';
+		return PoolHandle{ };
+	}
+
+	Animation animation{ };
+	animation.destRect = destRect;
+	animation.speed = std::max( speed, 0.0f );
+	Start( animation, clipId );
+	return m_Animations.Spawn( animation );
+}
+
+bool Animator::Stop( PoolHandle handle )
+{
+	return m_Animations.Despawn( handle );
+}
+
+void Animator::SetClip( PoolHandle handle, int clipId )
+{
+	Animation* pAnimation{ m_Animations.Get( handle ) };
+	if ( pAnimation == nullptr || pAnimation->clip == clipId )
+	{
+		return;
+	}
+	if ( clipId < 0 || clipId >= int( m_Clips.size( ) ) )
+	{
+		std::cerr << "Animator::SetClip( ), unknown clip id: " << clipId << '\n';
+		return;
+	}
+	Start( *pAnimation, clipId );
+}
+
+void Animator::SetDestRect( PoolHandle handle, const Rectf& destRect )
+{
+	Animation* pAnimation{ m_Animations.Get( handle ) };
+	if ( pAnimation != nullptr )
+	{
+		pAnimation->destRect = destRect;
+	}
+}
+
+void Animator::SetSpeed( PoolHandle handle, float speed )
+{
+	Animation* pAnimation{ m_Animations.Get( handle ) };
+	if ( pAnimation != nullptr )
+	{
+		pAnimation->speed = std::max( speed, 0.0f );
+	}
+}
+
+bool Animator::IsPlaying( PoolHandle handle ) const
+{
+	return m_Animations.IsAlive( handle );
+}
+
+bool Animator::IsFinished( PoolHandle handle ) const
+{
+	const Animation* pAnimation{ m_Animations.Get( handle ) };
+	return pAnimation != nullptr && pAnimation->isFinished;
+}
+
+int Animator::GetFrame( PoolHandle handle ) const
+{
+	const Animation* pAnimation{ m_Animations.Get( handle ) };
+	return pAnimation != nullptr ? pAnimation->frame : 0;
+}
+
+Rectf Animator::GetSrcRect( PoolHandle handle ) const
+{
+	const Animation* pAnimation{ m_Animations.Get( handle ) };
+	return pAnimation != nullptr ? pAnimation->srcRect : Rectf{ };
+}
+
+void Animator::Advance( float elapsedSec )
+{
+	for ( Animation& animation : m_Animations )
+	{
+		animation.secLeft -= elapsedSec * animation.speed;
+		if ( animation.secLeft > 0.0f )
+		{
+			continue;
+		}
+
+		const Clip& clip{ m_Clips[animation.clip] };
+		// After a long hitch, whole cycles end where they started
+		if ( clip.loop != AnimationLoop::once && -animation.secLeft >= clip.cycleSec )
+		{
+			animation.secLeft = -std::fmod( -animation.secLeft, clip.cycleSec );
+		}
+		while ( animation.secLeft <= 0.0f )
+		{
+			NextFrame( animation, clip );
+			if ( animation.isFinished )
+			{
+				animation.secLeft = g_Never;
+				break;
+			}
+			animation.secLeft += m_Frames[clip.firstFrame + animation.frame].sec;
+		}
+		animation.srcRect = m_Frames[clip.firstFrame + animation.frame].srcRect;
+	}
+}
+
+void Animator::Draw( const Texture& spriteSheet ) const
+{
+	m_DestRects.clear( );
+	m_SrcRects.clear( );
+	for ( const Animation& animation : m_Animations )
+	{
+		m_DestRects.push_back( animation.destRect );
+		m_SrcRects.push_back( animation.srcRect );
+	}
+	spriteSheet.Draw( m_DestRects.data( ), m_SrcRects.data( ), int( m_DestRects.size( ) ) );
+}
+
+int Animator::GetSize( ) const
+{
+	return m_Animations.GetSize( );
+}
+
+void Animator::Clear( )
+{
+	m_Animations.Clear( );
+}
+
+void Animator::Start( Animation& animation, int clipId ) const
+{
+	const Frame& firstFrame{ m_Frames[m_Clips[clipId].firstFrame] };
+	animation.srcRect = firstFrame.srcRect;
+	animation.secLeft = firstFrame.sec;
+	animation.clip = clipId;
+	animation.frame = 0;
+	animation.direction = 1;
+	animation.isFinished = false;
+}
+
+void Animator::NextFrame( Animation& animation, const Clip& clip ) const
+{
+	switch ( clip.loop )
+	{
+	case AnimationLoop::loop:
+		animation.frame = animation.frame + 1 < clip.nrFrames ? animation.frame + 1 : 0;
+		break;
+	case AnimationLoop::once:
+		if ( animation.frame + 1 < clip.nrFrames )
+		{
+			++animation.frame;
+		}
+		else
+		{
+			animation.isFinished = true;
+		}
+		break;
+	case AnimationLoop::pingPong:
+		if ( clip.nrFrames > 1 )
+		{
+			if ( animation.frame + animation.direction < 0 || animation.frame + animation.direction >= clip.nrFrames )
+			{
+				animation.direction = -animation.direction;
+			}
+			animation.frame += animation.direction;
+		}
+		break;
+	}
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include <vector>
+#include "ObjectPool.h"
+
+class Texture;
+
+enum class AnimationLoop
+{
+	// Starts over after the last frame
+	loop,
+	// Stays on the last frame
+	once,
+	// Plays backwards after the last frame, then forwards after the first one
+	pingPong
+};
+
+// The frames of an animation on a sprite sheet, srcRects as in Texture::Draw
+struct AnimationClip
+{
+	AnimationClip( );
+	// nrFrames frames of frameSec each: rows of nrCols frames of firstFrame's size, left to right, top to bottom
+	AnimationClip( const Rectf& firstFrame, int nrCols, int nrFrames, float frameSec, AnimationLoop loop = AnimationLoop::loop );
+
+	void AddFrame( const Rectf& srcRect, float frameSec );
+
+	std::vector<Rectf> srcRects;
+	// How long each frame shows, in seconds
+	std::vector<float> frameSecs;
+	AnimationLoop loop;
+};
+
+// Plays the animations of all sprites of one sprite sheet, in place of a frame counter and srcRect math per object:
+//		int runClip{ m_Animator.AddClip( AnimationClip{ Rectf{ 0, 0, 32, 32 }, 8, 8, 0.1f } ) };
+//		PoolHandle knight{ m_Animator.Play( runClip, Rectf{ 100, 100, 64, 64 } ) };
+//		...
+//		m_Animator.Advance( elapsedSec );		// Game::Update, after moving: SetDestRect( knight, ... )
+//		m_Animator.Draw( m_KnightSheet );		// Game::Draw
+//
+// The animations are kept packed in an ObjectPool and have no virtual functions: Advance is one pass over them that
+// only reads the clip when a frame ends, Draw sends all of them in one Texture::Draw call.
+// The clips are flattened into one array of frames.
+class Animator
+{
+public:
+	explicit Animator( int capacity );
+	Animator( const Animator& other ) = delete;
+	Animator& operator=( const Animator& other ) = delete;
+
+	// Returns the clip id for Play, -1 when the clip has no frames
+	int AddClip( const AnimationClip& clip );
+	int GetNrClips( ) const;
+
+	// Starts the clip at its first frame. speed 2 plays it twice as fast.
+	// Returns an invalid handle when the animator is full or the clip id is unknown
+	PoolHandle Play( int clipId, const Rectf& destRect, float speed = 1.0f );
+	// Returns false when the handle is stale
+	bool Stop( PoolHandle handle );
+	// These do nothing when the handle is stale
+	// Starts another clip at its first frame, keeps going when the clip is already playing
+	void SetClip( PoolHandle handle, int clipId );
+	void SetDestRect( PoolHandle handle, const Rectf& destRect );
+	void SetSpeed( PoolHandle handle, float speed );
+
+	bool IsPlaying( PoolHandle handle ) const;
+	// A once clip on its last frame, after that frame's time
+	bool IsFinished( PoolHandle handle ) const;
+	int GetFrame( PoolHandle handle ) const;
+	// The frame to draw, e.g. to cut a CollisionMask
+	Rectf GetSrcRect( PoolHandle handle ) const;
+
+	void Advance( float elapsedSec );
+	void Draw( const Texture& spriteSheet ) const;
+
+	int GetSize( ) const;
+	// Stops all animations, keeps the clips
+	void Clear( );
+
+private:
+	struct Clip
+	{
+		int firstFrame;
+		int nrFrames;
+		AnimationLoop loop;
+		// Until the animation is back in the same frame going the same way
+		float cycleSec;
+	};
+
+	struct Frame
+	{
+		Rectf srcRect;
+		float sec;
+	};
+
+	struct Animation
+	{
+		Rectf destRect;
+		Rectf srcRect;
+		// Of the current frame, the only member Advance touches while the frame lasts
+		float secLeft;
+		float speed;
+		int clip;
+		int frame;
+		// 1 or -1, for pingPong
+		int direction;
+		bool isFinished;
+	};
+
+	// DATA MEMBERS
+	ObjectPool<Animation> m_Animations;
+	std::vector<Clip> m_Clips;
+	std::vector<Frame> m_Frames;
+	// Draw gathers the rects here
+	mutable std::vector<Rectf> m_DestRects;
+	mutable std::vector<Rectf> m_SrcRects;
+
+	// FUNCTIONS
+	void Start( Animation& animation, int clipId ) const;
+	void NextFrame( Animation& animation, const Clip& clip ) const;
+};
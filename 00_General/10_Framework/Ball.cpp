@@ -0,0 +1,120 @@
+#include "stdafx.h"
+#include "Ball.h"
+#include "utils.h"
+#include "SceneFile.h"
+#include "RenderBackend.h"
+#include "Random.h"
+#include <cmath>
+#include <iostream>
+#include <vector>
+// SDL and OpenGL Includes
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <GL\GLU.h>
+
+
+Ball::Ball(Point2f position, Vector2f velocity, Color4f color, float radius)
+	:m_Position{ position }, m_Velocity{ velocity }, m_Color{ color }, m_Radius{ radius }
+{
+}
+
+Ball::Ball(const SceneFile& scene, const SceneEntity& entity)
+	:m_Position{ entity.nrPoints >= 1 ? scene.GetPoints()[entity.firstPoint] : Point2f{} }
+	, m_Velocity{ entity.nrPoints >= 2 ? Vector2f{ scene.GetPoints()[entity.firstPoint + 1] } : Vector2f{} }
+	, m_Color{ entity.colorIndex >= 0 ? scene.GetColors()[entity.colorIndex] : Color4f{ 1.0f, 1.0f, 1.0f, 1.0f } }
+	, m_Radius{ entity.radius }
+{
+	// SceneFile checked the indices, an entity that wasn't written by AddToScene can still lack points or a color
+	if (entity.nrPoints < 2 || entity.colorIndex < 0)
+	{
+		std::cerr << "Ball::Ball( ), scene entity without position, velocity and color, using defaults\n";
+	}
+}
+
+void Ball::Update(float elapsedSeconds, const Rectf& r)
+{
+	Update(elapsedSeconds, r, nullptr, 0);
+}
+
+void Ball::Update(float elapsedSeconds, const Rectf& r, const Rectf* pObstacles, int nrObstacles)
+{
+	
+	float left = r.left;
+	float bottom = r.bottom;
+	float right = r.left + r.width;
+	float top = r.bottom + r.height;
+
+	// Move, sub-stepping to the time of impact with any obstacle
+	Circlef circle{ m_Position, m_Radius };
+	if (dae::ResolveSweptCircle(circle, m_Velocity, elapsedSeconds, pObstacles, nrObstacles))
+	{
+		GenerateColor();
+	}
+	m_Position = circle.center;
+
+	if (m_Position.x + m_Radius > right && m_Velocity.x > 0) 
+	{
+		m_Velocity.x *= -1; 
+		GenerateColor();
+	}
+	if (m_Position.y + m_Radius > top && m_Velocity.y > 0)
+	{ 
+		m_Velocity.y *= -1; 
+		GenerateColor();
+	}
+	if (m_Position.x - m_Radius < left && m_Velocity.x < 0)
+	{ 
+		m_Velocity.x *= -1; 
+		GenerateColor();
+	}
+	if (m_Position.y - m_Radius < bottom && m_Velocity.y < 0)
+	{ 
+		m_Velocity.y *= -1; 
+		GenerateColor();
+	}
+
+}
+
+void Ball::Draw()
+{
+	FillCircle(m_Position, m_Radius, m_Color);
+}
+
+void Ball::AddToScene(SceneWriter& writer) const
+{
+	// Position and velocity are stored as 2 consecutive points
+	SceneEntity entity{};
+	entity.textureIndex = -1;
+	entity.rectIndex = -1;
+	entity.colorIndex = writer.AddColor(m_Color);
+	entity.firstPoint = writer.AddPoint(m_Position);
+	entity.nrPoints = 2;
+	writer.AddPoint(m_Velocity.ToPoint2f());
+	entity.radius = m_Radius;
+	writer.AddEntity(entity);
+}
+
+void Ball::FillCircle(const Point2f & center, float radius, const Color4f & color)
+{
+	const float pi{ 3.141592f };
+	int numSegments{ int(radius * 2) };
+	const float deltaAngle{ 2 * pi / numSegments };
+	dae::SetRenderColor(color);
+	static std::vector<Point2f> vertices;
+	vertices.clear();
+	vertices.push_back(center);
+	for (float angle{ 0.0f }; angle < 2 * pi + deltaAngle; angle += deltaAngle)
+	{
+		//std::cout << angle << std::endl;
+		// angle , radius => cart coordinates
+		vertices.push_back(Point2f{ center.x + radius * cosf(angle),
+			center.y + radius * sinf(angle) });
+	}
+	dae::RenderVertices(GL_TRIANGLE_FAN, vertices.data(), int(vertices.size()));
+}
+
+void Ball::GenerateColor()
+{
+	Random& random{ dae::GetRandom( ) };
+	m_Color = { random.GetInt( 0, 255 ) / 255.0f, random.GetInt( 0, 255 ) / 255.0f, random.GetInt( 0, 255 ) / 255.0f, 1.0f };
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include "structs.h"
+#include "Vector2f.h"
+
+class SceneFile;
+class SceneWriter;
+struct SceneEntity;
+
+class Ball
+{
+public:
+	Ball(Point2f position,	Vector2f velocity, Color4f color, float radius);
+	// Creates the ball stored by AddToScene, the entity has to come from that scene
+	Ball(const SceneFile& scene, const SceneEntity& entity);
+	void Update(float elapsedSeconds, const Rectf& r);
+	// Also bounces off the obstacles, sweeping the ball so it can't pass through thin ones
+	void Update(float elapsedSeconds, const Rectf& r, const Rectf* pObstacles, int nrObstacles);
+	void Draw();
+	void AddToScene(SceneWriter& writer) const;
+private:
+	void FillCircle(const Point2f & center, float radius, const Color4f & color);
+	void GenerateColor();
+	Point2f m_Position;
+	Vector2f m_Velocity;
+	Color4f m_Color;
+	float m_Radius{};
+};
+
@@ -0,0 +1,153 @@
+// 100k animated sprites: Animator::Advance, and Animator::Draw against one Texture::Draw per sprite,
+// on the shader backend when the driver has a 3.3 core profile.
+// Usage: AnimatorBenchmark <sprite sheet>, an image of 4 columns and 2 rows of frames.
+// Sources: Benchmarks/AnimatorBenchmark.cpp, Animator.cpp, Texture.cpp, TextureBudget.cpp, CollisionMask.cpp, SurfaceConversion.cpp,
+// ResourcePreload.cpp, HotReload.cpp, RenderBackend.cpp, RenderQueue.cpp, RenderStats.cpp, GlState.cpp, structs.cpp, Vector2f.cpp
+#include "../stdafx.h"
+#include "../Animator.h"
+#include "../Texture.h"
+#include "../RenderBackend.h"
+#include "../RenderStats.h"
+#include "../GlState.h"
+#include "Benchmark.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+namespace
+{
+	const int g_WindowWidth{ 1280 };
+	const int g_WindowHeight{ 800 };
+	const int g_NrSprites{ 100000 };
+	const int g_NrAdvances{ 30 };
+	const int g_NrFrames{ 5 };
+
+	// A 3.3 core profile for the shader backend, else the GL 2.1 state Core sets up for the fixed function pipeline
+	bool CreateContext( SDL_Window*& pWindow, SDL_GLContext& pContext )
+	{
+		if ( SDL_Init( SDL_INIT_VIDEO ) < 0 )
+		{
+			std::cerr << "SDL_Init: " << SDL_GetError( ) << '\n';
+			return false;
+		}
+		SDL_GL_SetAttribute( SDL_GL_CONTEXT_MAJOR_VERSION, 3 );
+		SDL_GL_SetAttribute( SDL_GL_CONTEXT_MINOR_VERSION, 3 );
+		SDL_GL_SetAttribute( SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE );
+		pWindow = SDL_CreateWindow( "AnimatorBenchmark", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+			g_WindowWidth, g_WindowHeight, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN );
+		if ( pWindow == nullptr )
+		{
+			std::cerr << "SDL_CreateWindow: " << SDL_GetError( ) << '\n';
+			return false;
+		}
+		pContext = SDL_GL_CreateContext( pWindow );
+		if ( pContext == nullptr || !dae::StartRenderBackend( RenderBackend::shaders, float( g_WindowWidth ), float( g_WindowHeight ) ) )
+		{
+			if ( pContext != nullptr )
+			{
+				SDL_GL_DeleteContext( pContext );
+			}
+			SDL_GL_SetAttribute( SDL_GL_CONTEXT_MAJOR_VERSION, 2 );
+			SDL_GL_SetAttribute( SDL_GL_CONTEXT_MINOR_VERSION, 1 );
+			SDL_GL_SetAttribute( SDL_GL_CONTEXT_PROFILE_MASK, 0 );
+			pContext = SDL_GL_CreateContext( pWindow );
+			if ( pContext == nullptr )
+			{
+				std::cerr << "SDL_GL_CreateContext: " << SDL_GetError( ) << '\n';
+				return false;
+			}
+			dae::StartRenderBackend( RenderBackend::fixedFunction, float( g_WindowWidth ), float( g_WindowHeight ) );
+			glMatrixMode( GL_PROJECTION );
+			glLoadIdentity( );
+			gluOrtho2D( 0, g_WindowWidth, 0, g_WindowHeight );
+			glMatrixMode( GL_MODELVIEW );
+			glLoadIdentity( );
+		}
+		SDL_GL_SetSwapInterval( 0 );
+		glViewport( 0, 0, g_WindowWidth, g_WindowHeight );
+		dae::SetGlCapability( GL_BLEND, true );
+		dae::SetGlBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+		return true;
+	}
+
+	// Draws one frame, returns its pixels
+	template <typename Function>
+	std::vector<Uint8> GetFramePixels( Function draw )
+	{
+		glClear( GL_COLOR_BUFFER_BIT );
+		draw( );
+		dae::FlushRenderBackend( );
+		std::vector<Uint8> pixels( size_t( g_WindowWidth ) * g_WindowHeight * 4 );
+		glReadPixels( 0, 0, g_WindowWidth, g_WindowHeight, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data( ) );
+		return pixels;
+	}
+}
+
+int main( int argc, char *argv[] )
+{
+	if ( argc < 2 )
+	{
+		std::cerr << "Usage: AnimatorBenchmark <sprite sheet>\n";
+		return 1;
+	}
+	SDL_Window* pWindow{ };
+	SDL_GLContext pContext{ };
+	if ( !CreateContext( pWindow, pContext ) )
+	{
+		return 1;
+	}
+	const bool isShaders{ dae::GetRenderBackend( ) == RenderBackend::shaders };
+	std::cout << glGetString( GL_RENDERER ) << ", " << ( isShaders ? "shader backend" : "fixed function pipeline" ) << '\n';
+
+	bool isOk{ true };
+	{
+		const Texture sheet{ argv[1] };
+		if ( !dae::Check( sheet.IsCreationOk( ), "sprite sheet creation" ) )
+		{
+			return 1;
+		}
+		Animator animator{ g_NrSprites };
+		const int clip{ animator.AddClip( AnimationClip{ Rectf{ 0.0f, 0.0f, sheet.GetWidth( ) / 4, sheet.GetHeight( ) / 2 }, 4, 8, 0.1f } ) };
+		std::vector<PoolHandle> sprites( g_NrSprites );
+		for ( int idx{ 0 }; idx < g_NrSprites; ++idx )
+		{
+			const Rectf destRect{ float( idx * 37 % g_WindowWidth ), float( idx * 91 % g_WindowHeight ), 8.0f, 8.0f };
+			sprites[idx] = animator.Play( clip, destRect, 1.0f + idx % 5 * 0.1f );
+		}
+		const double advanceMs{ dae::MeasureMs( [&animator] { animator.Advance( 1.0f / 60.0f ); }, g_NrAdvances ) };
+
+		// The same sprites and frames, one Texture::Draw each
+		auto drawEach = [&]
+		{
+			for ( int idx{ 0 }; idx < g_NrSprites; ++idx )
+			{
+				sheet.Draw( Rectf{ float( idx * 37 % g_WindowWidth ), float( idx * 91 % g_WindowHeight ), 8.0f, 8.0f }, animator.GetSrcRect( sprites[idx] ) );
+			}
+		};
+		auto drawAnimator = [&animator, &sheet] { animator.Draw( sheet ); };
+
+		// The batched draw has to draw every sprite, not just count them
+		dae::ResetRenderStats( );
+		const std::vector<Uint8> animatorPixels{ GetFramePixels( drawAnimator ) };
+		const int expectedVertices{ g_NrSprites * ( isShaders ? 6 : 4 ) };
+		isOk = dae::Check( dae::GetRenderStats( ).vertices == expectedVertices, "vertices sent by Animator::Draw" ) && isOk;
+		const std::vector<Uint8> eachPixels{ GetFramePixels( drawEach ) };
+		const std::vector<Uint8> clearPixels{ GetFramePixels( [] { } ) };
+		isOk = dae::Check( animatorPixels != clearPixels, "sprites on screen" ) && isOk;
+		isOk = dae::Check( animatorPixels == eachPixels, "Animator::Draw drawing what Texture::Draw per sprite draws" ) && isOk;
+
+		const double eachMs{ dae::MeasureMs( [&drawEach] { GetFramePixels( drawEach ); }, g_NrFrames ) };
+		const double animatorMs{ dae::MeasureMs( [&drawAnimator] { GetFramePixels( drawAnimator ); }, g_NrFrames ) };
+		std::cout << std::fixed << std::setprecision( 2 ) << g_NrSprites << " animated sprites of 8x8\n"
+			<< "  Advance:               " << advanceMs << " ms\n"
+			<< "  Animator::Draw:        " << animatorMs << " ms per frame\n"
+			<< "  Texture::Draw each:    " << eachMs << " ms per frame\n";
+	}
+
+	dae::StopRenderBackend( );
+	SDL_GL_DeleteContext( pContext );
+	SDL_DestroyWindow( pWindow );
+	SDL_Quit( );
+	return isOk ? 0 : 1;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <chrono>
+#include <iostream>
+
+// Helpers for the benchmarks in this folder.
+// Each .cpp file here is a console program with its own main, it is not part of a game project:
+// build it as a project of its own from that file and the framework sources listed at its top, in Release.
+// The results go to std::cout, the exit code is 1 when a result is wrong.
+namespace dae
+{
+	// Average duration of function in ms, over nrRuns calls
+	template <typename Function>
+	double MeasureMs( Function function, int nrRuns = 1 )
+	{
+		const std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now( ) };
+		for ( int run{ 0 }; run < nrRuns; ++run )
+		{
+			function( );
+		}
+		return std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now( ) - start ).count( ) / nrRuns;
+	}
+
+	inline bool Check( bool isOk, const char* pWhat )
+	{
+		if ( !isOk )
+		{
+			std::cerr << "Wrong result: " << pWhat << '\n';
+		}
+		return isOk;
+	}
+}
@@ -0,0 +1,76 @@
+// Cost of StateHistory::Capture per frame for 100k balls, and of restoring a frame.
+// Sources: Benchmarks/StateHistoryBenchmark.cpp, StateHistory.cpp, structs.cpp, Vector2f.cpp
+#include "../stdafx.h"
+#include "../StateHistory.h"
+#include "../Vector2f.h"
+#include "../Random.h"
+#include "Benchmark.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstring>
+
+namespace
+{
+	// The data members of Ball
+	struct BallState
+	{
+		Point2f position;
+		Vector2f velocity;
+		Color4f color;
+		float radius;
+	};
+
+	const int g_NrBalls{ 100000 };
+	const int g_NrFrames{ 300 };
+
+	// Captures g_NrFrames frames in which one ball out of movingStep moves, returns false when a restored frame is wrong
+	bool Run( int movingStep )
+	{
+		Random random{ 1 };
+		std::vector<BallState> balls( g_NrBalls );
+		for ( BallState& ball : balls )
+		{
+			ball = BallState{ Point2f{ random.GetFloat( 0.0f, 1280.0f ), random.GetFloat( 0.0f, 720.0f ) },
+				Vector2f{ random.GetFloat( -100.0f, 100.0f ), random.GetFloat( -100.0f, 100.0f ) }, Color4f{ 1.0f, 1.0f, 1.0f, 1.0f }, 5.0f };
+		}
+
+		StateHistory history{ 600, size_t( 256 ) * 1024 * 1024 };
+		history.AddRegion( balls.data( ), balls.size( ) * sizeof( BallState ) );
+		std::vector<BallState> expected{ };
+		double captureMs{ 0.0 };
+		size_t frameBytes{ 0 };
+		for ( int frame{ 0 }; frame < g_NrFrames; ++frame )
+		{
+			for ( size_t idx{ size_t( frame % movingStep ) }; idx < balls.size( ); idx += movingStep )
+			{
+				balls[idx].position.x += balls[idx].velocity.x / 60.0f;
+				balls[idx].position.y += balls[idx].velocity.y / 60.0f;
+			}
+			history.Capture( );
+			captureMs += history.GetLastCaptureMs( );
+			frameBytes += history.GetLastFrameSize( );
+			if ( frame == g_NrFrames - 1 - 45 )
+			{
+				expected = balls;
+			}
+		}
+		const double restoreMs{ dae::MeasureMs( [&history] { history.Restore( 45 ); }, 10 ) };
+
+		std::cout << "  1 in " << std::setw( 3 ) << movingStep << " balls moving: capture " << std::setw( 6 ) << captureMs / g_NrFrames
+			<< " ms/frame, " << std::setw( 6 ) << frameBytes / g_NrFrames / 1024 << " KB/frame of " << history.GetStateSize( ) / 1024
+			<< " KB, restore " << restoreMs << " ms\n";
+		return dae::Check( std::memcmp( balls.data( ), expected.data( ), balls.size( ) * sizeof( BallState ) ) == 0, "restored frame" );
+	}
+}
+
+int main( int argc, char *argv[] )
+{
+	std::cout << std::fixed << std::setprecision( 3 ) << "StateHistory, " << g_NrBalls << " balls, " << g_NrFrames << " frames\n";
+	bool isOk{ true };
+	for ( int movingStep : { 1, 10, 100 } )
+	{
+		isOk = Run( movingStep ) && isOk;
+	}
+	return isOk ? 0 : 1;
+}
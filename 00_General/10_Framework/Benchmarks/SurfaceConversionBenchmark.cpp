@@ -0,0 +1,167 @@
+// dae::ConvertToRgba8 for each 24 and 32 bit input format: correctness against SDL_ConvertSurfaceFormat, conversion time,
+// and uploading with the driver swizzling the format against converting first and uploading RGBA.
+// Sources: Benchmarks/SurfaceConversionBenchmark.cpp, SurfaceConversion.cpp
+#include "../stdafx.h"
+#include "../SurfaceConversion.h"
+#include "Benchmark.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+namespace
+{
+	const int g_Size{ 2048 };
+	const int g_NrRuns{ 10 };
+
+	struct InputFormat
+	{
+		const char* pName;
+		Uint32 format;
+		// What glTexImage2D reads this format as, 0 when it can't
+		GLenum glFormat;
+		GLenum glType;
+	};
+
+	SDL_Surface* CreateSurface( const InputFormat& inputFormat, int width, int height )
+	{
+		SDL_Surface* pSurface{ SDL_CreateRGBSurfaceWithFormat( 0, width, height, SDL_BITSPERPIXEL( inputFormat.format ), inputFormat.format ) };
+		if ( pSurface == nullptr )
+		{
+			std::cerr << "SDL_CreateRGBSurfaceWithFormat: " << SDL_GetError( ) << '\n';
+			return nullptr;
+		}
+		// Every byte value, alpha included, and the padding at the end of the rows
+		Uint8* pPixels{ static_cast<Uint8*>( pSurface->pixels ) };
+		for ( size_t idx{ 0 }; idx < size_t( pSurface->pitch ) * height; ++idx )
+		{
+			pPixels[idx] = Uint8( ( idx * 2654435761u ) >> 13 );
+		}
+		return pSurface;
+	}
+
+	// An odd width, so the rows of the 24 bit formats have padding and end in the scalar part of the conversion
+	bool IsConversionOk( const InputFormat& inputFormat, bool premultiplyAlpha )
+	{
+		SDL_Surface* pSurface{ CreateSurface( inputFormat, 101, 37 ) };
+		SDL_Surface* pExpected{ pSurface != nullptr ? SDL_ConvertSurfaceFormat( pSurface, SDL_PIXELFORMAT_RGBA32, 0 ) : nullptr };
+		std::vector<Uint8> rgba{ };
+		bool isOk{ pExpected != nullptr && dae::ConvertToRgba8( pSurface, rgba, premultiplyAlpha ) };
+		for ( int y{ 0 }; isOk && y < pSurface->h; ++y )
+		{
+			const Uint8* pRow{ static_cast<const Uint8*>( pExpected->pixels ) + size_t( y ) * pExpected->pitch };
+			for ( int x{ 0 }; x < pSurface->w * 4; ++x )
+			{
+				const Uint8 alpha{ pRow[x / 4 * 4 + 3] };
+				const Uint8 expected{ premultiplyAlpha && x % 4 != 3 ? Uint8( ( pRow[x] * alpha + 127 ) / 255 ) : pRow[x] };
+				isOk = isOk && rgba[size_t( y ) * pSurface->w * 4 + x] == expected;
+			}
+		}
+		SDL_FreeSurface( pExpected );
+		SDL_FreeSurface( pSurface );
+		return isOk;
+	}
+
+	bool CreateContext( SDL_Window*& pWindow, SDL_GLContext& pContext )
+	{
+		SDL_GL_SetAttribute( SDL_GL_CONTEXT_MAJOR_VERSION, 2 );
+		SDL_GL_SetAttribute( SDL_GL_CONTEXT_MINOR_VERSION, 1 );
+		pWindow = SDL_CreateWindow( "SurfaceConversionBenchmark", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 16, 16, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN );
+		pContext = pWindow != nullptr ? SDL_GL_CreateContext( pWindow ) : nullptr;
+		if ( pContext == nullptr )
+		{
+			std::cerr << "SDL_CreateWindow or SDL_GL_CreateContext: " << SDL_GetError( ) << '\n';
+			return false;
+		}
+		return true;
+	}
+}
+
+int main( int argc, char *argv[] )
+{
+	if ( SDL_Init( SDL_INIT_VIDEO ) < 0 )
+	{
+		std::cerr << "SDL_Init: " << SDL_GetError( ) << '\n';
+		return 1;
+	}
+	// The 32 bit formats by byte order, except XRGB8888: B, G, R, X on little endian processors.
+	// The driver can't read X as an alpha of 255, so it has no swizzled upload
+	const InputFormat inputFormats[]{
+		InputFormat{ "RGB24", SDL_PIXELFORMAT_RGB24, GL_RGB, GL_UNSIGNED_BYTE },
+		InputFormat{ "BGR24", SDL_PIXELFORMAT_BGR24, GL_BGR, GL_UNSIGNED_BYTE },
+		InputFormat{ "RGBA32", SDL_PIXELFORMAT_RGBA32, GL_RGBA, GL_UNSIGNED_BYTE },
+		InputFormat{ "BGRA32", SDL_PIXELFORMAT_BGRA32, GL_BGRA, GL_UNSIGNED_BYTE },
+		InputFormat{ "ARGB32", SDL_PIXELFORMAT_ARGB32, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8 },
+		InputFormat{ "XRGB8888", SDL_PIXELFORMAT_RGB888, 0, 0 } };
+
+	bool isOk{ true };
+	for ( const InputFormat& inputFormat : inputFormats )
+	{
+		for ( bool premultiplyAlpha : { false, true } )
+		{
+			if ( !IsConversionOk( inputFormat, premultiplyAlpha ) )
+			{
+				std::cerr << "Wrong result: conversion of " << inputFormat.pName << ( premultiplyAlpha ? ", premultiplied\n" : "\n" );
+				isOk = false;
+			}
+		}
+	}
+
+	std::vector<Uint8> rgba( size_t( g_Size ) * g_Size * 4 );
+	std::cout << std::fixed << std::setprecision( 2 ) << "Convert " << g_Size << "x" << g_Size << " to RGBA8, ms: plain, premultiplied\n";
+	for ( const InputFormat& inputFormat : inputFormats )
+	{
+		SDL_Surface* pSurface{ CreateSurface( inputFormat, g_Size, g_Size ) };
+		if ( pSurface == nullptr )
+		{
+			return 1;
+		}
+		const double plainMs{ dae::MeasureMs( [pSurface, &rgba] { dae::ConvertToRgba8( pSurface, rgba, false ); }, g_NrRuns ) };
+		const double premultipliedMs{ dae::MeasureMs( [pSurface, &rgba] { dae::ConvertToRgba8( pSurface, rgba, true ); }, g_NrRuns ) };
+		std::cout << "  " << std::left << std::setw( 8 ) << inputFormat.pName << std::right << std::setw( 8 ) << plainMs << std::setw( 8 ) << premultipliedMs << '\n';
+		SDL_FreeSurface( pSurface );
+	}
+
+	SDL_Window* pWindow{ };
+	SDL_GLContext pContext{ };
+	if ( !CreateContext( pWindow, pContext ) )
+	{
+		return 1;
+	}
+	GLuint textureId{ };
+	glGenTextures( 1, &textureId );
+	glBindTexture( GL_TEXTURE_2D, textureId );
+	std::cout << "Upload " << g_Size << "x" << g_Size << " to GL_RGBA on " << glGetString( GL_RENDERER ) << ", ms: driver swizzle, convert + RGBA\n";
+	for ( const InputFormat& inputFormat : inputFormats )
+	{
+		if ( inputFormat.glFormat == 0 )
+		{
+			continue;
+		}
+		SDL_Surface* pSurface{ CreateSurface( inputFormat, g_Size, g_Size ) };
+		if ( pSurface == nullptr )
+		{
+			return 1;
+		}
+		// The rows of a 2048 wide surface have no padding, so the driver can read them with the default unpack alignment
+		const double swizzleMs{ dae::MeasureMs( [pSurface, &inputFormat]
+		{
+			glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, g_Size, g_Size, 0, inputFormat.glFormat, inputFormat.glType, pSurface->pixels );
+			glFinish( );
+		}, g_NrRuns ) };
+		const double convertMs{ dae::MeasureMs( [pSurface, &rgba]
+		{
+			dae::ConvertToRgba8( pSurface, rgba, false );
+			glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, g_Size, g_Size, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data( ) );
+			glFinish( );
+		}, g_NrRuns ) };
+		std::cout << "  " << std::left << std::setw( 8 ) << inputFormat.pName << std::right << std::setw( 8 ) << swizzleMs << std::setw( 8 ) << convertMs << '\n';
+		SDL_FreeSurface( pSurface );
+	}
+	isOk = dae::Check( glGetError( ) == GL_NO_ERROR, "OpenGL error" ) && isOk;
+
+	glDeleteTextures( 1, &textureId );
+	SDL_GL_DeleteContext( pContext );
+	SDL_DestroyWindow( pWindow );
+	SDL_Quit( );
+	return isOk ? 0 : 1;
+}
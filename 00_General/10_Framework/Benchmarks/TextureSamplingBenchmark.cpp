@@ -0,0 +1,126 @@
+// Frame time of 2000 sprites drawn small from one image, for each TextureOptions, and the video memory they take.
+// Usage: TextureSamplingBenchmark <image>, e.g. a 1024x1024 png. S3TC is DXT1 for an opaque image, DXT5 otherwise.
+// Sources: Benchmarks/TextureSamplingBenchmark.cpp, Texture.cpp, TextureBudget.cpp, CollisionMask.cpp, SurfaceConversion.cpp,
+// ResourcePreload.cpp, HotReload.cpp, RenderBackend.cpp, RenderQueue.cpp, RenderStats.cpp, GlState.cpp, structs.cpp, Vector2f.cpp
+#include "../stdafx.h"
+#include "../Texture.h"
+#include "../TextureBudget.h"
+#include "../RenderBackend.h"
+#include "../GlState.h"
+#include "Benchmark.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+namespace
+{
+	const int g_WindowWidth{ 1280 };
+	const int g_WindowHeight{ 800 };
+	const int g_NrSprites{ 2000 };
+	const int g_NrFrames{ 10 };
+
+	struct Variant
+	{
+		const char* pName;
+		TextureOptions options;
+	};
+
+	// The GL state Core sets up for the fixed function pipeline, in a hidden window
+	bool CreateContext( SDL_Window*& pWindow, SDL_GLContext& pContext )
+	{
+		if ( SDL_Init( SDL_INIT_VIDEO ) < 0 )
+		{
+			std::cerr << "SDL_Init: " << SDL_GetError( ) << '\n';
+			return false;
+		}
+		SDL_GL_SetAttribute( SDL_GL_CONTEXT_MAJOR_VERSION, 2 );
+		SDL_GL_SetAttribute( SDL_GL_CONTEXT_MINOR_VERSION, 1 );
+		pWindow = SDL_CreateWindow( "TextureSamplingBenchmark", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+			g_WindowWidth, g_WindowHeight, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN );
+		pContext = pWindow != nullptr ? SDL_GL_CreateContext( pWindow ) : nullptr;
+		if ( pContext == nullptr )
+		{
+			std::cerr << "SDL_CreateWindow or SDL_GL_CreateContext: " << SDL_GetError( ) << '\n';
+			return false;
+		}
+		SDL_GL_SetSwapInterval( 0 );
+
+		dae::StartRenderBackend( RenderBackend::fixedFunction, float( g_WindowWidth ), float( g_WindowHeight ) );
+		glMatrixMode( GL_PROJECTION );
+		glLoadIdentity( );
+		gluOrtho2D( 0, g_WindowWidth, 0, g_WindowHeight );
+		glMatrixMode( GL_MODELVIEW );
+		glLoadIdentity( );
+		glViewport( 0, 0, g_WindowWidth, g_WindowHeight );
+		dae::SetGlCapability( GL_BLEND, true );
+		dae::SetGlBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+		return true;
+	}
+
+	void DrawFrame( const Texture& texture, float spriteSize )
+	{
+		glClear( GL_COLOR_BUFFER_BIT );
+		for ( int idx{ 0 }; idx < g_NrSprites; ++idx )
+		{
+			texture.Draw( Rectf{ float( idx * 37 % 1200 ), float( idx * 91 % 720 ), spriteSize, spriteSize } );
+		}
+		dae::FlushRenderBackend( );
+		glFinish( );
+	}
+}
+
+int main( int argc, char *argv[] )
+{
+	if ( argc < 2 )
+	{
+		std::cerr << "Usage: TextureSamplingBenchmark <image>\n";
+		return 1;
+	}
+	const std::string imagePath{ argv[1] };
+	SDL_Window* pWindow{ };
+	SDL_GLContext pContext{ };
+	if ( !CreateContext( pWindow, pContext ) )
+	{
+		return 1;
+	}
+	std::cout << glGetString( GL_RENDERER ) << ", " << glGetString( GL_VERSION ) << '\n'
+		<< "S3TC " << ( Texture::IsCompressionSupported( TextureCompression::s3tc ) ? "supported" : "not supported" )
+		<< ", RGTC " << ( Texture::IsCompressionSupported( TextureCompression::rgtc ) ? "supported" : "not supported" ) << '\n';
+
+	const Variant variants[]{
+		Variant{ "linear       ", TextureOptions{ } },
+		Variant{ "mip trilinear", TextureOptions{ true } },
+		Variant{ "mip + s3tc   ", TextureOptions{ true, TextureCompression::s3tc } },
+		Variant{ "rgtc         ", TextureOptions{ false, TextureCompression::rgtc } } };
+	bool isOk{ true };
+	std::cout << std::fixed << std::setprecision( 2 );
+	for ( int spriteSize : { 64, 16 } )
+	{
+		std::cout << g_NrSprites << " sprites of " << spriteSize << "x" << spriteSize << " from " << imagePath << ", ms per frame\n";
+		for ( const Variant& variant : variants )
+		{
+			double frameMs{ };
+			size_t videoBytes{ };
+			{
+				const Texture texture{ imagePath, variant.options };
+				if ( !dae::Check( texture.IsCreationOk( ), "texture creation" ) )
+				{
+					return 1;
+				}
+				// The first frame uploads and generates the mipmaps
+				DrawFrame( texture, float( spriteSize ) );
+				frameMs = dae::MeasureMs( [&texture, spriteSize] { DrawFrame( texture, float( spriteSize ) ); }, g_NrFrames );
+				videoBytes = texture.GetVideoMemorySize( );
+				isOk = dae::Check( dae::GetTextureMemoryStats( ).videoBytes == videoBytes, "video memory of the texture" ) && isOk;
+			}
+			isOk = dae::Check( dae::GetTextureMemoryStats( ).videoBytes == 0, "video memory after deleting the texture" ) && isOk;
+			std::cout << "  " << variant.pName << std::setw( 9 ) << frameMs << " ms  " << std::setw( 6 ) << videoBytes / 1024 << " KB\n";
+		}
+	}
+
+	dae::StopRenderBackend( );
+	SDL_GL_DeleteContext( pContext );
+	SDL_DestroyWindow( pWindow );
+	SDL_Quit( );
+	return isOk ? 0 : 1;
+}
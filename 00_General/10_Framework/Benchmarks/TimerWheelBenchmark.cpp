@@ -0,0 +1,111 @@
+// 100k pending timers in a TimerWheel against the same timers as cooldown fields of game objects,
+// counted down in every Update.
+// Sources: Benchmarks/TimerWheelBenchmark.cpp, TimerWheel.cpp
+#include "../stdafx.h"
+#include "../TimerWheel.h"
+#include "../Random.h"
+#include "Benchmark.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+namespace
+{
+	const int g_NrTimers{ 100000 };
+	const int g_NrFrames{ 600 };
+	const float g_FrameSec{ 1.0f / 60.0f };
+	const float g_MinDelaySec{ 0.1f };
+
+	// A game object of 64 bytes with a cooldown, the way Update counts it down without timers
+	struct Enemy
+	{
+		float cooldownSec;
+		float otherData[15];
+	};
+
+	// Fires and schedules itself again, so the number of pending timers stays the same
+	struct Spawner
+	{
+		TimerWheel* pWheel;
+		Random* pRandom;
+		float maxDelaySec;
+		int nrFired;
+
+		void Schedule( )
+		{
+			pWheel->Schedule( pRandom->GetFloat( g_MinDelaySec, maxDelaySec ), [this] { Fire( ); } );
+		}
+		void Fire( )
+		{
+			++nrFired;
+			Schedule( );
+		}
+	};
+
+	bool Run( float maxDelaySec )
+	{
+		bool isOk{ true };
+		TimerWheel wheel{ };
+		Random wheelRandom{ 1 };
+		Spawner spawner{ &wheel, &wheelRandom, maxDelaySec, 0 };
+		const double scheduleMs{ dae::MeasureMs( [&spawner]
+		{
+			for ( int idx{ 0 }; idx < g_NrTimers; ++idx )
+			{
+				spawner.Schedule( );
+			}
+		} ) };
+		const double wheelMs{ dae::MeasureMs( [&wheel] { wheel.Advance( g_FrameSec ); }, g_NrFrames ) };
+		isOk = dae::Check( wheel.GetNrPending( ) == g_NrTimers, "pending timers" ) && isOk;
+
+		std::vector<Enemy> enemies( g_NrTimers );
+		Random pollRandom{ 1 };
+		for ( Enemy& enemy : enemies )
+		{
+			enemy.cooldownSec = pollRandom.GetFloat( g_MinDelaySec, maxDelaySec );
+		}
+		int nrPollFired{ 0 };
+		const double pollMs{ dae::MeasureMs( [&]
+		{
+			for ( Enemy& enemy : enemies )
+			{
+				enemy.cooldownSec -= g_FrameSec;
+				if ( enemy.cooldownSec <= 0.0f )
+				{
+					++nrPollFired;
+					enemy.cooldownSec = pollRandom.GetFloat( g_MinDelaySec, maxDelaySec );
+				}
+			}
+		}, g_NrFrames ) };
+
+		std::vector<TimerHandle> handles( g_NrTimers );
+		for ( TimerHandle& handle : handles )
+		{
+			handle = wheel.Schedule( wheelRandom.GetFloat( g_MinDelaySec, maxDelaySec ), [] { } );
+		}
+		const double cancelMs{ dae::MeasureMs( [&]
+		{
+			for ( const TimerHandle& handle : handles )
+			{
+				wheel.Cancel( handle );
+			}
+		} ) };
+		isOk = dae::Check( wheel.GetNrPending( ) == g_NrTimers, "pending timers after cancelling" ) && isOk;
+
+		std::cout << "  delays " << g_MinDelaySec << "-" << maxDelaySec << " s: wheel " << wheelMs << " ms/frame (" << spawner.nrFired
+			<< " fired), polling " << pollMs << " ms/frame (" << nrPollFired << " fired), schedule " << scheduleMs * 1e6 / g_NrTimers
+			<< " ns, cancel " << cancelMs * 1e6 / g_NrTimers << " ns\n";
+		return isOk;
+	}
+}
+
+int main( int argc, char *argv[] )
+{
+	std::cout << std::fixed << std::setprecision( 3 ) << "TimerWheel, " << g_NrTimers << " pending timers, " << g_NrFrames << " frames at 60 Hz\n";
+	bool isOk{ true };
+	for ( float maxDelaySec : { 10.0f, 60.0f } )
+	{
+		isOk = Run( maxDelaySec ) && isOk;
+	}
+	return isOk ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+// 1M balls as a std::vector<Ball> and as World entities: creation, the Ball::Update work per frame,
+// and a query that only reads the position and velocity.
+// Sources: Benchmarks/WorldBenchmark.cpp, World.cpp, Ball.cpp, utils.cpp, SceneFile.cpp, RenderBackend.cpp,
+// RenderQueue.cpp, RenderStats.cpp, GlState.cpp, structs.cpp, Vector2f.cpp
+#include "../stdafx.h"
+#include "../World.h"
+#include "../Ball.h"
+#include "../utils.h"
+#include "../Random.h"
+#include "Benchmark.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+namespace
+{
+	struct Radius
+	{
+		float value;
+	};
+
+	const int g_NrBalls{ 1000000 };
+	const int g_NrFrames{ 20 };
+	const float g_FrameSec{ 1.0f / 60.0f };
+	const Rectf g_Bounds{ 0.0f, 0.0f, 1280.0f, 720.0f };
+
+	Point2f GetStartPosition( int idx )
+	{
+		return Point2f{ float( idx % 1280 ), float( idx % 720 ) };
+	}
+
+	Vector2f GetStartVelocity( int idx )
+	{
+		return Vector2f{ 100.0f + idx % 50, 80.0f - idx % 30 };
+	}
+
+	// Ball::Update as a system
+	void UpdateBall( Point2f& position, Vector2f& velocity, Color4f& color, const Radius& radius )
+	{
+		Circlef circle{ position, radius.value };
+		bool isHit{ dae::ResolveSweptCircle( circle, velocity, g_FrameSec, nullptr, 0 ) };
+		position = circle.center;
+		if ( position.x + radius.value > g_Bounds.left + g_Bounds.width && velocity.x > 0 )
+		{
+			velocity.x *= -1;
+			isHit = true;
+		}
+		if ( position.y + radius.value > g_Bounds.bottom + g_Bounds.height && velocity.y > 0 )
+		{
+			velocity.y *= -1;
+			isHit = true;
+		}
+		if ( position.x - radius.value < g_Bounds.left && velocity.x < 0 )
+		{
+			velocity.x *= -1;
+			isHit = true;
+		}
+		if ( position.y - radius.value < g_Bounds.bottom && velocity.y < 0 )
+		{
+			velocity.y *= -1;
+			isHit = true;
+		}
+		if ( isHit )
+		{
+			Random& random{ dae::GetRandom( ) };
+			color = Color4f{ random.GetInt( 0, 255 ) / 255.0f, random.GetInt( 0, 255 ) / 255.0f, random.GetInt( 0, 255 ) / 255.0f, 1.0f };
+		}
+	}
+}
+
+int main( int argc, char *argv[] )
+{
+	dae::SeedRandom( 1 );
+	bool isOk{ true };
+
+	std::vector<Ball> balls{ };
+	balls.reserve( g_NrBalls );
+	const double ballCreateMs{ dae::MeasureMs( [&balls]
+	{
+		for ( int idx{ 0 }; idx < g_NrBalls; ++idx )
+		{
+			balls.emplace_back( GetStartPosition( idx ), GetStartVelocity( idx ), Color4f{ 1.0f, 1.0f, 1.0f, 1.0f }, 5.0f );
+		}
+	} ) };
+	World world{ };
+	const double worldCreateMs{ dae::MeasureMs( [&world]
+	{
+		for ( int idx{ 0 }; idx < g_NrBalls; ++idx )
+		{
+			world.Create( GetStartPosition( idx ), GetStartVelocity( idx ), Color4f{ 1.0f, 1.0f, 1.0f, 1.0f }, Radius{ 5.0f } );
+		}
+	} ) };
+	isOk = dae::Check( world.GetNrEntities( ) == g_NrBalls, "number of entities" ) && isOk;
+
+	const double ballUpdateMs{ dae::MeasureMs( [&balls]
+	{
+		for ( Ball& ball : balls )
+		{
+			ball.Update( g_FrameSec, g_Bounds );
+		}
+	}, g_NrFrames ) };
+	int nrVisited{ 0 };
+	const double worldUpdateMs{ dae::MeasureMs( [&world, &nrVisited]
+	{
+		world.ForEach<Point2f, Vector2f, Color4f, Radius>( [&nrVisited]( Entity entity, Point2f& position, Vector2f& velocity, Color4f& color, Radius& radius )
+		{
+			UpdateBall( position, velocity, color, radius );
+			++nrVisited;
+		} );
+	}, g_NrFrames ) };
+	isOk = dae::Check( nrVisited == g_NrBalls * g_NrFrames, "entities visited by ForEach" ) && isOk;
+	const double parallelUpdateMs{ dae::MeasureMs( [&world]
+	{
+		world.ParallelForEach<Point2f, Vector2f, Color4f, Radius>( []( CommandBuffer& commands, Entity entity, Point2f& position, Vector2f& velocity, Color4f& color, Radius& radius )
+		{
+			UpdateBall( position, velocity, color, radius );
+		} );
+	}, g_NrFrames ) };
+
+	// The bounced balls stay within one frame of movement of the bounds
+	int nrOutside{ 0 };
+	world.ForEach<Point2f>( [&nrOutside]( Entity entity, Point2f& position )
+	{
+		if ( position.x < g_Bounds.left - 10.0f || position.x > g_Bounds.left + g_Bounds.width + 10.0f
+			|| position.y < g_Bounds.bottom - 10.0f || position.y > g_Bounds.bottom + g_Bounds.height + 10.0f )
+		{
+			++nrOutside;
+		}
+	} );
+	isOk = dae::Check( nrOutside == 0, "balls outside the bounds" ) && isOk;
+
+	const double moveMs{ dae::MeasureMs( [&world]
+	{
+		world.ForEach<Point2f, Vector2f>( []( Entity entity, Point2f& position, Vector2f& velocity )
+		{
+			position.x += velocity.x * g_FrameSec;
+			position.y += velocity.y * g_FrameSec;
+		} );
+	}, g_NrFrames ) };
+
+	std::cout << std::fixed << std::setprecision( 2 ) << "World vs std::vector<Ball>, " << g_NrBalls << " balls, " << g_NrFrames << " frames\n"
+		<< "  create:               Ball " << ballCreateMs << " ms, World " << worldCreateMs << " ms\n"
+		<< "  update:               Ball " << ballUpdateMs << " ms/frame, World " << worldUpdateMs << " ms/frame, World parallel "
+		<< parallelUpdateMs << " ms/frame (" << std::thread::hardware_concurrency( ) << " threads)\n"
+		<< "  position += velocity: World " << moveMs << " ms/frame\n";
+	return isOk ? 0 : 1;
+}
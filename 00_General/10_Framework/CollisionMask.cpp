@@ -0,0 +1,268 @@
+#include "stdafx.h"
+#include "CollisionMask.h"
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+
+#if defined( _M_X64 ) || defined( _M_IX86 ) || defined( __x86_64__ ) || defined( __i386__ )
+#define DAE_X86
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	// The 64 bits of a row that start at pixel x, zeros outside the row
+	Uint64 ReadBits( const Uint64* pRow, int nrWords, int x )
+	{
+		const int word{ x >> 6 };
+		const int shift{ x & 63 };
+		const Uint64 low{ word >= 0 && word < nrWords ? pRow[word] : 0 };
+		const Uint64 high{ word + 1 >= 0 && word + 1 < nrWords ? pRow[word + 1] : 0 };
+		return shift == 0 ? low : low >> shift | high << ( 64 - shift );
+	}
+
+	// A width or height of 0 draws the texture at its own size, see Texture::Draw
+	Rectf GetDrawnRect( const CollisionMask& mask, const Rectf& rect )
+	{
+		if ( rect.width > 0.0f && rect.height > 0.0f )
+		{
+			return rect;
+		}
+		return Rectf{ rect.left, rect.bottom, float( mask.GetWidth( ) ), float( mask.GetHeight( ) ) };
+	}
+}
+
+CollisionMask::CollisionMask( )
+	:m_Width{ 0 }
+	,m_Height{ 0 }
+	,m_Stride{ 0 }
+	,m_Words{ }
+{
+}
+
+CollisionMask::CollisionMask( const Uint8* pRgba, int width, int height, Uint8 alphaThreshold )
+	:CollisionMask{ }
+{
+	Resize( width, height );
+	for ( int y{ 0 }; y < height; ++y )
+	{
+		// Bottom row first
+		const Uint8* pAlpha{ pRgba + ( size_t( height - 1 - y ) * width ) * 4 + 3 };
+		Uint64* pRow{ GetRow( y ) };
+		for ( int x{ 0 }; x < width; x += 64 )
+		{
+			Uint64 word{ 0 };
+			const int nrBits{ std::min( width - x, 64 ) };
+			for ( int bit{ 0 }; bit < nrBits; ++bit )
+			{
+				word |= Uint64( pAlpha[( x + bit ) * 4] >= alphaThreshold ) << bit;
+			}
+			pRow[x >> 6] = word;
+		}
+	}
+}
+
+CollisionMask::CollisionMask( const CollisionMask& sheet, const Rectf& srcRect )
+	:CollisionMask{ }
+{
+	if ( !( srcRect.width > 0.0f && srcRect.height > 0.0f ) )
+	{
+		*this = sheet;
+		return;
+	}
+
+	// srcRect.bottom is the top of the frame, counted from the top of the image
+	const int left{ int( std::lround( srcRect.left ) ) };
+	const int top{ int( std::lround( srcRect.bottom ) ) };
+	Resize( int( std::lround( srcRect.width ) ), int( std::lround( srcRect.height ) ) );
+	const int nrSheetWords{ sheet.m_Stride - 3 };
+	const int nrWords{ m_Stride - 3 };
+	for ( int y{ 0 }; y < m_Height; ++y )
+	{
+		const int sheetY{ sheet.m_Height - top - m_Height + y };
+		if ( sheetY < 0 || sheetY >= sheet.m_Height )
+		{
+			continue;
+		}
+		const Uint64* pSheetRow{ sheet.GetRow( sheetY ) };
+		Uint64* pRow{ GetRow( y ) };
+		for ( int word{ 0 }; word < nrWords; ++word )
+		{
+			pRow[word] = ReadBits( pSheetRow, nrSheetWords, left + word * 64 );
+		}
+		// Nothing beyond the width, the overlap test relies on it
+		if ( m_Width % 64 != 0 )
+		{
+			pRow[nrWords - 1] &= ( Uint64( 1 ) << ( m_Width % 64 ) ) - 1;
+		}
+	}
+}
+
+int CollisionMask::GetWidth( ) const
+{
+	return m_Width;
+}
+
+int CollisionMask::GetHeight( ) const
+{
+	return m_Height;
+}
+
+bool CollisionMask::IsEmpty( ) const
+{
+	return m_Width == 0 || m_Height == 0;
+}
+
+bool CollisionMask::IsSet( int x, int y ) const
+{
+	if ( x < 0 || x >= m_Width || y < 0 || y >= m_Height )
+	{
+		return false;
+	}
+	return ( GetRow( y )[x >> 6] >> ( x & 63 ) & 1 ) != 0;
+}
+
+int CollisionMask::GetNrSetPixels( ) const
+{
+	size_t nrSet{ 0 };
+	for ( Uint64 word : m_Words )
+	{
+		nrSet += std::bitset<64>{ word }.count( );
+	}
+	return int( nrSet );
+}
+
+bool CollisionMask::IsOverlapping( const CollisionMask& first, const Rectf& firstRect, const CollisionMask& second, const Rectf& secondRect )
+{
+	if ( first.IsEmpty( ) || second.IsEmpty( ) )
+	{
+		return false;
+	}
+	const Rectf firstDrawn{ GetDrawnRect( first, firstRect ) };
+	const Rectf secondDrawn{ GetDrawnRect( second, secondRect ) };
+	if ( firstDrawn.left >= secondDrawn.left + secondDrawn.width || secondDrawn.left >= firstDrawn.left + firstDrawn.width
+		|| firstDrawn.bottom >= secondDrawn.bottom + secondDrawn.height || secondDrawn.bottom >= firstDrawn.bottom + firstDrawn.height )
+	{
+		return false;
+	}
+
+	// Pixels of the same size: the offset between the masks is a whole number of pixels
+	const float scaleX{ firstDrawn.width / first.m_Width };
+	const float scaleY{ firstDrawn.height / first.m_Height };
+	const float tolerance{ 0.001f };
+	if ( std::abs( secondDrawn.width / second.m_Width - scaleX ) > tolerance * scaleX
+		|| std::abs( secondDrawn.height / second.m_Height - scaleY ) > tolerance * scaleY )
+	{
+		return IsOverlappingSampled( first, firstDrawn, second, secondDrawn );
+	}
+	const int offsetX{ int( std::lround( ( secondDrawn.left - firstDrawn.left ) / scaleX ) ) };
+	const int offsetY{ int( std::lround( ( secondDrawn.bottom - firstDrawn.bottom ) / scaleY ) ) };
+	return IsOverlapping( first, second, offsetX, offsetY );
+}
+
+bool CollisionMask::IsOverlapping( const CollisionMask& first, const CollisionMask& second, int offsetX, int offsetY )
+{
+	// The overlap in first's pixels
+	const int left{ std::max( 0, offsetX ) };
+	const int right{ std::min( first.m_Width, offsetX + second.m_Width ) };
+	const int bottom{ std::max( 0, offsetY ) };
+	const int top{ std::min( first.m_Height, offsetY + second.m_Height ) };
+	if ( left >= right || bottom >= top )
+	{
+		return false;
+	}
+
+	// Word i of first lines up with the 64 bits of second that start at pixel i * 64 - offsetX: the words
+	// secondWord = i + wordOffset and the next one, shifted by shift. Words of first that stick out of the overlap
+	// meet second's zero padding or first's zero bits beyond its width, so they need no masking
+	const int firstWord{ left >> 6 };
+	const int lastWord{ ( right - 1 ) >> 6 };
+	const int wordOffset{ ( ( firstWord * 64 - offsetX ) >> 6 ) - firstWord };
+	const int shift{ ( firstWord * 64 - offsetX ) & 63 };
+	for ( int y{ bottom }; y < top; ++y )
+	{
+		const Uint64* pFirst{ first.GetRow( y ) };
+		const Uint64* pSecond{ second.GetRow( y - offsetY ) + wordOffset };
+#ifdef DAE_X86
+		// Two words at a time, the second one may be first's padding. Shifting by 64 gives 0
+		const __m128i shiftRight{ _mm_cvtsi32_si128( shift ) };
+		const __m128i shiftLeft{ _mm_cvtsi32_si128( 64 - shift ) };
+		const __m128i zero{ _mm_setzero_si128( ) };
+		for ( int word{ firstWord }; word <= lastWord; word += 2 )
+		{
+			const __m128i firstBits{ _mm_loadu_si128( reinterpret_cast<const __m128i*>( pFirst + word ) ) };
+			const __m128i low{ _mm_loadu_si128( reinterpret_cast<const __m128i*>( pSecond + word ) ) };
+			const __m128i high{ _mm_loadu_si128( reinterpret_cast<const __m128i*>( pSecond + word + 1 ) ) };
+			const __m128i secondBits{ _mm_or_si128( _mm_srl_epi64( low, shiftRight ), _mm_sll_epi64( high, shiftLeft ) ) };
+			if ( _mm_movemask_epi8( _mm_cmpeq_epi8( _mm_and_si128( firstBits, secondBits ), zero ) ) != 0xffff )
+			{
+				return true;
+			}
+		}
+#else
+		for ( int word{ firstWord }; word <= lastWord; ++word )
+		{
+			const Uint64 secondBits{ shift == 0 ? pSecond[word] : pSecond[word] >> shift | pSecond[word + 1] << ( 64 - shift ) };
+			if ( ( pFirst[word] & secondBits ) != 0 )
+			{
+				return true;
+			}
+		}
+#endif
+	}
+	return false;
+}
+
+void CollisionMask::Resize( int width, int height )
+{
+	m_Width = std::max( width, 0 );
+	m_Height = std::max( height, 0 );
+	m_Stride = ( m_Width + 63 ) / 64 + 3;
+	m_Words.assign( size_t( m_Stride ) * m_Height, 0 );
+}
+
+Uint64* CollisionMask::GetRow( int y )
+{
+	return m_Words.data( ) + size_t( y ) * m_Stride + 1;
+}
+
+const Uint64* CollisionMask::GetRow( int y ) const
+{
+	return m_Words.data( ) + size_t( y ) * m_Stride + 1;
+}
+
+bool CollisionMask::IsOverlappingSampled( const CollisionMask& first, const Rectf& firstRect, const CollisionMask& second, const Rectf& secondRect )
+{
+	const float firstPixelWidth{ firstRect.width / first.m_Width };
+	const float firstPixelHeight{ firstRect.height / first.m_Height };
+	const float secondPixelWidth{ secondRect.width / second.m_Width };
+	const float secondPixelHeight{ secondRect.height / second.m_Height };
+	const float left{ std::max( firstRect.left, secondRect.left ) };
+	const float right{ std::min( firstRect.left + firstRect.width, secondRect.left + secondRect.width ) };
+	const float bottom{ std::max( firstRect.bottom, secondRect.bottom ) };
+	const float top{ std::min( firstRect.bottom + firstRect.height, secondRect.bottom + secondRect.height ) };
+
+	// The center of each pixel of first in the overlap, looked up in second
+	const int fromX{ std::max( int( ( left - firstRect.left ) / firstPixelWidth ), 0 ) };
+	const int toX{ std::min( int( std::ceil( ( right - firstRect.left ) / firstPixelWidth ) ), first.m_Width ) };
+	const int fromY{ std::max( int( ( bottom - firstRect.bottom ) / firstPixelHeight ), 0 ) };
+	const int toY{ std::min( int( std::ceil( ( top - firstRect.bottom ) / firstPixelHeight ) ), first.m_Height ) };
+	for ( int y{ fromY }; y < toY; ++y )
+	{
+		const float centerY{ firstRect.bottom + ( y + 0.5f ) * firstPixelHeight };
+		const int secondY{ int( std::floor( ( centerY - secondRect.bottom ) / secondPixelHeight ) ) };
+		for ( int x{ fromX }; x < toX; ++x )
+		{
+			if ( !first.IsSet( x, y ) )
+			{
+				continue;
+			}
+			const float centerX{ firstRect.left + ( x + 0.5f ) * firstPixelWidth };
+			if ( second.IsSet( int( std::floor( ( centerX - secondRect.left ) / secondPixelWidth ) ), secondY ) )
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
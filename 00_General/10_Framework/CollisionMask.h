@@ -0,0 +1,50 @@
+#pragma once
+#include <vector>
+
+// One bit per pixel: set where the alpha of the image is at least a threshold. Exact collision between sprites:
+//		Texture knight{ "DAE_Sprites_Knight.png", TextureOptions{ false, TextureCompression::none, false, true } };
+//		CollisionMask knightFrame{ knight.GetCollisionMask( ), srcRect };		// the same srcRect as Draw
+//		...
+//		if ( CollisionMask::IsOverlapping( knightFrame, knightDestRect, enemyFrame, enemyDestRect ) )
+//
+// The rows are 64 bit words, bottom row first like the window's y axis. The test first compares the rects,
+// then ANDs the rows where they overlap, 128 bits at a time with SSE2, the rows of one mask shifted to line up
+// with the words of the other. Two 32x32 sprites test one word per row, 32 rows at most.
+class CollisionMask
+{
+public:
+	// Empty: overlaps nothing
+	CollisionMask( );
+	// RGBA8 pixels, top row first as in SDL surfaces and textures
+	CollisionMask( const Uint8* pRgba, int width, int height, Uint8 alphaThreshold = 128 );
+	// A frame of a sprite sheet: srcRect as in Texture::Draw, in pixels of the sheet
+	CollisionMask( const CollisionMask& sheet, const Rectf& srcRect );
+
+	int GetWidth( ) const;
+	int GetHeight( ) const;
+	bool IsEmpty( ) const;
+	// x from the left, y from the bottom
+	bool IsSet( int x, int y ) const;
+	int GetNrSetPixels( ) const;
+
+	// The masks drawn with Texture::Draw at these destination rects. Exact when both are drawn at the same scale,
+	// otherwise each pixel of the first mask in the overlap is looked up in the second one
+	static bool IsOverlapping( const CollisionMask& first, const Rectf& firstRect, const CollisionMask& second, const Rectf& secondRect );
+	// In mask pixels: second's bottom left is offsetX, offsetY from first's bottom left
+	static bool IsOverlapping( const CollisionMask& first, const CollisionMask& second, int offsetX, int offsetY );
+
+private:
+	// DATA MEMBERS
+	int m_Width;
+	int m_Height;
+	// Words per row: one zero word on the left, the pixels, two zero words on the right,
+	// so shifted reads of a neighbouring word never need a bounds check
+	int m_Stride;
+	std::vector<Uint64> m_Words;
+
+	// FUNCTIONS
+	void Resize( int width, int height );
+	Uint64* GetRow( int y );
+	const Uint64* GetRow( int y ) const;
+	static bool IsOverlappingSampled( const CollisionMask& first, const Rectf& firstRect, const CollisionMask& second, const Rectf& secondRect );
+};
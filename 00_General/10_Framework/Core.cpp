@@ -0,0 +1,587 @@
+#include "stdafx.h"
+#include "Core.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include "Game.h"
+#include "PerformanceHud.h"
+#include "RenderStats.h"
+#include "RenderStatsWriter.h"
+#include "ResourcePreload.h"
+#include "HotReload.h"
+#include "TextureBudget.h"
+#include "LatencyMonitor.h"
+#include "FramePacer.h"
+#include "TripleBuffer.h"
+#include "RenderBackend.h"
+#include "RenderQueue.h"
+#include "GlState.h"
+
+Core::Core( const Window& window )
+	:m_Window{window}
+	,m_Initialized{false}
+	,m_Tasks{ m_Timers }
+{
+	Initialize( );
+}
+
+Core::~Core( )
+{
+	Cleanup( );
+}
+
+void Core::Initialize( )
+{
+	// Initialize SDL
+	if ( SDL_Init( SDL_INIT_VIDEO ) < 0 )
+	{
+		std::cerr << "Core::Initialize( ), error when calling SDL_Init: " << SDL_GetError( ) << std::endl;
+		return;
+	}
+	m_StartupProfile.AddStep( "SDL_Init" );
+
+	// Decode the queued images and fonts while the window and context are created
+	dae::StartPreloading( );
+
+	// Use OpenGL 2.1, or a 3.3 core profile for the shader backend: DAE_RENDERER=gl33, see RenderBackend.h
+	const char* pRenderer{ SDL_getenv( "DAE_RENDERER" ) };
+	RenderBackend backend{ pRenderer != nullptr && std::string{ pRenderer } == "gl33" ? RenderBackend::shaders : RenderBackend::fixedFunction };
+	if ( backend == RenderBackend::shaders )
+	{
+		SDL_GL_SetAttribute( SDL_GL_CONTEXT_MAJOR_VERSION, 3 );
+		SDL_GL_SetAttribute( SDL_GL_CONTEXT_MINOR_VERSION, 3 );
+		SDL_GL_SetAttribute( SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE );
+	}
+	else
+	{
+		SDL_GL_SetAttribute( SDL_GL_CONTEXT_MAJOR_VERSION, 2 );
+		SDL_GL_SetAttribute( SDL_GL_CONTEXT_MINOR_VERSION, 1 );
+	}
+
+	// Create window
+	m_pWindow = SDL_CreateWindow(
+		m_Window.title.c_str( ),
+		SDL_WINDOWPOS_CENTERED,
+		SDL_WINDOWPOS_CENTERED,
+		int( m_Window.width ),
+		int( m_Window.height ),
+		SDL_WINDOW_OPENGL );
+	if ( m_pWindow == nullptr )
+	{
+		std::cerr << "Core::Initialize( ), error when calling SDL_CreateWindow: " << SDL_GetError( ) << std::endl;
+		return;
+	}
+	m_StartupProfile.AddStep( "window" );
+
+	// Create OpenGL context 
+	m_pContext = SDL_GL_CreateContext( m_pWindow );
+	if ( backend == RenderBackend::shaders && ( m_pContext == nullptr || !dae::StartRenderBackend( backend, m_Window.width, m_Window.height ) ) )
+	{
+		std::cerr << "Core::Initialize( ), no OpenGL 3.3 core profile for the shader backend, using the fixed function pipeline\n";
+		if ( m_pContext != nullptr )
+		{
+			SDL_GL_DeleteContext( m_pContext );
+		}
+		backend = RenderBackend::fixedFunction;
+		SDL_GL_SetAttribute( SDL_GL_CONTEXT_MAJOR_VERSION, 2 );
+		SDL_GL_SetAttribute( SDL_GL_CONTEXT_MINOR_VERSION, 1 );
+		SDL_GL_SetAttribute( SDL_GL_CONTEXT_PROFILE_MASK, 0 );
+		m_pContext = SDL_GL_CreateContext( m_pWindow );
+	}
+	if ( m_pContext == nullptr )
+	{
+		std::cerr << "Core::Initialize( ), error when calling SDL_GL_CreateContext: " << SDL_GetError( ) << std::endl;
+		return;
+	}
+	m_StartupProfile.AddStep( "GL context" );
+
+	// Set the swap interval for the current OpenGL context,
+	// synchronize it with the vertical retrace
+	if ( m_Window.isVSyncOn )
+	{
+		if ( SDL_GL_SetSwapInterval( 1 ) < 0 )
+		{
+			std::cerr << "Core::Initialize( ), error when calling SDL_GL_SetSwapInterval: " << SDL_GetError( ) << std::endl;
+			return;
+		}
+	}
+	
+	if ( backend == RenderBackend::fixedFunction )
+	{
+		dae::StartRenderBackend( backend, m_Window.width, m_Window.height );
+
+		// Set the Projection matrix to the identity matrix
+		glMatrixMode( GL_PROJECTION ); 
+		glLoadIdentity( );
+
+		// Set up a two-dimensional orthographic viewing region.
+		gluOrtho2D( 0, m_Window.width, 0, m_Window.height ); // y from bottom to top
+
+		// Set the Modelview matrix to the identity matrix
+		glMatrixMode( GL_MODELVIEW );
+		glLoadIdentity( );
+	}
+	// The shader backend has the same projection in its vertex shader
+
+	// Set the viewport to the client window area
+	// The viewport is the rectangular region of the window where the image is drawn.
+	glViewport( 0, 0, int( m_Window.width ), int( m_Window.height ) );
+
+	// Enable color blending and use alpha blending
+	dae::SetGlCapability( GL_BLEND, true );
+	dae::SetGlBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+
+	// The low latency mode needs the frame interval of the display
+	m_pPacer = new FramePacer{ m_Window.maxFps, m_Window.isLowLatencyOn };
+	SDL_DisplayMode displayMode{ };
+	if ( SDL_GetCurrentDisplayMode( SDL_GetWindowDisplayIndex( m_pWindow ), &displayMode ) == 0 )
+	{
+		m_pPacer->SetRefreshRate( float( displayMode.refresh_rate ) );
+	}
+
+	m_StartupProfile.AddStep( "vsync and GL state" );
+
+	// SDL_image and SDL_ttf are initialized on first use, see ResourcePreload.h
+
+	m_pHud = new PerformanceHud{ m_Window };
+
+	// Optional statistics file and run length, e.g. DAE_RENDER_STATS=stats.csv DAE_MAX_FRAMES=3600
+	const char* pStatsPath{ SDL_getenv( "DAE_RENDER_STATS" ) };
+	if ( pStatsPath != nullptr && pStatsPath[0] != '\0' )
+	{
+		m_pStatsWriter = new RenderStatsWriter{ pStatsPath };
+	}
+	const char* pMaxFrames{ SDL_getenv( "DAE_MAX_FRAMES" ) };
+	if ( pMaxFrames != nullptr )
+	{
+		m_MaxFrames = std::atoi( pMaxFrames );
+	}
+	// DAE_LATENCY=1 measures until the swap returns, DAE_LATENCY=finish until glFinish after the swap returns
+	const char* pLatency{ SDL_getenv( "DAE_LATENCY" ) };
+	if ( pLatency != nullptr && pLatency[0] != '\0' && std::string{ pLatency } != "0" )
+	{
+		m_pLatency = new LatencyMonitor{ std::string{ pLatency } == "finish" };
+	}
+	// Video memory budget for the textures in MB, e.g. DAE_VRAM_BUDGET=256
+	const char* pVramBudget{ SDL_getenv( "DAE_VRAM_BUDGET" ) };
+	if ( pVramBudget != nullptr )
+	{
+		dae::SetTextureBudget( size_t( std::max( std::atoi( pVramBudget ), 0 ) ) * 1024 * 1024 );
+	}
+	// Reload changed images and fonts, DAE_HOT_RELOAD=1 watches the Resources folder, DAE_HOT_RELOAD=<folder> another one
+	const char* pHotReload{ SDL_getenv( "DAE_HOT_RELOAD" ) };
+	if ( pHotReload != nullptr && pHotReload[0] != '\0' && std::string{ pHotReload } != "0" )
+	{
+		dae::StartHotReload( std::string{ pHotReload } == "1" ? "Resources" : pHotReload );
+	}
+	// Sort the draws of Game::Draw by layer and texture, DAE_RENDER_QUEUE=1, see RenderQueue.h
+	const char* pRenderQueue{ SDL_getenv( "DAE_RENDER_QUEUE" ) };
+	dae::SetRenderQueueOn( pRenderQueue != nullptr && std::string{ pRenderQueue } == "1" );
+	m_StartupProfile.AddStep( "HUD and stats" );
+
+	m_Initialized = true;
+}
+
+void Core::Run( )
+{
+	if ( !m_Initialized )
+	{
+		std::cerr << "Core::Run( ), Core not correctly initialized, unable to run the game\n";
+		std::cin.get( );
+		return;
+	}
+
+	// Create the Game object
+	Game game{ m_Window, m_Timers, m_Tasks };
+	m_StartupProfile.AddStep( "Game" );
+
+	// Update on a separate thread, see Window::simulationRate
+	if ( m_Window.simulationRate > 0.0f )
+	{
+		RunThreaded( game );
+		m_Tasks.Clear( );
+		return;
+	}
+
+	// Main loop flag
+	bool quit{ false };
+
+	// Set start time
+	m_MilliSeconds = SDL_GetTicks( );
+
+	// High resolution time keeping for the performance overlay
+	const float msPerCount{ 1000.0f / SDL_GetPerformanceFrequency( ) };
+	Uint64 frameStart{ SDL_GetPerformanceCounter( ) };
+
+	//The event loop
+	SDL_Event e{};
+	while ( !quit )
+	{
+		// Wait for the frame rate cap or until the low latency mode's start time
+		m_pPacer->WaitForFrameStart( );
+		const Uint64 waitEnd{ SDL_GetPerformanceCounter( ) };
+
+		// Poll next event from queue
+		while ( SDL_PollEvent( &e ) != 0 )
+		{
+			if ( m_pLatency != nullptr )
+			{
+				m_pLatency->StampEvent( e );
+			}
+
+			// Handle the polled event
+			switch ( e.type )
+			{
+			case SDL_QUIT:
+				quit = true;
+				break;
+			case SDL_WINDOWEVENT:
+				ProcessWindowEvent( e.window );
+				break;
+			default:
+				ProcessHotKey( e );
+				ProcessInputEvent( game, e );
+				break;
+			}
+
+			if ( m_pLatency != nullptr )
+			{
+				m_pLatency->MarkHandled( );
+			}
+		}
+
+		if ( !quit )
+		{
+			// Calculate elapsed time
+			// Get the number of milliseconds since the SDL library initialization
+			// Note that this value wraps if the program runs for more than ~49 days.
+			Uint32 currentMilliSeconds = SDL_GetTicks( );
+
+			// Calculate elapsed time
+			Uint32 elapsedTime = currentMilliSeconds - m_MilliSeconds;
+
+			// Update current time
+			m_MilliSeconds = currentMilliSeconds;
+
+			// Prevent jumps in time caused by break points
+			const Uint32 maxElapsedTime{ 100 };
+			if ( elapsedTime > maxElapsedTime )
+			{
+				elapsedTime = maxElapsedTime;
+			}
+
+			// Call the Game object 's Update function, using time in seconds (!)
+			const Uint64 updateStart{ SDL_GetPerformanceCounter( ) };
+			dae::ApplyHotReloads( );
+			m_Timers.Advance( elapsedTime / 1000.0f );
+			m_Tasks.Update( );
+			game.Update( elapsedTime / 1000.0f );
+			if ( m_pLatency != nullptr )
+			{
+				m_pLatency->MarkUpdated( );
+			}
+
+			// Draw in the back buffer
+			const Uint64 drawStart{ SDL_GetPerformanceCounter( ) };
+			dae::ResetRenderStats( );
+			dae::BeginRenderQueue( );
+			game.Draw( );
+			dae::EndRenderQueue( );
+			// The last batch of the game counts too, the HUD's doesn't
+			dae::FlushRenderBackend( );
+			const RenderStats renderStats{ dae::GetRenderStats( ) };
+			m_pHud->Draw( );
+			dae::FlushRenderBackend( );
+			if ( m_pLatency != nullptr )
+			{
+				m_pLatency->MarkDrawn( );
+			}
+
+			// Update screen: swap back and front buffer
+			const Uint64 swapStart{ SDL_GetPerformanceCounter( ) };
+			SDL_GL_SwapWindow( m_pWindow );
+			if ( m_pLatency != nullptr )
+			{
+				// Wait until the GPU executed the swap, instead of only queueing it
+				if ( m_pLatency->IsFenced( ) )
+				{
+					glFinish( );
+				}
+				m_pLatency->MarkPresented( );
+			}
+			const Uint64 frameEnd{ SDL_GetPerformanceCounter( ) };
+			m_pPacer->EndFrame( ( swapStart - waitEnd ) * msPerCount );
+
+			FrameTimes times{ };
+			times.frame = ( frameEnd - frameStart ) * msPerCount;
+			times.wait = ( waitEnd - frameStart ) * msPerCount;
+			times.events = ( updateStart - waitEnd ) * msPerCount;
+			times.update = ( drawStart - updateStart ) * msPerCount;
+			times.draw = ( swapStart - drawStart ) * msPerCount;
+			times.swap = ( frameEnd - swapStart ) * msPerCount;
+			frameStart = frameEnd;
+			if ( EndFrame( times, renderStats ) )
+			{
+				quit = true;
+			}
+		}
+	}
+
+	// The tasks can refer to the game, stop them before it is destroyed
+	m_Tasks.Clear( );
+}
+
+void Core::RunThreaded( Game& game )
+{
+	if ( m_pLatency != nullptr )
+	{
+		std::cerr << "Core::RunThreaded( ), the latency measurement doesn't support the two-thread mode, it is turned off\n";
+		delete m_pLatency;
+		m_pLatency = nullptr;
+	}
+
+	// The simulation thread publishes snapshots, this thread draws the newest one.
+	// Input events are handed over through a queue, so the Process*Event functions
+	// run on the simulation thread, just like Update.
+	// The simulation thread holds simulationMutex during each step, this thread takes it to pause the simulation.
+	TripleBuffer<GameSnapshot> snapshots{ };
+	std::atomic<bool> quit{ false };
+	std::mutex eventMutex{ };
+	std::mutex simulationMutex{ };
+	std::vector<SDL_Event> events{ };
+
+	game.MakeSnapshot( snapshots.GetWriteBuffer( ) );
+	snapshots.Publish( );
+
+	const float msPerCount{ 1000.0f / SDL_GetPerformanceFrequency( ) };
+	std::thread simulation{ [&]
+	{
+		FramePacer pacer{ m_Window.simulationRate, false };
+		std::vector<SDL_Event> pendingEvents{ };
+		Uint64 lastUpdate{ SDL_GetPerformanceCounter( ) };
+		while ( !quit )
+		{
+			pacer.WaitForFrameStart( );
+			const Uint64 start{ SDL_GetPerformanceCounter( ) };
+			std::unique_lock<std::mutex> step{ simulationMutex };
+
+			{
+				std::lock_guard<std::mutex> lock{ eventMutex };
+				pendingEvents.swap( events );
+			}
+			for ( const SDL_Event& e : pendingEvents )
+			{
+				ProcessInputEvent( game, e );
+			}
+			pendingEvents.clear( );
+
+			// Prevent jumps in time caused by break points
+			const float elapsedSec{ std::min( ( start - lastUpdate ) * msPerCount / 1000.0f, 0.1f ) };
+			lastUpdate = start;
+			m_Timers.Advance( elapsedSec );
+			m_Tasks.Update( );
+			game.Update( elapsedSec );
+
+			game.MakeSnapshot( snapshots.GetWriteBuffer( ) );
+			snapshots.Publish( );
+			step.unlock( );
+			pacer.EndFrame( ( SDL_GetPerformanceCounter( ) - start ) * msPerCount );
+		}
+	} };
+
+	Uint64 frameStart{ SDL_GetPerformanceCounter( ) };
+	SDL_Event e{};
+	while ( !quit )
+	{
+		m_pPacer->WaitForFrameStart( );
+		const Uint64 waitEnd{ SDL_GetPerformanceCounter( ) };
+
+		while ( SDL_PollEvent( &e ) != 0 )
+		{
+			switch ( e.type )
+			{
+			case SDL_QUIT:
+				quit = true;
+				break;
+			case SDL_WINDOWEVENT:
+				ProcessWindowEvent( e.window );
+				break;
+			default:
+				ProcessHotKey( e );
+				{
+					std::lock_guard<std::mutex> lock{ eventMutex };
+					events.push_back( e );
+				}
+				break;
+			}
+		}
+
+		if ( !quit )
+		{
+			// Draw the newest snapshot, or the previous one again when none was published since
+			const Uint64 drawStart{ SDL_GetPerformanceCounter( ) };
+			snapshots.Update( );
+			if ( dae::HasHotReloads( ) )
+			{
+				// The reloads change the size and collision masks of the game's textures, which Update may be reading
+				std::lock_guard<std::mutex> lock{ simulationMutex };
+				dae::ApplyHotReloads( );
+			}
+			dae::ResetRenderStats( );
+			dae::BeginRenderQueue( );
+			game.Draw( snapshots.GetReadBuffer( ) );
+			dae::EndRenderQueue( );
+			// The last batch of the game counts too, the HUD's doesn't
+			dae::FlushRenderBackend( );
+			const RenderStats renderStats{ dae::GetRenderStats( ) };
+			m_pHud->Draw( );
+			dae::FlushRenderBackend( );
+
+			const Uint64 swapStart{ SDL_GetPerformanceCounter( ) };
+			SDL_GL_SwapWindow( m_pWindow );
+			const Uint64 frameEnd{ SDL_GetPerformanceCounter( ) };
+			m_pPacer->EndFrame( ( swapStart - waitEnd ) * msPerCount );
+
+			FrameTimes times{ };
+			times.frame = ( frameEnd - frameStart ) * msPerCount;
+			times.wait = ( waitEnd - frameStart ) * msPerCount;
+			times.events = ( drawStart - waitEnd ) * msPerCount;
+			times.draw = ( swapStart - drawStart ) * msPerCount;
+			times.swap = ( frameEnd - swapStart ) * msPerCount;
+			frameStart = frameEnd;
+			if ( EndFrame( times, renderStats ) )
+			{
+				quit = true;
+			}
+		}
+	}
+	simulation.join( );
+}
+
+bool Core::EndFrame( FrameTimes& times, const RenderStats& renderStats )
+{
+	if ( m_NrFrames == 0 )
+	{
+		ReportStartup( );
+	}
+
+	times.pacingError = m_pPacer->GetLastPacingError( );
+	m_pHud->SetCpuUsage( m_pPacer->GetCpuUsage( ) );
+	m_pHud->AddFrame( times, renderStats );
+	if ( m_pStatsWriter != nullptr )
+	{
+		m_pStatsWriter->Write( times, renderStats );
+	}
+
+	dae::NextTextureFrame( );
+	++m_NrFrames;
+	return m_MaxFrames > 0 && m_NrFrames >= m_MaxFrames;
+}
+
+void Core::ProcessHotKey( const SDL_Event& e )
+{
+	if ( e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F1 )
+	{
+		m_pHud->Toggle( );
+	}
+}
+
+void Core::ProcessInputEvent( Game& game, const SDL_Event& e )
+{
+	switch ( e.type )
+	{
+	case SDL_KEYDOWN:
+		game.ProcessKeyDownEvent( e.key );
+		break;
+	case SDL_KEYUP:
+		game.ProcessKeyUpEvent( e.key );
+		break;
+	case SDL_MOUSEMOTION:
+		game.ProcessMouseMotionEvent( e.motion );
+		break;
+	case SDL_MOUSEBUTTONDOWN:
+		game.ProcessMouseDownEvent( e.button );
+		break;
+	case SDL_MOUSEBUTTONUP:
+		game.ProcessMouseUpEvent( e.button );
+		break;
+	}
+}
+
+void Core::ProcessWindowEvent( const SDL_WindowEvent& e )
+{
+	switch ( e.event )
+	{
+	case SDL_WINDOWEVENT_MINIMIZED:
+		m_pPacer->SetMinimized( true );
+		break;
+	case SDL_WINDOWEVENT_SHOWN:
+	case SDL_WINDOWEVENT_RESTORED:
+	case SDL_WINDOWEVENT_MAXIMIZED:
+		m_pPacer->SetMinimized( false );
+		break;
+	case SDL_WINDOWEVENT_FOCUS_GAINED:
+		m_pPacer->SetFocused( true );
+		break;
+	case SDL_WINDOWEVENT_FOCUS_LOST:
+		m_pPacer->SetFocused( false );
+		break;
+	}
+}
+
+void Core::ReportStartup( )
+{
+	// DAE_STARTUP_STATS=1 prints the steps, a path also appends them to a time series for benchmarking,
+	// e.g. DAE_STARTUP_STATS=startup.csv
+	const char* pPath{ SDL_getenv( "DAE_STARTUP_STATS" ) };
+	if ( pPath == nullptr || pPath[0] == '\0' )
+	{
+		return;
+	}
+	m_StartupProfile.AddStep( "first frame" );
+	m_StartupProfile.Report( std::cout );
+	if ( std::string{ pPath } != "1" && !m_StartupProfile.AppendCsv( pPath ) )
+	{
+		std::cerr << "Core::ReportStartup( ), unable to write " << pPath << '\n';
+	}
+}
+
+void Core::Cleanup( )
+{
+	delete m_pHud;
+	m_pHud = nullptr;
+	delete m_pStatsWriter;
+	m_pStatsWriter = nullptr;
+	if ( m_pPacer != nullptr )
+	{
+		// Only of interest when the pacer does more than throttle an idle window
+		if ( m_Window.maxFps > 0.0f || m_Window.isLowLatencyOn )
+		{
+			m_pPacer->Report( std::cout );
+		}
+		delete m_pPacer;
+		m_pPacer = nullptr;
+	}
+	if ( m_pLatency != nullptr )
+	{
+		m_pLatency->Report( std::cout );
+		delete m_pLatency;
+		m_pLatency = nullptr;
+	}
+
+	dae::StopHotReload( );
+	dae::StopPreloading( );
+
+	dae::StopRenderBackend( );
+	SDL_GL_DeleteContext( m_pContext );
+
+	SDL_DestroyWindow( m_pWindow );
+	m_pWindow = nullptr;
+
+	SDL_Quit( );
+}
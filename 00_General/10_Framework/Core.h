@@ -0,0 +1,63 @@
+#pragma once
+#include "StartupProfile.h"
+#include "TimerWheel.h"
+#include "Task.h"
+
+class PerformanceHud;
+class RenderStatsWriter;
+class LatencyMonitor;
+class FramePacer;
+class Game;
+struct FrameTimes;
+struct RenderStats;
+
+class Core
+{
+public:
+	explicit Core( const Window& window );
+	Core( const Core& other ) = delete;
+	Core& operator=( const Core& other ) = delete;
+	~Core( );
+
+	void Run( );
+
+private:
+	// DATA MEMBERS
+	// The window properties
+	Window m_Window;
+	// The window we render to
+	SDL_Window* m_pWindow{ };
+	// OpenGL context
+	SDL_GLContext m_pContext{ };
+	// The time keeper
+	Uint32 m_MilliSeconds{};
+	// Init info
+	bool m_Initialized;
+	// Duration of each start-up step, reported after the first frame when DAE_STARTUP_STATS is set
+	StartupProfile m_StartupProfile;
+	// Game timers, advanced with the elapsed time of each Update
+	TimerWheel m_Timers;
+	// Game coroutines, resumed after the timers and before Update
+	TaskScheduler m_Tasks;
+	// Performance overlay, toggled with F1
+	PerformanceHud* m_pHud{ };
+	// Per frame statistics file and frame limit, for unattended runs
+	RenderStatsWriter* m_pStatsWriter{ };
+	int m_MaxFrames{ };
+	int m_NrFrames{ };
+	// Input-to-photon latency measurement, off unless DAE_LATENCY is set
+	LatencyMonitor* m_pLatency{ };
+	// Frame rate cap, low latency mode and idle throttle
+	FramePacer* m_pPacer{ };
+
+	// FUNCTIONS
+	void Initialize( );
+	void Cleanup( );
+	void RunThreaded( Game& game );
+	// Shared end of frame bookkeeping, returns true when the frame limit is reached
+	bool EndFrame( FrameTimes& times, const RenderStats& renderStats );
+	void ProcessHotKey( const SDL_Event& e );
+	void ProcessInputEvent( Game& game, const SDL_Event& e );
+	void ProcessWindowEvent( const SDL_WindowEvent& e );
+	void ReportStartup( );
+};
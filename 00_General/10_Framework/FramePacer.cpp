@@ -0,0 +1,214 @@
+#include "stdafx.h"
+#include "FramePacer.h"
+#include <algorithm>
+#include <iomanip>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <ctime>
+#endif
+
+namespace
+{
+	// Frame rate caps while the window isn't in use
+	const float g_MinimizedFps{ 10.0f };
+	const float g_UnfocusedFps{ 30.0f };
+	// Extra time kept between the predicted end of the work and the vertical blank
+	const float g_LateLatchMarginMs{ 1.0f };
+}
+
+FramePacer::FramePacer( float maxFps, bool isLowLatencyOn )
+	:m_MaxFps{ maxFps }
+	,m_IsLowLatencyOn{ isLowLatencyOn }
+	,m_RefreshInterval{ 1000.0f / 60.0f }
+	,m_IsMinimized{ false }
+	,m_IsFocused{ true }
+	,m_MsPerCount{ 1000.0f / SDL_GetPerformanceFrequency( ) }
+	,m_NextStart{ 0 }
+	,m_LastSwap{ 0 }
+	,m_PredictedWorkMs{ 0.0f }
+	,m_SleepOvershootMs{ 2.0f }
+	,m_LastPacingError{ 0.0f }
+	,m_SumAbsPacingError{ 0.0 }
+	,m_MaxPacingError{ 0.0f }
+	,m_NrPacedFrames{ 0 }
+	,m_CpuWallStart{ SDL_GetPerformanceCounter( ) }
+	,m_CpuTimeStart{ GetProcessCpuSeconds( ) }
+	,m_CpuUsage{ 0.0f }
+{
+}
+
+void FramePacer::SetRefreshRate( float refreshRate )
+{
+	if ( refreshRate > 0.0f )
+	{
+		m_RefreshInterval = 1000.0f / refreshRate;
+	}
+}
+
+void FramePacer::SetMinimized( bool isMinimized )
+{
+	m_IsMinimized = isMinimized;
+}
+
+void FramePacer::SetFocused( bool isFocused )
+{
+	m_IsFocused = isFocused;
+}
+
+float FramePacer::WaitForFrameStart( )
+{
+	const Uint64 now{ SDL_GetPerformanceCounter( ) };
+	Uint64 target{ 0 };
+
+	const float intervalMs{ GetFrameInterval( ) };
+	const Uint64 interval{ Uint64( intervalMs / m_MsPerCount ) };
+	if ( interval > 0 )
+	{
+		// More than a frame behind: don't try to catch up with a burst of frames
+		if ( m_NextStart == 0 || now > m_NextStart + interval )
+		{
+			m_NextStart = now;
+		}
+		target = m_NextStart;
+	}
+
+	// Late latch: start when the work is predicted to end just before the next vertical blank
+	const bool isIdle{ m_IsMinimized || !m_IsFocused };
+	if ( m_IsLowLatencyOn && !isIdle && m_LastSwap != 0 )
+	{
+		const float delayMs{ m_RefreshInterval - m_PredictedWorkMs - g_LateLatchMarginMs };
+		if ( delayMs > 0.0f )
+		{
+			target = std::max( target, m_LastSwap + Uint64( delayMs / m_MsPerCount ) );
+		}
+	}
+
+	if ( target > now )
+	{
+		SleepUntil( target );
+	}
+	const Uint64 start{ SDL_GetPerformanceCounter( ) };
+
+	if ( target != 0 )
+	{
+		m_LastPacingError = start > target ? ( start - target ) * m_MsPerCount : 0.0f;
+		m_SumAbsPacingError += m_LastPacingError;
+		m_MaxPacingError = std::max( m_MaxPacingError, m_LastPacingError );
+		++m_NrPacedFrames;
+	}
+	if ( interval > 0 )
+	{
+		m_NextStart += interval;
+	}
+	return ( start - now ) * m_MsPerCount;
+}
+
+void FramePacer::EndFrame( float workMs )
+{
+	m_LastSwap = SDL_GetPerformanceCounter( );
+
+	if ( workMs > m_PredictedWorkMs )
+	{
+		m_PredictedWorkMs = workMs;
+	}
+	else
+	{
+		m_PredictedWorkMs += ( workMs - m_PredictedWorkMs ) * 0.02f;
+	}
+
+	UpdateCpuUsage( m_LastSwap );
+}
+
+float FramePacer::GetLastPacingError( ) const
+{
+	return m_LastPacingError;
+}
+
+float FramePacer::GetCpuUsage( ) const
+{
+	return m_CpuUsage;
+}
+
+void FramePacer::Report( std::ostream& os ) const
+{
+	os << std::fixed << std::setprecision( 3 ) << "Frame pacing: ";
+	if ( m_NrPacedFrames == 0 )
+	{
+		os << "no paced frames";
+	}
+	else
+	{
+		os << m_NrPacedFrames << " paced frames, mean error " << m_SumAbsPacingError / m_NrPacedFrames
+			<< " ms, max error " << m_MaxPacingError << " ms";
+	}
+	os << std::setprecision( 1 ) << ", cpu " << m_CpuUsage << "%\n" << std::defaultfloat;
+}
+
+float FramePacer::GetFrameInterval( ) const
+{
+	float fps{ m_MaxFps };
+	if ( m_IsMinimized || !m_IsFocused )
+	{
+		const float idleFps{ m_IsMinimized ? g_MinimizedFps : g_UnfocusedFps };
+		fps = fps > 0.0f ? std::min( fps, idleFps ) : idleFps;
+	}
+	return fps > 0.0f ? 1000.0f / fps : 0.0f;
+}
+
+void FramePacer::SleepUntil( Uint64 target )
+{
+	// SDL_Delay has a 1 ms resolution (SDL raises the Windows timer resolution to 1 ms) and can oversleep,
+	// so sleep until the expected overshoot is left and spin for the rest
+	Uint64 now{ SDL_GetPerformanceCounter( ) };
+	while ( now < target )
+	{
+		const float remainingMs{ ( target - now ) * m_MsPerCount };
+		if ( remainingMs <= m_SleepOvershootMs + 1.0f )
+		{
+			break;
+		}
+		const Uint32 requestedMs{ Uint32( remainingMs - m_SleepOvershootMs ) };
+		SDL_Delay( requestedMs );
+		const Uint64 awake{ SDL_GetPerformanceCounter( ) };
+
+		// Follow increases immediately and let the estimate drop slowly
+		const float overshootMs{ ( awake - now ) * m_MsPerCount - requestedMs };
+		m_SleepOvershootMs = std::max( overshootMs, m_SleepOvershootMs * 0.95f );
+		m_SleepOvershootMs = std::max( m_SleepOvershootMs, 0.25f );
+		now = awake;
+	}
+	while ( SDL_GetPerformanceCounter( ) < target )
+	{
+	}
+}
+
+void FramePacer::UpdateCpuUsage( Uint64 now )
+{
+	const float wallSeconds{ ( now - m_CpuWallStart ) * m_MsPerCount / 1000.0f };
+	if ( wallSeconds < 1.0f )
+	{
+		return;
+	}
+	const double cpuSeconds{ GetProcessCpuSeconds( ) };
+	m_CpuUsage = float( ( cpuSeconds - m_CpuTimeStart ) / wallSeconds * 100.0 );
+	m_CpuWallStart = now;
+	m_CpuTimeStart = cpuSeconds;
+}
+
+double FramePacer::GetProcessCpuSeconds( )
+{
+#ifdef _WIN32
+	FILETIME creationTime{ }, exitTime{ }, kernelTime{ }, userTime{ };
+	if ( !GetProcessTimes( GetCurrentProcess( ), &creationTime, &exitTime, &kernelTime, &userTime ) )
+	{
+		return 0.0;
+	}
+	// In units of 100 ns
+	const ULONGLONG kernel{ ( ULONGLONG( kernelTime.dwHighDateTime ) << 32 ) | kernelTime.dwLowDateTime };
+	const ULONGLONG user{ ( ULONGLONG( userTime.dwHighDateTime ) << 32 ) | userTime.dwLowDateTime };
+	return ( kernel + user ) * 1e-7;
+#else
+	return double( std::clock( ) ) / CLOCKS_PER_SEC;
+#endif
+}
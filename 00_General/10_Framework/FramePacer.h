@@ -0,0 +1,71 @@
+#pragma once
+#include <ostream>
+
+// Decides when Core starts the next frame.
+//
+// Frame rate cap: frames start at fixed intervals. The wait sleeps while the remaining time
+// is larger than the measured sleep overshoot and spins for the rest, so frames start within
+// a few microseconds of their target without burning a core.
+//
+// Low latency mode (late latch): with vsync on, the swap returns at the vertical blank. Instead of
+// polling input right away and then waiting in the next swap, the frame starts as late as possible:
+// the next vertical blank minus the predicted duration of events, Update and Draw. Input is then
+// at most one frame old when it becomes visible.
+//
+// Idle throttle: while the window is minimized or doesn't have the focus, the frame rate is
+// limited to a few frames per second.
+class FramePacer
+{
+public:
+	explicit FramePacer( float maxFps, bool isLowLatencyOn );
+
+	// Frame interval of the display, used by the low latency mode
+	void SetRefreshRate( float refreshRate );
+	// Called by Core for window events
+	void SetMinimized( bool isMinimized );
+	void SetFocused( bool isFocused );
+
+	// Waits until the next frame has to start, returns the time it waited in ms
+	float WaitForFrameStart( );
+	// Called after the swap returns, with the duration of the work of this frame (events, Update, Draw) in ms
+	void EndFrame( float workMs );
+
+	// How late the last frame started, compared to its target, in ms
+	float GetLastPacingError( ) const;
+	// Share of one core used by the process during the last second, in percent
+	float GetCpuUsage( ) const;
+	void Report( std::ostream& os ) const;
+
+private:
+	// DATA MEMBERS
+	float m_MaxFps;
+	bool m_IsLowLatencyOn;
+	float m_RefreshInterval;
+	bool m_IsMinimized;
+	bool m_IsFocused;
+	float m_MsPerCount;
+
+	// Target start of the next frame, 0 when there is none
+	Uint64 m_NextStart;
+	Uint64 m_LastSwap;
+	// Work duration estimate for the low latency mode, follows increases immediately and decreases slowly
+	float m_PredictedWorkMs;
+	// Largest recent amount a sleep took longer than requested
+	float m_SleepOvershootMs;
+
+	float m_LastPacingError;
+	double m_SumAbsPacingError;
+	float m_MaxPacingError;
+	int m_NrPacedFrames;
+
+	// CPU usage over the last second
+	Uint64 m_CpuWallStart;
+	double m_CpuTimeStart;
+	float m_CpuUsage;
+
+	// FUNCTIONS
+	float GetFrameInterval( ) const;
+	void SleepUntil( Uint64 target );
+	void UpdateCpuUsage( Uint64 now );
+	static double GetProcessCpuSeconds( );
+};
@@ -0,0 +1,117 @@
+#include "stdafx.h"
+#include "Game.h"
+#include "SceneFile.h"
+
+Game::Game( const Window& window, TimerWheel& timers, TaskScheduler& tasks ) 
+	:m_Window{ window }
+	,m_Timers{ timers }
+	,m_Tasks{ tasks }
+{
+	Initialize( );
+}
+
+Game::~Game( )
+{
+	Cleanup( );
+}
+
+void Game::Initialize( )
+{
+}
+
+void Game::Cleanup( )
+{
+}
+
+void Game::Update( float elapsedSec )
+{
+}
+
+void Game::Draw( )
+{
+	ClearBackground( );
+}
+
+void Game::MakeSnapshot( GameSnapshot& snapshot ) const
+{
+}
+
+void Game::Draw( const GameSnapshot& snapshot ) const
+{
+	ClearBackground( );
+}
+
+bool Game::SaveScene( const std::string& path ) const
+{
+	SceneWriter writer{ };
+	// Add the game objects to the scene here, e.g. ball.AddToScene( writer );
+	return writer.Save( path );
+}
+
+void Game::ProcessKeyDownEvent( const SDL_KeyboardEvent & e )
+{
+	//std::cout << "KEYDOWN event: " << e.keysym.sym << std::endl;
+}
+
+void Game::ProcessKeyUpEvent( const SDL_KeyboardEvent& e )
+{
+	//std::cout << "KEYUP event: " << e.keysym.sym << std::endl;
+	//switch ( e.keysym.sym )
+	//{
+	//case SDLK_LEFT:
+	//	//std::cout << "Left arrow key released\n";
+	//	break;
+	//case SDLK_RIGHT:
+	//	//std::cout << "`Right arrow key released\n";
+	//	break;
+	//case SDLK_1:
+	//case SDLK_KP_1:
+	//	//std::cout << "Key 1 released\n";
+	//	break;
+	//}
+}
+
+void Game::ProcessMouseMotionEvent( const SDL_MouseMotionEvent& e )
+{
+	//std::cout << "MOUSEMOTION event: " << e.x << ", " << e.y << std::endl;
+}
+
+void Game::ProcessMouseDownEvent( const SDL_MouseButtonEvent& e )
+{
+	//std::cout << "MOUSEBUTTONDOWN event: ";
+	//switch ( e.button )
+	//{
+	//case SDL_BUTTON_LEFT:
+	//	std::cout << " left button " << std::endl;
+	//	break;
+	//case SDL_BUTTON_RIGHT:
+	//	std::cout << " right button " << std::endl;
+	//	break;
+	//case SDL_BUTTON_MIDDLE:
+	//	std::cout << " middle button " << std::endl;
+	//	break;
+	//}
+}
+
+void Game::ProcessMouseUpEvent( const SDL_MouseButtonEvent& e )
+{
+	//std::cout << "MOUSEBUTTONUP event: ";
+	//switch ( e.button )
+	//{
+	//case SDL_BUTTON_LEFT:
+	//	std::cout << " left button " << std::endl;
+	//	break;
+	//case SDL_BUTTON_RIGHT:
+	//	std::cout << " right button " << std::endl;
+	//	break;
+	//case SDL_BUTTON_MIDDLE:
+	//	std::cout << " middle button " << std::endl;
+	//	break;
+	//}
+}
+
+void Game::ClearBackground( ) const
+{
+	glClearColor( 0.0f, 0.0f, 0.0f, 1.0f );
+	glClear( GL_COLOR_BUFFER_BIT );
+}
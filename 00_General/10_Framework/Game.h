@@ -0,0 +1,54 @@
+#pragma once
+#include "TimerWheel.h"
+#include "Task.h"
+
+// What Draw needs when Update runs on its own thread (Window::simulationRate > 0).
+// MakeSnapshot fills it on the simulation thread, Draw( snapshot ) reads it on the render thread.
+// Store copies of the values here, not pointers to game objects: Update changes those while they are drawn.
+// OpenGL resources may only be created and destroyed on the render thread. The simulation thread has no OpenGL
+// context, and creating or destroying a Texture, SdfFont or Tilemap also changes the render thread's batches and queue.
+// So in Update and the Process*Event functions, don't construct or destroy them, not even by erasing objects that own
+// them: do it in the constructor and destructor of Game, which run on the render thread. Debug builds report it.
+struct GameSnapshot
+{
+};
+
+class Game
+{
+public:
+	// The timers and then the tasks are advanced by Core right before each Update
+	explicit Game( const Window& window, TimerWheel& timers, TaskScheduler& tasks );
+	Game( const Game& other ) = delete;
+	Game& operator=( const Game& other ) = delete;
+	~Game();
+
+	void Update( float elapsedSec );
+	void Draw( );
+
+	// Two-thread mode: fill the snapshot completely, it holds an older state
+	void MakeSnapshot( GameSnapshot& snapshot ) const;
+	void Draw( const GameSnapshot& snapshot ) const;
+
+	// Writes the current game state to a binary scene file (see SceneFile.h)
+	bool SaveScene( const std::string& path ) const;
+
+	// Event handling
+	void ProcessKeyDownEvent( const SDL_KeyboardEvent& e );
+	void ProcessKeyUpEvent( const SDL_KeyboardEvent& e );
+	void ProcessMouseMotionEvent( const SDL_MouseMotionEvent& e );
+	void ProcessMouseDownEvent( const SDL_MouseButtonEvent& e );
+	void ProcessMouseUpEvent( const SDL_MouseButtonEvent& e );
+
+private:
+	// DATA MEMBERS
+	Window m_Window;
+	// Delays, cooldowns and spawn timers, e.g. m_Timers.Schedule( 2.0f, [this] { SpawnEnemy( ); } );
+	TimerWheel& m_Timers;
+	// Coroutines for behavior that spans frames, e.g. m_Tasks.Start( SpawnWave( ) ); see Task.h
+	TaskScheduler& m_Tasks;
+
+	// FUNCTIONS
+	void Initialize( );
+	void Cleanup( );
+	void ClearBackground( ) const;
+};
\ No newline at end of file
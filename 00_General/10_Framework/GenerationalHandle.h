@@ -0,0 +1,87 @@
+#pragma once
+
+// 32-bit generational handle, the base of PoolHandle, TimerHandle, TaskHandle and Entity.
+// Low 20 bits: slot index, high 12 bits: generation of the slot when the handle was made.
+// Freeing a slot moves it to the next generation, so the handles to what it held no longer match it (stale).
+// Generation 0 is never used: a valid handle is never 0, and a default constructed handle is invalid.
+// Derived is the handle type itself, so the handles of different containers don't mix:
+//		struct TimerHandle : GenerationalHandle<TimerHandle>
+//		{
+//			using GenerationalHandle::GenerationalHandle;
+//		};
+template <typename Derived>
+struct GenerationalHandle
+{
+	static const unsigned int indexBits{ 20 };
+	static const unsigned int indexMask{ ( 1u << indexBits ) - 1 };
+	static const unsigned int generationMask{ ( 1u << ( 32 - indexBits ) ) - 1 };
+
+	GenerationalHandle( );
+	explicit GenerationalHandle( unsigned int id );
+	GenerationalHandle( unsigned int index, unsigned int generation );
+
+	bool IsValid( ) const;
+	unsigned int GetIndex( ) const;
+	unsigned int GetGeneration( ) const;
+	bool operator==( const GenerationalHandle& other ) const;
+	bool operator!=( const GenerationalHandle& other ) const;
+
+	// The generation of a slot after it is freed, wraps around to 1
+	static unsigned int GetNextGeneration( unsigned int generation );
+
+	unsigned int id;
+};
+
+template <typename Derived>
+GenerationalHandle<Derived>::GenerationalHandle( )
+	:GenerationalHandle{ 0 }
+{
+}
+
+template <typename Derived>
+GenerationalHandle<Derived>::GenerationalHandle( unsigned int id )
+	:id{ id }
+{
+}
+
+template <typename Derived>
+GenerationalHandle<Derived>::GenerationalHandle( unsigned int index, unsigned int generation )
+	:id{ ( generation << indexBits ) | ( index & indexMask ) }
+{
+}
+
+template <typename Derived>
+bool GenerationalHandle<Derived>::IsValid( ) const
+{
+	return id != 0;
+}
+
+template <typename Derived>
+unsigned int GenerationalHandle<Derived>::GetIndex( ) const
+{
+	return id & indexMask;
+}
+
+template <typename Derived>
+unsigned int GenerationalHandle<Derived>::GetGeneration( ) const
+{
+	return id >> indexBits;
+}
+
+template <typename Derived>
+bool GenerationalHandle<Derived>::operator==( const GenerationalHandle& other ) const
+{
+	return id == other.id;
+}
+
+template <typename Derived>
+bool GenerationalHandle<Derived>::operator!=( const GenerationalHandle& other ) const
+{
+	return id != other.id;
+}
+
+template <typename Derived>
+unsigned int GenerationalHandle<Derived>::GetNextGeneration( unsigned int generation )
+{
+	return generation % generationMask + 1;
+}
@@ -0,0 +1,198 @@
+#include "stdafx.h"
+#include "GlState.h"
+#include "RenderStats.h"
+
+namespace dae
+{
+	namespace
+	{
+		// A value OpenGL is known to have
+		template<typename Value>
+		struct Shadow
+		{
+			Value value;
+			bool isKnown;
+		};
+
+		struct BlendFunc
+		{
+			GLenum source;
+			GLenum destination;
+		};
+
+		struct AlphaFunc
+		{
+			GLenum function;
+			float reference;
+		};
+
+		bool operator==( const BlendFunc& left, const BlendFunc& right )
+		{
+			return left.source == right.source && left.destination == right.destination;
+		}
+
+		bool operator==( const AlphaFunc& left, const AlphaFunc& right )
+		{
+			return left.function == right.function && left.reference == right.reference;
+		}
+
+		bool operator==( const Color4f& left, const Color4f& right )
+		{
+			return left.r == right.r && left.g == right.g && left.b == right.b && left.a == right.a;
+		}
+
+		Shadow<GLuint> g_Texture{ };
+		Shadow<bool> g_IsTexture2dOn{ };
+		Shadow<bool> g_IsBlendOn{ };
+		Shadow<bool> g_IsAlphaTestOn{ };
+		Shadow<BlendFunc> g_BlendFunc{ };
+		Shadow<AlphaFunc> g_AlphaFunc{ };
+		Shadow<GLint> g_TexEnvMode{ };
+		Shadow<Color4f> g_Color{ };
+		Shadow<float> g_LineWidth{ };
+		Shadow<float> g_PointSize{ };
+
+		// Returns true when OpenGL has to be told, and counts the call as sent or elided
+		template<typename Value>
+		bool Change( Shadow<Value>& shadow, const Value& value )
+		{
+			if ( shadow.isKnown && shadow.value == value )
+			{
+				CountElidedStateChange( );
+				return false;
+			}
+			shadow.value = value;
+			shadow.isKnown = true;
+			CountStateChange( );
+			return true;
+		}
+
+		Shadow<bool>* GetCapabilityShadow( GLenum capability )
+		{
+			switch ( capability )
+			{
+			case GL_TEXTURE_2D:
+				return &g_IsTexture2dOn;
+			case GL_BLEND:
+				return &g_IsBlendOn;
+			case GL_ALPHA_TEST:
+				return &g_IsAlphaTestOn;
+			default:
+				return nullptr;
+			}
+		}
+	}
+
+	void ResetGlState( )
+	{
+		g_Texture.isKnown = false;
+		g_IsTexture2dOn.isKnown = false;
+		g_IsBlendOn.isKnown = false;
+		g_IsAlphaTestOn.isKnown = false;
+		g_BlendFunc.isKnown = false;
+		g_AlphaFunc.isKnown = false;
+		g_TexEnvMode.isKnown = false;
+		g_Color.isKnown = false;
+		g_LineWidth.isKnown = false;
+		g_PointSize.isKnown = false;
+	}
+
+	void SetGlTexture( GLuint textureId )
+	{
+		if ( g_Texture.isKnown && g_Texture.value == textureId )
+		{
+			CountElidedTextureBind( );
+			return;
+		}
+		g_Texture = Shadow<GLuint>{ textureId, true };
+		glBindTexture( GL_TEXTURE_2D, textureId );
+		CountTextureBind( );
+	}
+
+	void DeleteGlTexture( GLuint textureId )
+	{
+		if ( textureId == 0 )
+		{
+			return;
+		}
+		glDeleteTextures( 1, &textureId );
+		if ( g_Texture.value == textureId )
+		{
+			g_Texture.value = 0;
+		}
+	}
+
+	void SetGlCapability( GLenum capability, bool isEnabled )
+	{
+		Shadow<bool>* pShadow{ GetCapabilityShadow( capability ) };
+		if ( pShadow == nullptr )
+		{
+			CountStateChange( );
+		}
+		else if ( !Change( *pShadow, isEnabled ) )
+		{
+			return;
+		}
+		if ( isEnabled )
+		{
+			glEnable( capability );
+		}
+		else
+		{
+			glDisable( capability );
+		}
+	}
+
+	void SetGlBlendFunc( GLenum source, GLenum destination )
+	{
+		if ( Change( g_BlendFunc, BlendFunc{ source, destination } ) )
+		{
+			glBlendFunc( source, destination );
+		}
+	}
+
+	void SetGlAlphaFunc( GLenum function, float reference )
+	{
+		if ( Change( g_AlphaFunc, AlphaFunc{ function, reference } ) )
+		{
+			glAlphaFunc( function, reference );
+		}
+	}
+
+	void SetGlTexEnvMode( GLint mode )
+	{
+		if ( Change( g_TexEnvMode, mode ) )
+		{
+			glTexEnvi( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, mode );
+		}
+	}
+
+	void SetGlColor( const Color4f& color )
+	{
+		if ( Change( g_Color, color ) )
+		{
+			glColor4f( color.r, color.g, color.b, color.a );
+		}
+	}
+
+	void ForgetGlColor( )
+	{
+		g_Color.isKnown = false;
+	}
+
+	void SetGlLineWidth( float width )
+	{
+		if ( Change( g_LineWidth, width ) )
+		{
+			glLineWidth( width );
+		}
+	}
+
+	void SetGlPointSize( float size )
+	{
+		if ( Change( g_PointSize, size ) )
+		{
+			glPointSize( size );
+		}
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+// Shadow copy of the OpenGL state the framework draws with: a call that wouldn't change anything isn't sent.
+// RenderStats counts the calls that were sent (textureBinds, stateChanges) and the ones that weren't (elided...).
+//
+// The draws set the state they need and leave it that way: after Texture::Draw, texturing stays enabled until
+// something draws without a texture. Code that draws with OpenGL directly sets its state with these functions too,
+// or calls ResetGlState after changing it behind their back.
+namespace dae
+{
+	// Forgets the shadow copy: the next call of each function goes to OpenGL. StartRenderBackend calls it for each new context
+	void ResetGlState( );
+
+	void SetGlTexture( GLuint textureId );
+	// OpenGL binds 0 in place of a bound texture that is deleted
+	void DeleteGlTexture( GLuint textureId );
+	// GL_TEXTURE_2D, GL_BLEND and GL_ALPHA_TEST are shadowed, other capabilities always go to OpenGL
+	void SetGlCapability( GLenum capability, bool isEnabled );
+	void SetGlBlendFunc( GLenum source, GLenum destination );
+	void SetGlAlphaFunc( GLenum function, float reference );
+	void SetGlTexEnvMode( GLint mode );
+	// Also between glBegin and glEnd
+	void SetGlColor( const Color4f& color );
+	// After drawing with a color array, which leaves the current color undefined
+	void ForgetGlColor( );
+	void SetGlLineWidth( float width );
+	void SetGlPointSize( float size );
+}
@@ -0,0 +1,322 @@
+#include "stdafx.h"
+#include "HotReload.h"
+#include <iostream>
+#include <vector>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <algorithm>
+#include <system_error>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace dae
+{
+	namespace
+	{
+		using Clock = std::chrono::steady_clock;
+
+		struct Watch
+		{
+			// Unique, so a reload decoded for a destroyed owner is never applied to a new owner at the same address
+			int id;
+			std::string path;
+			const void* pOwner;
+			std::function<SDL_Surface*( )> decode;
+			std::function<void( SDL_Surface* )> apply;
+			// Only used when polling
+			std::filesystem::file_time_type writeTime;
+		};
+		struct Reload
+		{
+			int watchId;
+			std::string path;
+			std::function<void( SDL_Surface* )> apply;
+			SDL_Surface* pSurface;
+			Clock::time_point changeTime;
+		};
+
+		// A file is decoded when it didn't change for this long
+		const std::chrono::milliseconds g_SettleTime{ 100 };
+		const std::chrono::milliseconds g_PollInterval{ 250 };
+
+		std::mutex g_Mutex;
+		std::vector<Watch> g_Watches;
+		std::vector<Reload> g_Reloads;
+		int g_NextWatchId{ 1 };
+		std::atomic<bool> g_IsOn{ false };
+		std::atomic<bool> g_Stop{ false };
+		std::thread g_Watcher;
+		std::string g_Folder;
+
+		std::string GetKey( const std::string& path )
+		{
+			// Same file, same key, however the path was written
+			std::error_code error{ };
+			const std::filesystem::path canonical{ std::filesystem::weakly_canonical( path, error ) };
+			return error ? path : canonical.generic_string( );
+		}
+
+		void DecodeSettled( std::map<std::string, Clock::time_point>& changes )
+		{
+			const Clock::time_point now{ Clock::now( ) };
+			for ( std::map<std::string, Clock::time_point>::iterator it{ changes.begin( ) }; it != changes.end( ); )
+			{
+				if ( now - it->second < g_SettleTime )
+				{
+					++it;
+					continue;
+				}
+
+				std::vector<Watch> watches{ };
+				{
+					std::lock_guard<std::mutex> lock{ g_Mutex };
+					for ( const Watch& watch : g_Watches )
+					{
+						if ( watch.path == it->first )
+						{
+							watches.push_back( watch );
+						}
+					}
+				}
+				for ( const Watch& watch : watches )
+				{
+					SDL_Surface* pSurface{ watch.decode( ) };
+					if ( pSurface == nullptr )
+					{
+						// Most likely the file is still being written, the next change tries again
+						std::cerr << "dae::HotReload, unable to decode " << watch.path << ": " << SDL_GetError( ) << '\n';
+						continue;
+					}
+					std::lock_guard<std::mutex> lock{ g_Mutex };
+					const bool isWatched{ std::any_of( g_Watches.begin( ), g_Watches.end( ), [&watch]( const Watch& other ) { return other.id == watch.id; } ) };
+					if ( isWatched )
+					{
+						g_Reloads.push_back( Reload{ watch.id, watch.path, watch.apply, pSurface, it->second } );
+					}
+					else
+					{
+						SDL_FreeSurface( pSurface );
+					}
+				}
+				it = changes.erase( it );
+			}
+		}
+
+#ifdef __linux__
+		void AddWatches( int fd, const std::filesystem::path& folder, std::map<int, std::filesystem::path>& folders )
+		{
+			// inotify doesn't watch subfolders, add one watch per folder
+			const Uint32 mask{ IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE };
+			const int wd{ inotify_add_watch( fd, folder.c_str( ), mask ) };
+			if ( wd < 0 )
+			{
+				std::cerr << "dae::StartHotReload( ), unable to watch " << folder << '\n';
+				return;
+			}
+			folders[wd] = folder;
+			std::error_code error{ };
+			for ( const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator{ folder, error } )
+			{
+				if ( entry.is_directory( error ) )
+				{
+					AddWatches( fd, entry.path( ), folders );
+				}
+			}
+		}
+
+		void WatchFolder( )
+		{
+			const int fd{ inotify_init1( IN_NONBLOCK ) };
+			if ( fd < 0 )
+			{
+				std::cerr << "dae::StartHotReload( ), inotify_init1 failed\n";
+				return;
+			}
+			std::map<int, std::filesystem::path> folders{ };
+			AddWatches( fd, std::filesystem::path{ g_Folder }, folders );
+
+			std::map<std::string, Clock::time_point> changes{ };
+			alignas( inotify_event ) char buffer[4096];
+			while ( !g_Stop )
+			{
+				// Wake up regularly to stop and to decode the files that settled
+				pollfd pollInfo{ fd, POLLIN, 0 };
+				if ( poll( &pollInfo, 1, 20 ) > 0 )
+				{
+					ssize_t size{ read( fd, buffer, sizeof( buffer ) ) };
+					for ( ssize_t pos{ 0 }; pos < size; )
+					{
+						const inotify_event* pEvent{ reinterpret_cast<const inotify_event*>( buffer + pos ) };
+						pos += sizeof( inotify_event ) + pEvent->len;
+						if ( pEvent->len == 0 || folders.count( pEvent->wd ) == 0 )
+						{
+							continue;
+						}
+						const std::filesystem::path path{ folders[pEvent->wd] / pEvent->name };
+						if ( pEvent->mask & IN_ISDIR )
+						{
+							AddWatches( fd, path, folders );
+						}
+						else if ( pEvent->mask & ( IN_CLOSE_WRITE | IN_MOVED_TO ) )
+						{
+							changes[GetKey( path.string( ) )] = Clock::now( );
+						}
+					}
+				}
+				DecodeSettled( changes );
+			}
+			close( fd );
+		}
+#else
+		void WatchFolder( )
+		{
+			// No change notifications: compare the modification time of the watched files
+			std::map<std::string, Clock::time_point> changes{ };
+			Clock::time_point nextPoll{ Clock::now( ) };
+			while ( !g_Stop )
+			{
+				if ( Clock::now( ) >= nextPoll )
+				{
+					nextPoll += g_PollInterval;
+					std::lock_guard<std::mutex> lock{ g_Mutex };
+					for ( Watch& watch : g_Watches )
+					{
+						std::error_code error{ };
+						const std::filesystem::file_time_type writeTime{ std::filesystem::last_write_time( watch.path, error ) };
+						if ( !error && writeTime != watch.writeTime )
+						{
+							watch.writeTime = writeTime;
+							changes[watch.path] = Clock::now( );
+						}
+					}
+				}
+				DecodeSettled( changes );
+				std::this_thread::sleep_for( std::chrono::milliseconds{ 20 } );
+			}
+		}
+#endif
+	}
+
+	void StartHotReload( const std::string& folder )
+	{
+		if ( g_IsOn )
+		{
+			return;
+		}
+		std::error_code error{ };
+		if ( !std::filesystem::is_directory( folder, error ) )
+		{
+			std::cerr << "dae::StartHotReload( ), " << folder << " is not a folder\n";
+			return;
+		}
+		g_Folder = folder;
+		g_Stop = false;
+		g_IsOn = true;
+		g_Watcher = std::thread{ WatchFolder };
+		std::cout << "Hot reload: watching " << folder << '\n';
+	}
+
+	void StopHotReload( )
+	{
+		if ( !g_IsOn )
+		{
+			return;
+		}
+		g_Stop = true;
+		g_Watcher.join( );
+		g_IsOn = false;
+
+		std::lock_guard<std::mutex> lock{ g_Mutex };
+		for ( Reload& reload : g_Reloads )
+		{
+			SDL_FreeSurface( reload.pSurface );
+		}
+		g_Reloads.clear( );
+		g_Watches.clear( );
+	}
+
+	bool IsHotReloadOn( )
+	{
+		return g_IsOn;
+	}
+
+	void ApplyHotReloads( )
+	{
+		if ( !g_IsOn )
+		{
+			return;
+		}
+		std::vector<Reload> reloads{ };
+		{
+			std::lock_guard<std::mutex> lock{ g_Mutex };
+			if ( g_Reloads.empty( ) )
+			{
+				return;
+			}
+			reloads.swap( g_Reloads );
+		}
+		for ( Reload& reload : reloads )
+		{
+			reload.apply( reload.pSurface );
+			SDL_FreeSurface( reload.pSurface );
+			const float ms{ std::chrono::duration<float, std::milli>( Clock::now( ) - reload.changeTime ).count( ) };
+			std::cout << "Hot reload: " << reload.path << ", " << ms << " ms after the last write\n";
+		}
+	}
+
+	bool HasHotReloads( )
+	{
+		if ( !g_IsOn )
+		{
+			return false;
+		}
+		std::lock_guard<std::mutex> lock{ g_Mutex };
+		return !g_Reloads.empty( );
+	}
+
+	void WatchFile( const std::string& path, const void* pOwner, std::function<SDL_Surface*( )> decode, std::function<void( SDL_Surface* )> apply )
+	{
+		if ( !g_IsOn )
+		{
+			return;
+		}
+		Watch watch{ 0, GetKey( path ), pOwner, std::move( decode ), std::move( apply ), { } };
+		std::error_code error{ };
+		watch.writeTime = std::filesystem::last_write_time( watch.path, error );
+
+		std::lock_guard<std::mutex> lock{ g_Mutex };
+		watch.id = g_NextWatchId++;
+		g_Watches.push_back( std::move( watch ) );
+	}
+
+	void UnwatchFiles( const void* pOwner )
+	{
+		if ( !g_IsOn )
+		{
+			return;
+		}
+		std::lock_guard<std::mutex> lock{ g_Mutex };
+		for ( size_t idx{ 0 }; idx < g_Reloads.size( ); )
+		{
+			const int watchId{ g_Reloads[idx].watchId };
+			const bool isOwned{ std::any_of( g_Watches.begin( ), g_Watches.end( ), [watchId, pOwner]( const Watch& watch ) { return watch.id == watchId && watch.pOwner == pOwner; } ) };
+			if ( isOwned )
+			{
+				SDL_FreeSurface( g_Reloads[idx].pSurface );
+				g_Reloads.erase( g_Reloads.begin( ) + idx );
+			}
+			else
+			{
+				++idx;
+			}
+		}
+		g_Watches.erase( std::remove_if( g_Watches.begin( ), g_Watches.end( ), [pOwner]( const Watch& watch ) { return watch.pOwner == pOwner; } ), g_Watches.end( ) );
+	}
+}
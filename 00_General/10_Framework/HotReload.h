@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+#include <functional>
+
+// Reloads images and fonts while the game runs, when they change on disk.
+// Turned on with DAE_HOT_RELOAD=1 (the Resources folder) or DAE_HOT_RELOAD=<folder>.
+//
+// A thread watches the folder (inotify on Linux, polling the modification time of the watched files elsewhere).
+// Editors often save a file in several writes, so a file is only decoded again when it didn't change
+// for a short while. Decoding happens on the watch thread, Core uploads the results at the start of a frame.
+// Texture watches its own image or font: the texture keeps its OpenGL name, so its users don't notice.
+namespace dae
+{
+	// Called by Core
+	void StartHotReload( const std::string& folder );
+	void StopHotReload( );
+	bool IsHotReloadOn( );
+	// On the thread that owns the OpenGL context, applies the files decoded since the previous call
+	void ApplyHotReloads( );
+	// Whether ApplyHotReloads has files to apply
+	bool HasHotReloads( );
+
+	// Does nothing when hot reload is off.
+	// decode runs on the watch thread and returns a new surface, or nullptr when decoding failed: only capture copies.
+	// apply runs in ApplyHotReloads, the surface is freed afterwards.
+	void WatchFile( const std::string& path, const void* pOwner, std::function<SDL_Surface*( )> decode, std::function<void( SDL_Surface* )> apply );
+	// Call before pOwner is destroyed, reloads that weren't applied yet are dropped
+	void UnwatchFiles( const void* pOwner );
+}
@@ -0,0 +1,168 @@
+#include "stdafx.h"
+#include "LatencyMonitor.h"
+#include <iomanip>
+#include <algorithm>
+#include <string>
+
+const float LatencyMonitor::m_BucketMs{ 0.5f };
+
+LatencyMonitor::LatencyMonitor( bool isFenced )
+	:m_IsFenced{ isFenced }
+	,m_MsPerCount{ 1000.0f / SDL_GetPerformanceFrequency( ) }
+	,m_IsHandling{ false }
+	,m_Updated{ 0 }
+	,m_Drawn{ 0 }
+	,m_SumMs{ }
+	,m_MaxMs{ }
+	,m_NrEvents{ 0 }
+{
+	for ( std::vector<int>& histogram : m_Histograms )
+	{
+		histogram.assign( m_NrBuckets, 0 );
+	}
+}
+
+bool LatencyMonitor::IsFenced( ) const
+{
+	return m_IsFenced;
+}
+
+void LatencyMonitor::StampEvent( const SDL_Event& e )
+{
+	m_IsHandling = ( e.type >= SDL_KEYDOWN && e.type <= SDL_KEYUP ) || ( e.type >= SDL_MOUSEMOTION && e.type <= SDL_MOUSEWHEEL );
+	if ( !m_IsHandling )
+	{
+		return;
+	}
+
+	PendingEvent pending{ };
+	pending.polled = SDL_GetPerformanceCounter( );
+	pending.queuedMs = float( SDL_GetTicks( ) - e.common.timestamp );
+	pending.handled = pending.polled;
+	m_Pending.push_back( pending );
+}
+
+void LatencyMonitor::MarkHandled( )
+{
+	if ( m_IsHandling )
+	{
+		m_Pending.back( ).handled = SDL_GetPerformanceCounter( );
+		m_IsHandling = false;
+	}
+}
+
+void LatencyMonitor::MarkUpdated( )
+{
+	m_Updated = SDL_GetPerformanceCounter( );
+}
+
+void LatencyMonitor::MarkDrawn( )
+{
+	m_Drawn = SDL_GetPerformanceCounter( );
+}
+
+void LatencyMonitor::MarkPresented( )
+{
+	const Uint64 presented{ SDL_GetPerformanceCounter( ) };
+	for ( const PendingEvent& pending : m_Pending )
+	{
+		// Each stage is the time from the end of the previous stage
+		AddSample( Stage::queued, pending.queuedMs );
+		AddSample( Stage::handled, ( pending.handled - pending.polled ) * m_MsPerCount );
+		AddSample( Stage::updated, ( m_Updated - pending.handled ) * m_MsPerCount );
+		AddSample( Stage::drawn, ( m_Drawn - m_Updated ) * m_MsPerCount );
+		AddSample( Stage::presented, ( presented - m_Drawn ) * m_MsPerCount );
+		AddSample( Stage::total, pending.queuedMs + ( presented - pending.polled ) * m_MsPerCount );
+		++m_NrEvents;
+	}
+	m_Pending.clear( );
+}
+
+void LatencyMonitor::AddSample( Stage stage, float ms )
+{
+	const int idx{ int( stage ) };
+	const int bucket{ std::min( int( ms / m_BucketMs ), m_NrBuckets - 1 ) };
+	++m_Histograms[idx][std::max( bucket, 0 )];
+	m_SumMs[idx] += ms;
+	m_MaxMs[idx] = std::max( m_MaxMs[idx], ms );
+}
+
+float LatencyMonitor::GetPercentile( Stage stage, float fraction ) const
+{
+	// Upper edge of the bucket that holds the requested fraction of the events, at most the maximum
+	const std::vector<int>& histogram{ m_Histograms[int( stage )] };
+	const int target{ int( fraction * m_NrEvents ) };
+	int count{ 0 };
+	for ( int bucket{ 0 }; bucket < m_NrBuckets; ++bucket )
+	{
+		count += histogram[bucket];
+		if ( count > target )
+		{
+			return std::min( ( bucket + 1 ) * m_BucketMs, m_MaxMs[int( stage )] );
+		}
+	}
+	return m_MaxMs[int( stage )];
+}
+
+const char* LatencyMonitor::GetStageName( Stage stage )
+{
+	switch ( stage )
+	{
+	case Stage::queued:
+		return "queued";
+	case Stage::handled:
+		return "event handler";
+	case Stage::updated:
+		return "until Update end";
+	case Stage::drawn:
+		return "Draw";
+	case Stage::presented:
+		return "swap";
+	case Stage::total:
+		return "total";
+	default:
+		return "";
+	}
+}
+
+void LatencyMonitor::Report( std::ostream& os ) const
+{
+	os << "Input latency of " << m_NrEvents << " events" << ( m_IsFenced ? ", swap fenced with glFinish" : "" ) << '\n';
+	if ( m_NrEvents == 0 )
+	{
+		return;
+	}
+
+	os << std::fixed << std::setprecision( 2 );
+	os << "  " << std::left << std::setw( 18 ) << "stage" << std::right
+		<< std::setw( 9 ) << "mean" << std::setw( 9 ) << "p50" << std::setw( 9 ) << "p90" << std::setw( 9 ) << "p99" << std::setw( 9 ) << "max" << '\n';
+	for ( int idx{ 0 }; idx < int( Stage::count ); ++idx )
+	{
+		const Stage stage{ Stage( idx ) };
+		os << "  " << std::left << std::setw( 18 ) << GetStageName( stage ) << std::right
+			<< std::setw( 9 ) << m_SumMs[idx] / m_NrEvents
+			<< std::setw( 9 ) << GetPercentile( stage, 0.5f )
+			<< std::setw( 9 ) << GetPercentile( stage, 0.9f )
+			<< std::setw( 9 ) << GetPercentile( stage, 0.99f )
+			<< std::setw( 9 ) << m_MaxMs[idx] << '\n';
+	}
+
+	// Histogram of the total latency, in 1 ms rows scaled to the fullest row
+	const std::vector<int>& histogram{ m_Histograms[int( Stage::total )] };
+	const int bucketsPerRow{ 2 };
+	std::vector<int> rows( ( m_NrBuckets + bucketsPerRow - 1 ) / bucketsPerRow, 0 );
+	for ( int bucket{ 0 }; bucket < m_NrBuckets; ++bucket )
+	{
+		rows[bucket / bucketsPerRow] += histogram[bucket];
+	}
+	const int maxCount{ *std::max_element( rows.begin( ), rows.end( ) ) };
+	const int lastRow{ int( std::find_if( rows.rbegin( ), rows.rend( ), []( int count ) { return count > 0; } ).base( ) - rows.begin( ) ) };
+	os << "  total latency histogram (ms)\n" << std::setprecision( 0 );
+	for ( int row{ 0 }; row < lastRow; ++row )
+	{
+		const bool isOverflow{ ( row + 1 ) * bucketsPerRow >= m_NrBuckets };
+		os << "  " << std::setw( 4 ) << row * bucketsPerRow * m_BucketMs << ( isOverflow ? "+ " : "  " ) << std::setw( 7 ) << rows[row] << ' '
+			<< std::string( size_t( 50.0f * rows[row] / maxCount ), '#' ) << '\n';
+	}
+	os << std::defaultfloat;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <vector>
+#include <ostream>
+
+// Measures input-to-photon latency: how long it takes before an input event is visible on screen.
+// Core stamps every input event when it is polled and follows it through the event handler,
+// Update, Draw and the return of SDL_GL_SwapWindow. With vsync on, the swap returns
+// when the driver accepts the frame, which can be a few frames before it is shown.
+// In fenced mode Core calls glFinish after the swap, so the last stage includes the GPU work.
+//
+// Enabled by setting the environment variable DAE_LATENCY to 1, or to finish for the fenced mode.
+// The histograms are written to std::cout when Core is destroyed.
+class LatencyMonitor
+{
+public:
+	explicit LatencyMonitor( bool isFenced );
+	LatencyMonitor( const LatencyMonitor& other ) = delete;
+	LatencyMonitor& operator=( const LatencyMonitor& other ) = delete;
+
+	bool IsFenced( ) const;
+
+	// Called before and after the handler of every event, only keyboard and mouse events are measured
+	void StampEvent( const SDL_Event& e );
+	void MarkHandled( );
+	// Called once per frame, after Update, after Draw and after the swap (and glFinish)
+	void MarkUpdated( );
+	void MarkDrawn( );
+	void MarkPresented( );
+
+	void Report( std::ostream& os ) const;
+
+private:
+	enum class Stage
+	{
+		queued,
+		handled,
+		updated,
+		drawn,
+		presented,
+		total,
+		count
+	};
+	struct PendingEvent
+	{
+		// Time spent in the SDL queue before polling, in ms (SDL timestamps have ms resolution)
+		float queuedMs;
+		Uint64 polled;
+		Uint64 handled;
+	};
+
+	// Histograms have 0.5 ms buckets, the last bucket holds everything above
+	static const int m_NrBuckets{ 201 };
+	static const float m_BucketMs;
+
+	// DATA MEMBERS
+	bool m_IsFenced;
+	float m_MsPerCount;
+	// Input events of the frame being made
+	std::vector<PendingEvent> m_Pending;
+	bool m_IsHandling;
+	Uint64 m_Updated;
+	Uint64 m_Drawn;
+	// Per stage: histogram, sum and maximum
+	std::vector<int> m_Histograms[int( Stage::count )];
+	double m_SumMs[int( Stage::count )];
+	float m_MaxMs[int( Stage::count )];
+	int m_NrEvents;
+
+	// FUNCTIONS
+	void AddSample( Stage stage, float ms );
+	float GetPercentile( Stage stage, float fraction ) const;
+	static const char* GetStageName( Stage stage );
+};
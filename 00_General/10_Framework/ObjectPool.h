@@ -0,0 +1,220 @@
+#pragma once
+#include <vector>
+#include <iostream>
+#include <utility>
+#include "GenerationalHandle.h"
+
+// 32-bit generational handle to an object in an ObjectPool, see GenerationalHandle.h.
+// A handle whose generation no longer matches its slot refers to a despawned object (stale).
+struct PoolHandle : GenerationalHandle<PoolHandle>
+{
+	using GenerationalHandle::GenerationalHandle;
+};
+
+// Pool of objects of type T, stored contiguously.
+// All memory is reserved at construction, so spawning and despawning never allocate.
+// Live objects are kept packed at the front of the storage (a despawn moves the last object into the hole),
+// so iterating with a range-based for loop only touches live objects.
+// Note that a despawn changes the storage order: keep handles, not pointers, to refer to objects.
+template <typename T>
+class ObjectPool
+{
+public:
+	explicit ObjectPool( int capacity );
+	ObjectPool( const ObjectPool& other ) = delete;
+	ObjectPool& operator=( const ObjectPool& other ) = delete;
+
+	// Constructs an object in the pool, returns an invalid handle when the pool is full
+	template <typename... Args>
+	PoolHandle Spawn( Args&&... args );
+	// Destroys the object, returns false when the handle is stale
+	bool Despawn( PoolHandle handle );
+
+	// Returns nullptr when the handle is stale
+	T* Get( PoolHandle handle );
+	const T* Get( PoolHandle handle ) const;
+	bool IsAlive( PoolHandle handle ) const;
+
+	int GetSize( ) const;
+	int GetCapacity( ) const;
+	void Clear( );
+
+	// Iteration over the live objects
+	typename std::vector<T>::iterator begin( );
+	typename std::vector<T>::iterator end( );
+	typename std::vector<T>::const_iterator begin( ) const;
+	typename std::vector<T>::const_iterator end( ) const;
+
+private:
+	struct Slot
+	{
+		// Index in m_Objects while alive, next free slot index while free
+		unsigned int index;
+		unsigned int generation;
+	};
+
+	static const unsigned int m_NoSlot{ PoolHandle::indexMask };
+
+	// DATA MEMBERS
+	// The live objects, packed
+	std::vector<T> m_Objects;
+	// Slot index of each object in m_Objects
+	std::vector<unsigned int> m_SlotIndices;
+	std::vector<Slot> m_Slots;
+	unsigned int m_FirstFreeSlot;
+
+	// FUNCTIONS
+	const Slot* GetSlot( PoolHandle handle ) const;
+};
+
+template <typename T>
+ObjectPool<T>::ObjectPool( int capacity )
+	:m_FirstFreeSlot{ m_NoSlot }
+{
+	if ( capacity < 0 || unsigned( capacity ) >= m_NoSlot )
+	{
+		std::cerr << "ObjectPool::ObjectPool( ), capacity should be in [0, " << m_NoSlot << "[, got " << capacity << '\n';
+		capacity = capacity < 0 ? 0 : int( m_NoSlot ) - 1;
+	}
+	m_Objects.reserve( capacity );
+	m_SlotIndices.reserve( capacity );
+	m_Slots.resize( capacity );
+	Clear( );
+}
+
+template <typename T>
+template <typename... Args>
+PoolHandle ObjectPool<T>::Spawn( Args&&... args )
+{
+	if ( m_FirstFreeSlot == m_NoSlot )
+	{
+		std::cerr << "ObjectPool::Spawn( ), pool is full, capacity: " << m_Slots.size( ) << '\n';
+		return PoolHandle{ };
+	}
+
+	unsigned int slotIndex{ m_FirstFreeSlot };
+	Slot& slot{ m_Slots[slotIndex] };
+	m_FirstFreeSlot = slot.index;
+
+	slot.index = unsigned( m_Objects.size( ) );
+	m_Objects.emplace_back( std::forward<Args>( args )... );
+	m_SlotIndices.push_back( slotIndex );
+
+	return PoolHandle{ slotIndex, slot.generation };
+}
+
+template <typename T>
+bool ObjectPool<T>::Despawn( PoolHandle handle )
+{
+	if ( GetSlot( handle ) == nullptr )
+	{
+		return false;
+	}
+	unsigned int slotIndex{ handle.GetIndex( ) };
+	Slot& slot{ m_Slots[slotIndex] };
+
+	// Move the last object into the hole to keep the live objects packed
+	unsigned int lastIndex{ unsigned( m_Objects.size( ) ) - 1 };
+	if ( slot.index != lastIndex )
+	{
+		m_Objects[slot.index] = std::move( m_Objects[lastIndex] );
+		m_SlotIndices[slot.index] = m_SlotIndices[lastIndex];
+		m_Slots[m_SlotIndices[slot.index]].index = slot.index;
+	}
+	m_Objects.pop_back( );
+	m_SlotIndices.pop_back( );
+
+	// Invalidate all handles to this slot
+	slot.generation = PoolHandle::GetNextGeneration( slot.generation );
+	slot.index = m_FirstFreeSlot;
+	m_FirstFreeSlot = slotIndex;
+	return true;
+}
+
+template <typename T>
+T* ObjectPool<T>::Get( PoolHandle handle )
+{
+	const Slot* pSlot{ GetSlot( handle ) };
+	return pSlot != nullptr ? &m_Objects[pSlot->index] : nullptr;
+}
+
+template <typename T>
+const T* ObjectPool<T>::Get( PoolHandle handle ) const
+{
+	const Slot* pSlot{ GetSlot( handle ) };
+	return pSlot != nullptr ? &m_Objects[pSlot->index] : nullptr;
+}
+
+template <typename T>
+bool ObjectPool<T>::IsAlive( PoolHandle handle ) const
+{
+	return GetSlot( handle ) != nullptr;
+}
+
+template <typename T>
+int ObjectPool<T>::GetSize( ) const
+{
+	return int( m_Objects.size( ) );
+}
+
+template <typename T>
+int ObjectPool<T>::GetCapacity( ) const
+{
+	return int( m_Slots.size( ) );
+}
+
+template <typename T>
+void ObjectPool<T>::Clear( )
+{
+	m_Objects.clear( );
+	m_SlotIndices.clear( );
+
+	// Chain all slots in the free list, keeping their generation so old handles stay stale
+	m_FirstFreeSlot = m_Slots.empty( ) ? m_NoSlot : 0;
+	for ( size_t idx{ 0 }; idx < m_Slots.size( ); ++idx )
+	{
+		Slot& slot{ m_Slots[idx] };
+		slot.index = idx + 1 < m_Slots.size( ) ? unsigned( idx + 1 ) : m_NoSlot;
+		slot.generation = PoolHandle::GetNextGeneration( slot.generation );
+	}
+}
+
+template <typename T>
+typename std::vector<T>::iterator ObjectPool<T>::begin( )
+{
+	return m_Objects.begin( );
+}
+
+template <typename T>
+typename std::vector<T>::iterator ObjectPool<T>::end( )
+{
+	return m_Objects.end( );
+}
+
+template <typename T>
+typename std::vector<T>::const_iterator ObjectPool<T>::begin( ) const
+{
+	return m_Objects.begin( );
+}
+
+template <typename T>
+typename std::vector<T>::const_iterator ObjectPool<T>::end( ) const
+{
+	return m_Objects.end( );
+}
+
+template <typename T>
+const typename ObjectPool<T>::Slot* ObjectPool<T>::GetSlot( PoolHandle handle ) const
+{
+	unsigned int slotIndex{ handle.GetIndex( ) };
+	if ( !handle.IsValid( ) || slotIndex >= m_Slots.size( ) )
+	{
+		return nullptr;
+	}
+	const Slot& slot{ m_Slots[slotIndex] };
+	if ( slot.generation != handle.GetGeneration( ) )
+	{
+		return nullptr;
+	}
+	return &slot;
+}
@@ -0,0 +1,347 @@
+#include "stdafx.h"
+#include "PerformanceHud.h"
+#include "ResourcePreload.h"
+#include "TextureBudget.h"
+#include "RenderBackend.h"
+#include "GlState.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+PerformanceHud::PerformanceHud( const Window& window, const std::string& fontPath, int ptSize )
+	:m_Window{ window }
+	,m_IsVisible{ false }
+	,m_FontPath{ fontPath }
+	,m_PtSize{ ptSize }
+	,m_AtlasId{ 0 }
+	,m_AtlasWidth{ 256.0f }
+	,m_AtlasHeight{ 256.0f }
+	,m_LineHeight{ float( ptSize ) }
+	,m_Baseline{ 0.0f }
+	,m_Glyphs{ }
+	,m_FrameMs{ }
+	,m_NewestFrame{ 0 }
+	,m_NrSummedFrames{ 0 }
+	,m_HudMs{ 0.0f }
+	,m_CpuUsage{ 0.0f }
+{
+	UpdateLines( );
+	m_Vertices.reserve( ( m_NrGraphFrames + 256 ) * 4 );
+}
+
+PerformanceHud::~PerformanceHud( )
+{
+	dae::FlushRenderBackend( );
+	dae::DeleteGlTexture( m_AtlasId );
+}
+
+void PerformanceHud::Toggle( )
+{
+	m_IsVisible = !m_IsVisible;
+}
+
+bool PerformanceHud::IsVisible( ) const
+{
+	return m_IsVisible;
+}
+
+void PerformanceHud::SetCpuUsage( float percent )
+{
+	m_CpuUsage = percent;
+}
+
+void PerformanceHud::AddFrame( const FrameTimes& times, const RenderStats& stats )
+{
+	m_NewestFrame = ( m_NewestFrame + 1 ) % m_NrGraphFrames;
+	m_FrameMs[m_NewestFrame] = times.frame;
+
+	m_SumTimes.frame += times.frame;
+	m_SumTimes.wait += times.wait;
+	m_SumTimes.events += times.events;
+	m_SumTimes.update += times.update;
+	m_SumTimes.draw += times.draw;
+	m_SumTimes.swap += times.swap;
+	m_SumTimes.pacingError = std::max( m_SumTimes.pacingError, times.pacingError );
+	m_SumStats.drawCalls += stats.drawCalls;
+	m_SumStats.vertices += stats.vertices;
+	m_SumStats.textureBinds += stats.textureBinds;
+	m_SumStats.stateChanges += stats.stateChanges;
+	m_SumStats.unsortedTextureBinds += stats.unsortedTextureBinds;
+	m_SumStats.elidedTextureBinds += stats.elidedTextureBinds;
+	m_SumStats.elidedStateChanges += stats.elidedStateChanges;
+	++m_NrSummedFrames;
+
+	// Refresh the text 4 times per second, so it stays readable
+	if ( m_SumTimes.frame >= 250.0f )
+	{
+		UpdateLines( );
+	}
+}
+
+void PerformanceHud::Draw( )
+{
+	if ( !m_IsVisible )
+	{
+		return;
+	}
+	const Uint64 start{ SDL_GetPerformanceCounter( ) };
+
+	// The font is only loaded when the HUD is shown for the first time
+	if ( m_AtlasId == 0 )
+	{
+		CreateAtlas( );
+	}
+
+	const Glyph white{ 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f };
+	const float margin{ 4.0f };
+	const float graphHeight{ 40.0f };
+	const float barWidth{ 2.0f };
+	const float width{ std::max( m_NrGraphFrames * barWidth, 250.0f ) + 2 * margin };
+	const float height{ graphHeight + m_Lines.size( ) * m_LineHeight + 3 * margin };
+	const float left{ 0.0f };
+	const float top{ m_Window.height };
+
+	m_Vertices.clear( );
+
+	// Background
+	AddQuad( left, top - height, width, height, white, Color4f{ 0.0f, 0.0f, 0.0f, 0.6f } );
+
+	// Frame time graph, full height is 2 frames at 60 Hz
+	const float fullScaleMs{ 1000.0f / 30.0f };
+	const float graphBottom{ top - height + margin };
+	for ( int idx{ 0 }; idx < m_NrGraphFrames; ++idx )
+	{
+		const float frameMs{ m_FrameMs[( m_NewestFrame + 1 + idx ) % m_NrGraphFrames] };
+		const Color4f color{ frameMs < 17.0f ? Color4f{ 0.2f, 0.9f, 0.2f, 1.0f } : frameMs < 34.0f ? Color4f{ 0.9f, 0.9f, 0.2f, 1.0f } : Color4f{ 0.9f, 0.2f, 0.2f, 1.0f } };
+		const float barHeight{ std::min( frameMs / fullScaleMs, 1.0f ) * graphHeight };
+		AddQuad( left + margin + idx * barWidth, graphBottom, barWidth, barHeight, white, color );
+	}
+	// 60 Hz frame budget
+	AddQuad( left + margin, graphBottom + graphHeight / 2, m_NrGraphFrames * barWidth, 1.0f, white, Color4f{ 1.0f, 1.0f, 1.0f, 0.5f } );
+
+	// Text
+	float lineBottom{ top - margin - m_LineHeight };
+	for ( const std::string& line : m_Lines )
+	{
+		AddText( line, left + margin, lineBottom, Color4f{ 1.0f, 1.0f, 1.0f, 1.0f } );
+		lineBottom -= m_LineHeight;
+	}
+
+	if ( dae::GetRenderBackend( ) == RenderBackend::shaders )
+	{
+		// Batched with the game's last draws, the shader backend always draws in window coordinates
+		dae::RenderTexturedVertices( m_AtlasId, GL_QUADS, m_Vertices.data( ), int( m_Vertices.size( ) ) );
+	}
+	else
+	{
+		// Send everything at once, in window coordinates whatever the game did to the modelview matrix
+		glPushMatrix( );
+		glLoadIdentity( );
+		dae::SetGlTexture( m_AtlasId );
+		dae::SetGlTexEnvMode( GL_MODULATE );
+		dae::SetGlCapability( GL_TEXTURE_2D, true );
+		dae::SetGlCapability( GL_ALPHA_TEST, false );
+		dae::SetGlCapability( GL_BLEND, true );
+		dae::SetGlBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+		glEnableClientState( GL_VERTEX_ARRAY );
+		glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+		glEnableClientState( GL_COLOR_ARRAY );
+		glVertexPointer( 2, GL_FLOAT, sizeof( RenderVertex ), &m_Vertices[0].x );
+		glTexCoordPointer( 2, GL_FLOAT, sizeof( RenderVertex ), &m_Vertices[0].u );
+		glColorPointer( 4, GL_FLOAT, sizeof( RenderVertex ), &m_Vertices[0].color );
+		glDrawArrays( GL_QUADS, 0, GLsizei( m_Vertices.size( ) ) );
+		glDisableClientState( GL_COLOR_ARRAY );
+		glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+		glDisableClientState( GL_VERTEX_ARRAY );
+		glPopMatrix( );
+		// The color array leaves the current color undefined
+		dae::ForgetGlColor( );
+	}
+
+	m_HudMs = ( SDL_GetPerformanceCounter( ) - start ) * 1000.0f / SDL_GetPerformanceFrequency( );
+}
+
+void PerformanceHud::CreateAtlas( )
+{
+	// White RGBA pixels, the alpha comes from the glyphs
+	std::vector<Uint8> pixels( size_t( m_AtlasWidth * m_AtlasHeight * 4 ), 255 );
+	for ( size_t idx{ 3 }; idx < pixels.size( ); idx += 4 )
+	{
+		pixels[idx] = 0;
+	}
+	// 2x2 opaque block for the untextured quads
+	for ( int y{ 0 }; y < 2; ++y )
+	{
+		for ( int x{ 0 }; x < 2; ++x )
+		{
+			pixels[( y * int( m_AtlasWidth ) + x ) * 4 + 3] = 255;
+		}
+	}
+
+	std::unique_lock<std::mutex> fontLock{ dae::GetFontMutex( ), std::defer_lock };
+	TTF_Font* pFont{ nullptr };
+	if ( dae::InitFonts( ) )
+	{
+		fontLock.lock( );
+		pFont = TTF_OpenFont( m_FontPath.c_str( ), m_PtSize );
+	}
+	if ( pFont == nullptr )
+	{
+		std::cerr << "PerformanceHud::CreateAtlas( ), error when calling TTF_OpenFont: " << TTF_GetError( ) << "\nThe HUD will have no text.\n";
+	}
+	else
+	{
+		m_LineHeight = float( TTF_FontHeight( pFont ) );
+		m_Baseline = float( TTF_FontHeight( pFont ) - TTF_FontAscent( pFont ) );
+
+		// Pack the glyphs in rows, starting after the white block
+		int penX{ 4 };
+		int penY{ 0 };
+		int rowHeight{ 4 };
+		const SDL_Color white{ 255, 255, 255, 255 };
+		for ( int idx{ 0 }; idx < m_NrGlyphs; ++idx )
+		{
+			const Uint16 character{ Uint16( m_FirstGlyph + idx ) };
+			SDL_Surface* pGlyph{ TTF_RenderGlyph_Blended( pFont, character, white ) };
+			dae::GlyphPlacement placement{ };
+			if ( !dae::GetGlyphPlacement( pFont, character, pGlyph, placement ) )
+			{
+				SDL_FreeSurface( pGlyph );
+				continue;
+			}
+			const SDL_Rect& source{ placement.source };
+			if ( penX + source.w > int( m_AtlasWidth ) )
+			{
+				penX = 0;
+				penY += rowHeight + 1;
+				rowHeight = 0;
+			}
+			if ( penY + source.h > int( m_AtlasHeight ) )
+			{
+				std::cerr << "PerformanceHud::CreateAtlas( ), font size " << m_PtSize << " is too large for the glyph atlas\n";
+				SDL_FreeSurface( pGlyph );
+				break;
+			}
+
+			// Copy the alpha of the glyph's pixels in the 32 bit glyph surface
+			if ( source.w > 0 && source.h > 0 )
+			{
+				SDL_LockSurface( pGlyph );
+				const SDL_PixelFormat* pFormat{ pGlyph->format };
+				for ( int y{ 0 }; y < source.h; ++y )
+				{
+					const Uint32* pRow{ reinterpret_cast<const Uint32*>( static_cast<const Uint8*>( pGlyph->pixels ) + ( source.y + y ) * pGlyph->pitch ) + source.x };
+					for ( int x{ 0 }; x < source.w; ++x )
+					{
+						pixels[( ( penY + y ) * int( m_AtlasWidth ) + penX + x ) * 4 + 3] = Uint8( ( pRow[x] & pFormat->Amask ) >> pFormat->Ashift );
+					}
+				}
+				SDL_UnlockSurface( pGlyph );
+			}
+
+			m_Glyphs[idx] = Glyph{ float( penX ), float( penY ), float( source.w ), float( source.h ),
+				float( placement.left ), float( placement.top ), float( placement.advance ) };
+			penX += source.w + 1;
+			rowHeight = std::max( rowHeight, source.h );
+			SDL_FreeSurface( pGlyph );
+		}
+		TTF_CloseFont( pFont );
+		fontLock.unlock( );
+	}
+
+	glGenTextures( 1, &m_AtlasId );
+	dae::SetGlTexture( m_AtlasId );
+	glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, int( m_AtlasWidth ), int( m_AtlasHeight ), 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data( ) );
+	// Glyphs are drawn at their original size
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+}
+
+void PerformanceHud::UpdateLines( )
+{
+	const float nrFrames{ float( std::max( m_NrSummedFrames, 1 ) ) };
+	const float frameMs{ m_SumTimes.frame / nrFrames };
+
+	std::stringstream buffer;
+	buffer << std::fixed << std::setprecision( 2 );
+	m_Lines.clear( );
+
+	buffer << "fps " << ( frameMs > 0.0f ? 1000.0f / frameMs : 0.0f ) << "   frame " << frameMs << " ms";
+	m_Lines.push_back( buffer.str( ) );
+	buffer.str( "" );
+	buffer << "events " << m_SumTimes.events / nrFrames << "  update " << m_SumTimes.update / nrFrames
+		<< "  draw " << m_SumTimes.draw / nrFrames << "  swap " << m_SumTimes.swap / nrFrames;
+	m_Lines.push_back( buffer.str( ) );
+	buffer.str( "" );
+	buffer << "wait " << m_SumTimes.wait / nrFrames << "  max pacing error " << m_SumTimes.pacingError << "  cpu " << std::setprecision( 0 ) << m_CpuUsage << '%' << std::setprecision( 2 );
+	m_Lines.push_back( buffer.str( ) );
+	buffer.str( "" );
+	buffer << "draw calls " << int( m_SumStats.drawCalls / nrFrames ) << "   vertices " << int( m_SumStats.vertices / nrFrames );
+	m_Lines.push_back( buffer.str( ) );
+	buffer.str( "" );
+	buffer << "texture binds " << int( m_SumStats.textureBinds / nrFrames );
+	if ( m_SumStats.unsortedTextureBinds > 0 )
+	{
+		buffer << " (" << int( m_SumStats.unsortedTextureBinds / nrFrames ) << " unsorted)";
+	}
+	buffer << "   state changes " << int( m_SumStats.stateChanges / nrFrames );
+	m_Lines.push_back( buffer.str( ) );
+	buffer.str( "" );
+	buffer << "elided binds " << int( m_SumStats.elidedTextureBinds / nrFrames ) << "   elided state changes " << int( m_SumStats.elidedStateChanges / nrFrames );
+	m_Lines.push_back( buffer.str( ) );
+	buffer.str( "" );
+	const TextureMemoryStats& textures{ dae::GetTextureMemoryStats( ) };
+	if ( dae::IsTextureBudgetOn( ) )
+	{
+		buffer << "textures " << textures.nrResident << '/' << textures.nrTextures << " resident   "
+			<< std::setprecision( 1 ) << textures.residentBytes / 1048576.0f << " of " << textures.budget / 1048576.0f << " MB" << std::setprecision( 2 );
+		m_Lines.push_back( buffer.str( ) );
+		buffer.str( "" );
+	}
+	if ( textures.savedBytes > 0 )
+	{
+		buffer << "textures " << std::setprecision( 1 ) << textures.videoBytes / 1048576.0f << " MB, compression saves "
+			<< textures.savedBytes / 1048576.0f << " MB" << std::setprecision( 2 );
+		m_Lines.push_back( buffer.str( ) );
+		buffer.str( "" );
+	}
+	buffer << "hud " << std::setprecision( 3 ) << m_HudMs << " ms";
+	m_Lines.push_back( buffer.str( ) );
+
+	m_SumTimes = FrameTimes{ };
+	m_SumStats = RenderStats{ };
+	m_NrSummedFrames = 0;
+}
+
+void PerformanceHud::AddQuad( float left, float bottom, float width, float height, const Glyph& glyph, const Color4f& color )
+{
+	// The atlas rows are stored top to bottom
+	const float texLeft{ glyph.left / m_AtlasWidth };
+	const float texRight{ ( glyph.left + glyph.width ) / m_AtlasWidth };
+	const float texTop{ glyph.top / m_AtlasHeight };
+	const float texBottom{ ( glyph.top + glyph.height ) / m_AtlasHeight };
+
+	m_Vertices.push_back( RenderVertex{ left, bottom, texLeft, texBottom, color } );
+	m_Vertices.push_back( RenderVertex{ left + width, bottom, texRight, texBottom, color } );
+	m_Vertices.push_back( RenderVertex{ left + width, bottom + height, texRight, texTop, color } );
+	m_Vertices.push_back( RenderVertex{ left, bottom + height, texLeft, texTop, color } );
+}
+
+void PerformanceHud::AddText( const std::string& text, float left, float bottom, const Color4f& color )
+{
+	for ( char character : text )
+	{
+		const int idx{ int( character ) - m_FirstGlyph };
+		if ( idx < 0 || idx >= m_NrGlyphs )
+		{
+			continue;
+		}
+		const Glyph& glyph{ m_Glyphs[idx] };
+		if ( glyph.width > 0.0f )
+		{
+			AddQuad( left + glyph.offsetLeft, bottom + m_Baseline + glyph.offsetTop - glyph.height, glyph.width, glyph.height, glyph, color );
+		}
+		left += glyph.advance;
+	}
+}
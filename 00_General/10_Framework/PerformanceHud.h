@@ -0,0 +1,78 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "RenderStats.h"
+#include "RenderBackend.h"
+
+// On-screen overlay with a frame time graph, the duration of each phase of the frame and the renderer counters.
+// Core toggles it with F1 and draws it after Game::Draw.
+// The text is drawn with a glyph atlas made when it is first shown, and the whole overlay
+// is sent to OpenGL in one glDrawArrays call, so it barely influences the numbers it shows.
+class PerformanceHud
+{
+public:
+	explicit PerformanceHud( const Window& window, const std::string& fontPath = "Resources/DIN-Light.otf", int ptSize = 12 );
+	PerformanceHud( const PerformanceHud& other ) = delete;
+	PerformanceHud& operator=( const PerformanceHud& other ) = delete;
+	~PerformanceHud( );
+
+	void Toggle( );
+	bool IsVisible( ) const;
+
+	// Called by Core after each frame, with the counters of that frame
+	void AddFrame( const FrameTimes& times, const RenderStats& stats );
+	void SetCpuUsage( float percent );
+	void Draw( );
+
+private:
+	struct Glyph
+	{
+		// Position in the atlas, in pixels, 0 width for a space
+		float left;
+		float top;
+		float width;
+		float height;
+		// Top-left of the glyph relative to the pen position on the baseline, and the pen advance
+		float offsetLeft;
+		float offsetTop;
+		float advance;
+	};
+	static const int m_NrGraphFrames{ 120 };
+	static const int m_FirstGlyph{ 32 };
+	static const int m_NrGlyphs{ 95 };
+
+	// DATA MEMBERS
+	Window m_Window;
+	bool m_IsVisible;
+	std::string m_FontPath;
+	int m_PtSize;
+
+	// Glyph atlas, created on the first Draw. Its top-left texel is white for the untextured parts
+	GLuint m_AtlasId;
+	float m_AtlasWidth;
+	float m_AtlasHeight;
+	float m_LineHeight;
+	// Height of the baseline above the bottom of a line
+	float m_Baseline;
+	Glyph m_Glyphs[m_NrGlyphs];
+
+	// Frame time graph
+	float m_FrameMs[m_NrGraphFrames];
+	int m_NewestFrame;
+
+	// Averages shown as text, refreshed a few times per second
+	FrameTimes m_SumTimes;
+	RenderStats m_SumStats;
+	int m_NrSummedFrames;
+	float m_HudMs;
+	float m_CpuUsage;
+	std::vector<std::string> m_Lines;
+
+	std::vector<RenderVertex> m_Vertices;
+
+	// FUNCTIONS
+	void CreateAtlas( );
+	void UpdateLines( );
+	void AddQuad( float left, float bottom, float width, float height, const Glyph& glyph, const Color4f& color );
+	void AddText( const std::string& text, float left, float bottom, const Color4f& color );
+};
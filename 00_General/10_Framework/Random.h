@@ -0,0 +1,246 @@
+#pragma once
+#include <atomic>
+
+// Random number generator: xoshiro256** (Blackman and Vigna).
+// 32 bytes of state, a few cycles per number, and the same sequence on every platform for the same seed,
+// unlike rand( ) whose low bits are poor (rand( ) % 101) and which isn't thread safe.
+//
+// Jump( ) advances the state by 2^128 numbers, so streams made by jumping never overlap:
+// give each thread or each batch of parallel work its own stream for reproducible results.
+//		Random random{ seed };						// one generator
+//		Random random{ Random::ForStream( seed, 3 ) };	// the 4th independent stream of a seed
+//		dae::GetRandom( ).GetInt( 1, 6 );				// this thread's stream, see dae::SeedRandom
+class Random
+{
+public:
+	explicit Random( Uint64 seed = 0 );
+	// Stream streamIndex of a seed: the generator of the seed, jumped streamIndex times
+	static Random ForStream( Uint64 seed, int streamIndex );
+
+	void Seed( Uint64 seed );
+	void Jump( );
+
+	Uint64 Next( );
+	Uint32 NextUint32( );
+	// In [min, max], both included
+	int GetInt( int min, int max );
+	// In [0, 1[ and [min, max[
+	float GetFloat( );
+	float GetFloat( float min, float max );
+	bool GetBool( );
+
+	// Fill arrays, e.g. when spawning many objects at once. FillFloats gets two values out of each Next( )
+	void FillInts( int* pValues, int nrValues, int min, int max );
+	void FillFloats( float* pValues, int nrValues, float min, float max );
+
+private:
+	// DATA MEMBERS
+	Uint64 m_State[4];
+
+	// FUNCTIONS
+	static Uint64 RotateLeft( Uint64 value, int nrBits );
+	static float ToFloat( Uint32 bits24 );
+	Uint32 GetBounded( Uint32 range );
+};
+
+namespace dae
+{
+	// Seeds the streams of the threads that haven't used GetRandom yet.
+	// Each thread gets its own stream, numbered in the order the threads first call GetRandom.
+	void SeedRandom( Uint64 seed );
+	Random& GetRandom( );
+}
+
+inline Random::Random( Uint64 seed )
+	:m_State{ }
+{
+	Seed( seed );
+}
+
+inline Random Random::ForStream( Uint64 seed, int streamIndex )
+{
+	Random random{ seed };
+	for ( int idx{ 0 }; idx < streamIndex; ++idx )
+	{
+		random.Jump( );
+	}
+	return random;
+}
+
+inline void Random::Seed( Uint64 seed )
+{
+	// splitmix64 spreads the seed over the state, so similar seeds give unrelated sequences
+	for ( Uint64& state : m_State )
+	{
+		seed += 0x9e3779b97f4a7c15;
+		Uint64 value{ seed };
+		value = ( value ^ ( value >> 30 ) ) * 0xbf58476d1ce4e5b9;
+		value = ( value ^ ( value >> 27 ) ) * 0x94d049bb133111eb;
+		state = value ^ ( value >> 31 );
+	}
+}
+
+inline void Random::Jump( )
+{
+	const Uint64 jump[]{ 0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c };
+	Uint64 state[4]{ };
+	for ( Uint64 word : jump )
+	{
+		for ( int bit{ 0 }; bit < 64; ++bit )
+		{
+			if ( word & ( Uint64( 1 ) << bit ) )
+			{
+				for ( int idx{ 0 }; idx < 4; ++idx )
+				{
+					state[idx] ^= m_State[idx];
+				}
+			}
+			Next( );
+		}
+	}
+	for ( int idx{ 0 }; idx < 4; ++idx )
+	{
+		m_State[idx] = state[idx];
+	}
+}
+
+inline Uint64 Random::Next( )
+{
+	const Uint64 result{ RotateLeft( m_State[1] * 5, 7 ) * 9 };
+	const Uint64 shifted{ m_State[1] << 17 };
+	m_State[2] ^= m_State[0];
+	m_State[3] ^= m_State[1];
+	m_State[1] ^= m_State[2];
+	m_State[0] ^= m_State[3];
+	m_State[2] ^= shifted;
+	m_State[3] = RotateLeft( m_State[3], 45 );
+	return result;
+}
+
+inline Uint32 Random::NextUint32( )
+{
+	// The high bits are the best ones
+	return Uint32( Next( ) >> 32 );
+}
+
+inline int Random::GetInt( int min, int max )
+{
+	if ( max <= min )
+	{
+		return min;
+	}
+	const Uint32 range{ Uint32( Sint64( max ) - min + 1 ) };
+	// A range of 2^32 wraps to 0: every value is fine
+	return int( Sint64( min ) + ( range == 0 ? NextUint32( ) : GetBounded( range ) ) );
+}
+
+inline float Random::GetFloat( )
+{
+	return ToFloat( Uint32( Next( ) >> 40 ) );
+}
+
+inline float Random::GetFloat( float min, float max )
+{
+	return min + GetFloat( ) * ( max - min );
+}
+
+inline bool Random::GetBool( )
+{
+	return ( Next( ) >> 63 ) != 0;
+}
+
+inline void Random::FillInts( int* pValues, int nrValues, int min, int max )
+{
+	if ( max <= min )
+	{
+		for ( int idx{ 0 }; idx < nrValues; ++idx )
+		{
+			pValues[idx] = min;
+		}
+		return;
+	}
+	const Uint32 range{ Uint32( Sint64( max ) - min + 1 ) };
+	for ( int idx{ 0 }; idx < nrValues; ++idx )
+	{
+		pValues[idx] = int( Sint64( min ) + ( range == 0 ? NextUint32( ) : GetBounded( range ) ) );
+	}
+}
+
+inline void Random::FillFloats( float* pValues, int nrValues, float min, float max )
+{
+	// Two 24 bit floats from each 64 bit number
+	const float scale{ max - min };
+	int idx{ 0 };
+	for ( ; idx + 1 < nrValues; idx += 2 )
+	{
+		const Uint64 bits{ Next( ) };
+		pValues[idx] = min + ToFloat( Uint32( bits >> 40 ) ) * scale;
+		pValues[idx + 1] = min + ToFloat( Uint32( bits >> 8 ) & 0xffffff ) * scale;
+	}
+	if ( idx < nrValues )
+	{
+		pValues[idx] = GetFloat( min, max );
+	}
+}
+
+inline Uint64 Random::RotateLeft( Uint64 value, int nrBits )
+{
+	return ( value << nrBits ) | ( value >> ( 64 - nrBits ) );
+}
+
+inline float Random::ToFloat( Uint32 bits24 )
+{
+	// 24 bits fill the float mantissa exactly, so every value is equally likely
+	return bits24 * ( 1.0f / 16777216.0f );
+}
+
+inline Uint32 Random::GetBounded( Uint32 range )
+{
+	// Lemire's multiply and shift, rejecting the few values that would make the result biased.
+	// Only needs a division for the rare numbers close to the rejection threshold.
+	Uint64 product{ Uint64( NextUint32( ) ) * range };
+	Uint32 low{ Uint32( product ) };
+	if ( low < range )
+	{
+		const Uint32 threshold{ Uint32( 0u - range ) % range };
+		while ( low < threshold )
+		{
+			product = Uint64( NextUint32( ) ) * range;
+			low = Uint32( product );
+		}
+	}
+	return Uint32( product >> 32 );
+}
+
+namespace dae
+{
+	namespace detail
+	{
+		inline std::atomic<Uint64>& GetRandomSeed( )
+		{
+			static std::atomic<Uint64> seed{ 0 };
+			return seed;
+		}
+		inline std::atomic<int>& GetNextRandomStream( )
+		{
+			static std::atomic<int> streamIndex{ 0 };
+			return streamIndex;
+		}
+	}
+
+	inline void SeedRandom( Uint64 seed )
+	{
+		// Create the generator of the calling thread first, creating it takes a stream too
+		Random& random{ GetRandom( ) };
+		detail::GetRandomSeed( ) = seed;
+		detail::GetNextRandomStream( ) = 0;
+		// The calling thread starts over with stream 0 of the new seed
+		random = Random::ForStream( seed, detail::GetNextRandomStream( )++ );
+	}
+
+	inline Random& GetRandom( )
+	{
+		thread_local Random random{ Random::ForStream( detail::GetRandomSeed( ), detail::GetNextRandomStream( )++ ) };
+		return random;
+	}
+}
@@ -0,0 +1,824 @@
+#include "stdafx.h"
+#include "RenderBackend.h"
+#include "RenderStats.h"
+#include "RenderQueue.h"
+#include "GlState.h"
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace dae
+{
+	namespace
+	{
+		// OpenGL 1.5 and later functions, loaded for the shader backend. The buffer functions also for the fixed function pipeline
+		struct GlFunctions
+		{
+			PFNGLGENVERTEXARRAYSPROC genVertexArrays;
+			PFNGLBINDVERTEXARRAYPROC bindVertexArray;
+			PFNGLDELETEVERTEXARRAYSPROC deleteVertexArrays;
+			PFNGLGENBUFFERSPROC genBuffers;
+			PFNGLBINDBUFFERPROC bindBuffer;
+			PFNGLBUFFERDATAPROC bufferData;
+			PFNGLMAPBUFFERRANGEPROC mapBufferRange;
+			PFNGLUNMAPBUFFERPROC unmapBuffer;
+			PFNGLDELETEBUFFERSPROC deleteBuffers;
+			PFNGLENABLEVERTEXATTRIBARRAYPROC enableVertexAttribArray;
+			PFNGLVERTEXATTRIBPOINTERPROC vertexAttribPointer;
+			PFNGLCREATESHADERPROC createShader;
+			PFNGLSHADERSOURCEPROC shaderSource;
+			PFNGLCOMPILESHADERPROC compileShader;
+			PFNGLGETSHADERIVPROC getShaderiv;
+			PFNGLGETSHADERINFOLOGPROC getShaderInfoLog;
+			PFNGLDELETESHADERPROC deleteShader;
+			PFNGLCREATEPROGRAMPROC createProgram;
+			PFNGLATTACHSHADERPROC attachShader;
+			PFNGLLINKPROGRAMPROC linkProgram;
+			PFNGLGETPROGRAMIVPROC getProgramiv;
+			PFNGLGETPROGRAMINFOLOGPROC getProgramInfoLog;
+			PFNGLDELETEPROGRAMPROC deleteProgram;
+			PFNGLUSEPROGRAMPROC useProgram;
+			PFNGLGETUNIFORMLOCATIONPROC getUniformLocation;
+			PFNGLUNIFORM1IPROC uniform1i;
+			PFNGLUNIFORM1FPROC uniform1f;
+			PFNGLUNIFORM4FPROC uniform4f;
+			PFNGLGENERATEMIPMAPPROC generateMipmap;
+			PFNGLGETSTRINGIPROC getStringi;
+		};
+
+		// What the vertex buffer holds: 20 bytes
+		struct GpuVertex
+		{
+			float x;
+			float y;
+			float u;
+			float v;
+			Uint8 color[4];
+		};
+
+		// Everything that needs a new glDrawArrays when it changes
+		struct Batch
+		{
+			// GL_TRIANGLES, GL_LINES or GL_POINTS
+			GLenum primitive;
+			// 0: colored geometry
+			GLuint textureId;
+			// Line width or point size
+			float size;
+			float alphaTest;
+			bool isPremultiplied;
+
+			bool operator==( const Batch& other ) const
+			{
+				return primitive == other.primitive && textureId == other.textureId && size == other.size
+					&& alphaTest == other.alphaTest && isPremultiplied == other.isPremultiplied;
+			}
+		};
+
+		struct Program
+		{
+			GLuint id;
+			GLint transformLocation;
+			GLint alphaTestLocation;
+		};
+
+		const char* g_pVertexShader
+		{
+			"#version 330 core\n"
+			"layout( location = 0 ) in vec2 a_Position;\n"
+			"layout( location = 1 ) in vec2 a_TexCoord;\n"
+			"layout( location = 2 ) in vec4 a_Color;\n"
+			// Scale and offset from window coordinates (y up) to clip space
+			"uniform vec4 u_Transform;\n"
+			"out vec2 v_TexCoord;\n"
+			"out vec4 v_Color;\n"
+			"void main( )\n"
+			"{\n"
+			"	gl_Position = vec4( a_Position * u_Transform.xy + u_Transform.zw, 0.0, 1.0 );\n"
+			"	v_TexCoord = a_TexCoord;\n"
+			"	v_Color = a_Color;\n"
+			"}\n"
+		};
+		const char* g_pColoredFragmentShader
+		{
+			"#version 330 core\n"
+			"in vec2 v_TexCoord;\n"
+			"in vec4 v_Color;\n"
+			"out vec4 o_Color;\n"
+			"void main( )\n"
+			"{\n"
+			"	o_Color = v_Color;\n"
+			"}\n"
+		};
+		const char* g_pTexturedFragmentShader
+		{
+			"#version 330 core\n"
+			"in vec2 v_TexCoord;\n"
+			"in vec4 v_Color;\n"
+			"uniform sampler2D u_Texture;\n"
+			"uniform float u_AlphaTest;\n"
+			"out vec4 o_Color;\n"
+			"void main( )\n"
+			"{\n"
+			"	vec4 color = texture( u_Texture, v_TexCoord ) * v_Color;\n"
+			"	if ( u_AlphaTest > 0.0 )\n"
+			"	{\n"
+			"		if ( color.a < u_AlphaTest )\n"
+			"		{\n"
+			"			discard;\n"
+			"		}\n"
+			"		color.a = 1.0;\n"
+			"	}\n"
+			"	o_Color = color;\n"
+			"}\n"
+		};
+
+		// Most vertices in one batch, AppendVertices flushes before a primitive would go beyond it. 1.25 MB
+		const size_t g_MaxBatchVertices{ 65536 };
+		// The batches are appended to the buffer until it is full, 5 MB
+		const size_t g_BufferVertices{ 4 * g_MaxBatchVertices };
+
+		RenderBackend g_Backend{ RenderBackend::fixedFunction };
+		// The thread with the OpenGL context
+		std::thread::id g_RenderThreadId{ };
+		GlFunctions g_Gl{ };
+		GLuint g_VertexArrayId{ };
+		GLuint g_BufferId{ };
+		size_t g_BufferOffset{ };
+		// Points into the static vertex buffer being drawn
+		GLuint g_StaticVertexArrayId{ };
+		bool g_HasBufferFunctions{ false };
+		Program g_ColoredProgram{ };
+		Program g_TexturedProgram{ };
+		std::vector<GpuVertex> g_Vertices;
+		// Colored vertices for the render queue
+		std::vector<RenderVertex> g_QueuedVertices;
+		// Static vertices on their way to video memory
+		std::vector<GpuVertex> g_StaticVertices;
+		Batch g_Batch{ GL_TRIANGLES, 0, 0.0f, 0.0f, false };
+		// The render color, also packed like the vertices
+		Color4f g_RenderColor{ 1.0f, 1.0f, 1.0f, 1.0f };
+		Uint8 g_Color[4]{ 255, 255, 255, 255 };
+		float g_LineWidth{ 1.0f };
+		float g_PointSize{ 1.0f };
+		// OpenGL state as the previous flush left it
+		GLuint g_UsedProgramId{ };
+		float g_UsedAlphaTest{ -1.0f };
+		// Space separated, with a space at both ends
+		std::string g_Extensions;
+
+		template<typename Function>
+		bool LoadFunction( Function& function, const char* pName )
+		{
+			function = reinterpret_cast<Function>( SDL_GL_GetProcAddress( pName ) );
+			if ( function == nullptr )
+			{
+				std::cerr << "dae::StartRenderBackend( ), missing OpenGL function " << pName << '\n';
+				return false;
+			}
+			return true;
+		}
+
+		bool LoadBufferFunctions( )
+		{
+			g_HasBufferFunctions = LoadFunction( g_Gl.genBuffers, "glGenBuffers" )
+				&& LoadFunction( g_Gl.bindBuffer, "glBindBuffer" )
+				&& LoadFunction( g_Gl.bufferData, "glBufferData" )
+				&& LoadFunction( g_Gl.deleteBuffers, "glDeleteBuffers" );
+			return g_HasBufferFunctions;
+		}
+
+		bool LoadFunctions( )
+		{
+			return LoadBufferFunctions( )
+				&& LoadFunction( g_Gl.genVertexArrays, "glGenVertexArrays" )
+				&& LoadFunction( g_Gl.bindVertexArray, "glBindVertexArray" )
+				&& LoadFunction( g_Gl.deleteVertexArrays, "glDeleteVertexArrays" )
+				&& LoadFunction( g_Gl.mapBufferRange, "glMapBufferRange" )
+				&& LoadFunction( g_Gl.unmapBuffer, "glUnmapBuffer" )
+				&& LoadFunction( g_Gl.enableVertexAttribArray, "glEnableVertexAttribArray" )
+				&& LoadFunction( g_Gl.vertexAttribPointer, "glVertexAttribPointer" )
+				&& LoadFunction( g_Gl.createShader, "glCreateShader" )
+				&& LoadFunction( g_Gl.shaderSource, "glShaderSource" )
+				&& LoadFunction( g_Gl.compileShader, "glCompileShader" )
+				&& LoadFunction( g_Gl.getShaderiv, "glGetShaderiv" )
+				&& LoadFunction( g_Gl.getShaderInfoLog, "glGetShaderInfoLog" )
+				&& LoadFunction( g_Gl.deleteShader, "glDeleteShader" )
+				&& LoadFunction( g_Gl.createProgram, "glCreateProgram" )
+				&& LoadFunction( g_Gl.attachShader, "glAttachShader" )
+				&& LoadFunction( g_Gl.linkProgram, "glLinkProgram" )
+				&& LoadFunction( g_Gl.getProgramiv, "glGetProgramiv" )
+				&& LoadFunction( g_Gl.getProgramInfoLog, "glGetProgramInfoLog" )
+				&& LoadFunction( g_Gl.deleteProgram, "glDeleteProgram" )
+				&& LoadFunction( g_Gl.useProgram, "glUseProgram" )
+				&& LoadFunction( g_Gl.getUniformLocation, "glGetUniformLocation" )
+				&& LoadFunction( g_Gl.uniform1i, "glUniform1i" )
+				&& LoadFunction( g_Gl.uniform1f, "glUniform1f" )
+				&& LoadFunction( g_Gl.uniform4f, "glUniform4f" )
+				&& LoadFunction( g_Gl.generateMipmap, "glGenerateMipmap" )
+				&& LoadFunction( g_Gl.getStringi, "glGetStringi" );
+		}
+
+		GLuint CompileShader( GLenum type, const char* pSource )
+		{
+			const GLuint shaderId{ g_Gl.createShader( type ) };
+			g_Gl.shaderSource( shaderId, 1, &pSource, nullptr );
+			g_Gl.compileShader( shaderId );
+			GLint isCompiled{ };
+			g_Gl.getShaderiv( shaderId, GL_COMPILE_STATUS, &isCompiled );
+			if ( !isCompiled )
+			{
+				char log[1024]{ };
+				g_Gl.getShaderInfoLog( shaderId, sizeof( log ), nullptr, log );
+				std::cerr << "dae::StartRenderBackend( ), error compiling a shader:\n" << log << '\n';
+				g_Gl.deleteShader( shaderId );
+				return 0;
+			}
+			return shaderId;
+		}
+
+		bool CreateProgram( const char* pFragmentShader, float width, float height, Program& program )
+		{
+			const GLuint vertexShaderId{ CompileShader( GL_VERTEX_SHADER, g_pVertexShader ) };
+			const GLuint fragmentShaderId{ CompileShader( GL_FRAGMENT_SHADER, pFragmentShader ) };
+			if ( vertexShaderId == 0 || fragmentShaderId == 0 )
+			{
+				g_Gl.deleteShader( vertexShaderId );
+				g_Gl.deleteShader( fragmentShaderId );
+				return false;
+			}
+			program.id = g_Gl.createProgram( );
+			g_Gl.attachShader( program.id, vertexShaderId );
+			g_Gl.attachShader( program.id, fragmentShaderId );
+			g_Gl.linkProgram( program.id );
+			// Deleted with the program
+			g_Gl.deleteShader( vertexShaderId );
+			g_Gl.deleteShader( fragmentShaderId );
+			GLint isLinked{ };
+			g_Gl.getProgramiv( program.id, GL_LINK_STATUS, &isLinked );
+			if ( !isLinked )
+			{
+				char log[1024]{ };
+				g_Gl.getProgramInfoLog( program.id, sizeof( log ), nullptr, log );
+				std::cerr << "dae::StartRenderBackend( ), error linking a shader program:\n" << log << '\n';
+				g_Gl.deleteProgram( program.id );
+				program.id = 0;
+				return false;
+			}
+
+			// The same orthographic projection as gluOrtho2D( 0, width, 0, height )
+			g_Gl.useProgram( program.id );
+			program.transformLocation = g_Gl.getUniformLocation( program.id, "u_Transform" );
+			program.alphaTestLocation = g_Gl.getUniformLocation( program.id, "u_AlphaTest" );
+			g_Gl.uniform4f( program.transformLocation, 2.0f / width, 2.0f / height, -1.0f, -1.0f );
+			const GLint textureLocation{ g_Gl.getUniformLocation( program.id, "u_Texture" ) };
+			if ( textureLocation >= 0 )
+			{
+				g_Gl.uniform1i( textureLocation, 0 );
+			}
+			return true;
+		}
+
+		void PackColor( const Color4f& color, Uint8* pPacked )
+		{
+			pPacked[0] = Uint8( std::clamp( color.r, 0.0f, 1.0f ) * 255.0f + 0.5f );
+			pPacked[1] = Uint8( std::clamp( color.g, 0.0f, 1.0f ) * 255.0f + 0.5f );
+			pPacked[2] = Uint8( std::clamp( color.b, 0.0f, 1.0f ) * 255.0f + 0.5f );
+			pPacked[3] = Uint8( std::clamp( color.a, 0.0f, 1.0f ) * 255.0f + 0.5f );
+		}
+
+		GLenum GetPrimitive( GLenum mode )
+		{
+			switch ( mode )
+			{
+			case GL_POINTS:
+				return GL_POINTS;
+			case GL_LINES:
+			case GL_LINE_STRIP:
+			case GL_LINE_LOOP:
+				return GL_LINES;
+			default:
+				return GL_TRIANGLES;
+			}
+		}
+
+		// Attributes 0 to 2 read the GpuVertex array in the bound buffer
+		void SetVertexAttributes( )
+		{
+			g_Gl.enableVertexAttribArray( 0 );
+			g_Gl.enableVertexAttribArray( 1 );
+			g_Gl.enableVertexAttribArray( 2 );
+			g_Gl.vertexAttribPointer( 0, 2, GL_FLOAT, GL_FALSE, sizeof( GpuVertex ), reinterpret_cast<const void*>( offsetof( GpuVertex, x ) ) );
+			g_Gl.vertexAttribPointer( 1, 2, GL_FLOAT, GL_FALSE, sizeof( GpuVertex ), reinterpret_cast<const void*>( offsetof( GpuVertex, u ) ) );
+			g_Gl.vertexAttribPointer( 2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof( GpuVertex ), reinterpret_cast<const void*>( offsetof( GpuVertex, color ) ) );
+		}
+
+		// The program, texture and blending of a batch
+		void UseShaderState( const Batch& batch )
+		{
+			const Program& program{ batch.textureId != 0 ? g_TexturedProgram : g_ColoredProgram };
+			if ( program.id != g_UsedProgramId )
+			{
+				g_Gl.useProgram( program.id );
+				g_UsedProgramId = program.id;
+				CountStateChange( );
+			}
+			if ( batch.textureId != 0 )
+			{
+				SetGlTexture( batch.textureId );
+				if ( batch.alphaTest != g_UsedAlphaTest )
+				{
+					g_Gl.uniform1f( program.alphaTestLocation, batch.alphaTest );
+					g_UsedAlphaTest = batch.alphaTest;
+					CountStateChange( );
+				}
+			}
+			SetGlBlendFunc( batch.isPremultiplied ? GL_ONE : GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+			if ( batch.primitive == GL_LINES )
+			{
+				SetGlLineWidth( batch.size );
+			}
+			else if ( batch.primitive == GL_POINTS )
+			{
+				SetGlPointSize( batch.size );
+			}
+		}
+
+		// Fills the bound buffer
+		void SpecifyStaticVertices( const RenderVertex* pVertices, int nrVertices )
+		{
+			g_StaticVertices.clear( );
+			for ( int idx{ 0 }; idx < nrVertices; ++idx )
+			{
+				const RenderVertex& vertex{ pVertices[idx] };
+				GpuVertex gpuVertex{ vertex.x, vertex.y, vertex.u, vertex.v, { } };
+				PackColor( vertex.color, gpuVertex.color );
+				g_StaticVertices.push_back( gpuVertex );
+			}
+			g_Gl.bufferData( GL_ARRAY_BUFFER, GLsizeiptr( g_StaticVertices.size( ) * sizeof( GpuVertex ) ), g_StaticVertices.data( ), GL_STATIC_DRAW );
+		}
+
+		// Flushes when the batch changes
+		void BeginBatch( const Batch& batch )
+		{
+			if ( !( batch == g_Batch ) )
+			{
+				FlushRenderBackend( );
+				g_Batch = batch;
+			}
+		}
+
+		// Before each primitive, so a draw of any size is split at primitive boundaries into batches that fit
+		void MakeRoom( size_t nrVertices )
+		{
+			if ( g_Vertices.size( ) + nrVertices > g_MaxBatchVertices )
+			{
+				FlushRenderBackend( );
+			}
+		}
+
+		// Appends the vertices of any glBegin mode as a list of points, lines or triangles.
+		// vertex( idx ) returns the GpuVertex of the idx-th input vertex
+		template<typename GetVertex>
+		void AppendVertices( GLenum mode, int nrVertices, GetVertex vertex )
+		{
+			switch ( mode )
+			{
+			case GL_POINTS:
+			case GL_LINES:
+			case GL_TRIANGLES:
+			{
+				const int multiple{ mode == GL_POINTS ? 1 : mode == GL_LINES ? 2 : 3 };
+				for ( int idx{ 0 }; idx < nrVertices - nrVertices % multiple; idx += multiple )
+				{
+					MakeRoom( size_t( multiple ) );
+					for ( int corner{ 0 }; corner < multiple; ++corner )
+					{
+						g_Vertices.push_back( vertex( idx + corner ) );
+					}
+				}
+				break;
+			}
+			case GL_LINE_STRIP:
+			case GL_LINE_LOOP:
+				for ( int idx{ 1 }; idx < nrVertices; ++idx )
+				{
+					MakeRoom( 2 );
+					g_Vertices.push_back( vertex( idx - 1 ) );
+					g_Vertices.push_back( vertex( idx ) );
+				}
+				if ( mode == GL_LINE_LOOP && nrVertices > 2 )
+				{
+					MakeRoom( 2 );
+					g_Vertices.push_back( vertex( nrVertices - 1 ) );
+					g_Vertices.push_back( vertex( 0 ) );
+				}
+				break;
+			case GL_TRIANGLE_STRIP:
+				for ( int idx{ 2 }; idx < nrVertices; ++idx )
+				{
+					MakeRoom( 3 );
+					g_Vertices.push_back( vertex( idx - 2 ) );
+					g_Vertices.push_back( vertex( idx - 1 ) );
+					g_Vertices.push_back( vertex( idx ) );
+				}
+				break;
+			case GL_QUADS:
+				for ( int idx{ 0 }; idx + 3 < nrVertices; idx += 4 )
+				{
+					MakeRoom( 6 );
+					g_Vertices.push_back( vertex( idx ) );
+					g_Vertices.push_back( vertex( idx + 1 ) );
+					g_Vertices.push_back( vertex( idx + 2 ) );
+					g_Vertices.push_back( vertex( idx ) );
+					g_Vertices.push_back( vertex( idx + 2 ) );
+					g_Vertices.push_back( vertex( idx + 3 ) );
+				}
+				break;
+			default:
+				// GL_TRIANGLE_FAN and convex GL_POLYGON
+				for ( int idx{ 2 }; idx < nrVertices; ++idx )
+				{
+					MakeRoom( 3 );
+					g_Vertices.push_back( vertex( 0 ) );
+					g_Vertices.push_back( vertex( idx - 1 ) );
+					g_Vertices.push_back( vertex( idx ) );
+				}
+				break;
+			}
+		}
+
+		// The state a fixed function draw needs, whatever the previous draw left
+		void UseFixedFunctionState( GLuint textureId, float alphaTest, bool isPremultiplied )
+		{
+			if ( textureId != 0 )
+			{
+				SetGlTexture( textureId );
+				SetGlTexEnvMode( GL_MODULATE );
+			}
+			SetGlCapability( GL_TEXTURE_2D, textureId != 0 );
+			if ( alphaTest > 0.0f )
+			{
+				SetGlCapability( GL_BLEND, false );
+				SetGlCapability( GL_ALPHA_TEST, true );
+				SetGlAlphaFunc( GL_GEQUAL, alphaTest );
+			}
+			else
+			{
+				SetGlCapability( GL_ALPHA_TEST, false );
+				SetGlCapability( GL_BLEND, true );
+				SetGlBlendFunc( isPremultiplied ? GL_ONE : GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+			}
+		}
+
+		void RenderFixedFunction( GLuint textureId, GLenum mode, const RenderVertex* pVertices, int nrVertices, float alphaTest, bool isPremultiplied )
+		{
+			UseFixedFunctionState( textureId, alphaTest, isPremultiplied );
+			glBegin( mode );
+			{
+				for ( int idx{ 0 }; idx < nrVertices; ++idx )
+				{
+					const RenderVertex& vertex{ pVertices[idx] };
+					SetGlColor( vertex.color );
+					glTexCoord2f( vertex.u, vertex.v );
+					glVertex2f( vertex.x, vertex.y );
+				}
+			}
+			glEnd( );
+			CountDrawCall( nrVertices );
+		}
+
+		void BuildExtensions( )
+		{
+			g_Extensions = " ";
+			if ( g_Backend == RenderBackend::shaders )
+			{
+				// A core profile has no GL_EXTENSIONS string
+				GLint nrExtensions{ };
+				glGetIntegerv( GL_NUM_EXTENSIONS, &nrExtensions );
+				for ( GLint idx{ 0 }; idx < nrExtensions; ++idx )
+				{
+					g_Extensions += reinterpret_cast<const char*>( g_Gl.getStringi( GL_EXTENSIONS, GLuint( idx ) ) );
+					g_Extensions += ' ';
+				}
+			}
+			else
+			{
+				const GLubyte* pExtensions{ glGetString( GL_EXTENSIONS ) };
+				if ( pExtensions != nullptr )
+				{
+					g_Extensions += reinterpret_cast<const char*>( pExtensions );
+					g_Extensions += ' ';
+				}
+			}
+		}
+	}
+
+	bool StartRenderBackend( RenderBackend backend, float width, float height )
+	{
+		g_Backend = backend;
+		g_RenderThreadId = std::this_thread::get_id( );
+		g_Extensions.clear( );
+		ResetGlState( );
+		if ( backend == RenderBackend::fixedFunction )
+		{
+			// Core in OpenGL 2.1, only static vertices need them
+			LoadBufferFunctions( );
+			return true;
+		}
+
+		if ( !LoadFunctions( )
+			|| !CreateProgram( g_pColoredFragmentShader, width, height, g_ColoredProgram )
+			|| !CreateProgram( g_pTexturedFragmentShader, width, height, g_TexturedProgram ) )
+		{
+			StopRenderBackend( );
+			return false;
+		}
+		g_UsedProgramId = g_TexturedProgram.id;
+
+		// One vertex array and one buffer for everything, see FlushRenderBackend
+		g_Gl.genVertexArrays( 1, &g_VertexArrayId );
+		g_Gl.bindVertexArray( g_VertexArrayId );
+		g_Gl.genBuffers( 1, &g_BufferId );
+		g_Gl.bindBuffer( GL_ARRAY_BUFFER, g_BufferId );
+		g_Gl.bufferData( GL_ARRAY_BUFFER, GLsizeiptr( g_BufferVertices * sizeof( GpuVertex ) ), nullptr, GL_STREAM_DRAW );
+		g_BufferOffset = 0;
+		SetVertexAttributes( );
+		g_Vertices.reserve( g_MaxBatchVertices );
+		g_Gl.genVertexArrays( 1, &g_StaticVertexArrayId );
+		return true;
+	}
+
+	void StopRenderBackend( )
+	{
+		if ( g_Backend == RenderBackend::shaders && g_Gl.deleteProgram != nullptr )
+		{
+			g_Vertices.clear( );
+			g_Gl.deleteProgram( g_ColoredProgram.id );
+			g_Gl.deleteProgram( g_TexturedProgram.id );
+			g_Gl.deleteBuffers( 1, &g_BufferId );
+			g_Gl.deleteVertexArrays( 1, &g_VertexArrayId );
+			g_Gl.deleteVertexArrays( 1, &g_StaticVertexArrayId );
+		}
+		g_ColoredProgram = Program{ };
+		g_TexturedProgram = Program{ };
+		g_BufferId = 0;
+		g_VertexArrayId = 0;
+		g_StaticVertexArrayId = 0;
+		g_HasBufferFunctions = false;
+		g_Backend = RenderBackend::fixedFunction;
+		g_Extensions.clear( );
+	}
+
+	RenderBackend GetRenderBackend( )
+	{
+		return g_Backend;
+	}
+
+	void FlushRenderBackend( )
+	{
+		if ( g_Vertices.empty( ) )
+		{
+			return;
+		}
+
+		UseShaderState( g_Batch );
+
+		// Each batch goes after the previous ones, unsynchronized: the driver doesn't wait for the draws that still read
+		// the buffer. When it is full, a new buffer replaces it and the old one lives on until those draws are done
+		g_Gl.bindVertexArray( g_VertexArrayId );
+		g_Gl.bindBuffer( GL_ARRAY_BUFFER, g_BufferId );
+		if ( g_BufferOffset + g_Vertices.size( ) > g_BufferVertices )
+		{
+			g_Gl.bufferData( GL_ARRAY_BUFFER, GLsizeiptr( g_BufferVertices * sizeof( GpuVertex ) ), nullptr, GL_STREAM_DRAW );
+			g_BufferOffset = 0;
+		}
+		const GLsizeiptr bytes{ GLsizeiptr( g_Vertices.size( ) * sizeof( GpuVertex ) ) };
+		void* pBuffer{ g_Gl.mapBufferRange( GL_ARRAY_BUFFER, GLintptr( g_BufferOffset * sizeof( GpuVertex ) ), bytes,
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT ) };
+		if ( pBuffer == nullptr )
+		{
+			std::cerr << "dae::FlushRenderBackend( ), glMapBufferRange failed with error " << glGetError( ) << ", " << g_Vertices.size( ) << " vertices not drawn\n";
+			g_Vertices.clear( );
+			return;
+		}
+		std::memcpy( pBuffer, g_Vertices.data( ), size_t( bytes ) );
+		g_Gl.unmapBuffer( GL_ARRAY_BUFFER );
+		glDrawArrays( g_Batch.primitive, GLint( g_BufferOffset ), GLsizei( g_Vertices.size( ) ) );
+		g_BufferOffset += g_Vertices.size( );
+		CountDrawCall( int( g_Vertices.size( ) ) );
+		g_Vertices.clear( );
+	}
+
+	void CheckRenderThread( const char* pCaller )
+	{
+#if defined(DEBUG) | defined(_DEBUG)
+		if ( g_RenderThreadId != std::thread::id{ } && std::this_thread::get_id( ) != g_RenderThreadId )
+		{
+			std::cerr << pCaller << ", called on a thread without the OpenGL context: create and destroy OpenGL resources on the render thread\n";
+		}
+#endif
+	}
+
+	int GetMaxBatchVertices( GLenum mode )
+	{
+		switch ( mode )
+		{
+		case GL_QUADS:
+			// 6 vertices each
+			return int( g_MaxBatchVertices / 6 * 4 );
+		case GL_TRIANGLES:
+			return int( g_MaxBatchVertices / 3 * 3 );
+		default:
+			return int( g_MaxBatchVertices );
+		}
+	}
+
+	void SetRenderColor( const Color4f& color )
+	{
+		g_RenderColor = color;
+		PackColor( color, g_Color );
+		if ( g_Backend == RenderBackend::fixedFunction && !IsRenderQueueRecording( ) )
+		{
+			SetGlColor( color );
+		}
+	}
+
+	void SetRenderLineWidth( float width )
+	{
+		g_LineWidth = width;
+		if ( g_Backend == RenderBackend::fixedFunction && !IsRenderQueueRecording( ) )
+		{
+			SetGlLineWidth( width );
+		}
+	}
+
+	void SetRenderPointSize( float size )
+	{
+		g_PointSize = size;
+		if ( g_Backend == RenderBackend::fixedFunction && !IsRenderQueueRecording( ) )
+		{
+			SetGlPointSize( size );
+		}
+	}
+
+	void RenderVertices( GLenum mode, const Point2f* pVertices, int nrVertices )
+	{
+		if ( IsRenderQueueRecording( ) )
+		{
+			g_QueuedVertices.clear( );
+			for ( int idx{ 0 }; idx < nrVertices; ++idx )
+			{
+				g_QueuedVertices.push_back( RenderVertex{ pVertices[idx].x, pVertices[idx].y, 0.0f, 0.0f, g_RenderColor } );
+			}
+			const GLenum primitive{ GetPrimitive( mode ) };
+			const float size{ primitive == GL_LINES ? g_LineWidth : primitive == GL_POINTS ? g_PointSize : 0.0f };
+			QueueDraw( 0, mode, g_QueuedVertices.data( ), nrVertices, size, 0.0f, false );
+			return;
+		}
+		if ( g_Backend == RenderBackend::fixedFunction )
+		{
+			UseFixedFunctionState( 0, 0.0f, false );
+			// A textured draw leaves the color of its last vertex
+			SetGlColor( g_RenderColor );
+			glBegin( mode );
+			{
+				for ( int idx{ 0 }; idx < nrVertices; ++idx )
+				{
+					glVertex2f( pVertices[idx].x, pVertices[idx].y );
+				}
+			}
+			glEnd( );
+			CountDrawCall( nrVertices );
+			return;
+		}
+
+		const GLenum primitive{ GetPrimitive( mode ) };
+		const float size{ primitive == GL_LINES ? g_LineWidth : primitive == GL_POINTS ? g_PointSize : 0.0f };
+		BeginBatch( Batch{ primitive, 0, size, 0.0f, false } );
+		AppendVertices( mode, nrVertices, [pVertices]( int idx )
+			{
+				return GpuVertex{ pVertices[idx].x, pVertices[idx].y, 0.0f, 0.0f, { g_Color[0], g_Color[1], g_Color[2], g_Color[3] } };
+			} );
+	}
+
+	void RenderTexturedVertices( GLuint textureId, GLenum mode, const RenderVertex* pVertices, int nrVertices, float alphaTest, bool isPremultiplied )
+	{
+		const GLenum primitive{ GetPrimitive( mode ) };
+		const float size{ primitive == GL_LINES ? g_LineWidth : primitive == GL_POINTS ? g_PointSize : 0.0f };
+		if ( IsRenderQueueRecording( ) )
+		{
+			QueueDraw( textureId, mode, pVertices, nrVertices, size, alphaTest, isPremultiplied );
+			return;
+		}
+		if ( g_Backend == RenderBackend::fixedFunction )
+		{
+			RenderFixedFunction( textureId, mode, pVertices, nrVertices, alphaTest, isPremultiplied );
+			return;
+		}
+
+		BeginBatch( Batch{ primitive, textureId, size, alphaTest, isPremultiplied } );
+		AppendVertices( mode, nrVertices, [pVertices]( int idx )
+			{
+				const RenderVertex& vertex{ pVertices[idx] };
+				GpuVertex result{ vertex.x, vertex.y, vertex.u, vertex.v, { } };
+				PackColor( vertex.color, result.color );
+				return result;
+			} );
+	}
+
+	GLuint CreateStaticVertices( const RenderVertex* pVertices, int nrVertices )
+	{
+		if ( !g_HasBufferFunctions )
+		{
+			std::cerr << "dae::CreateStaticVertices( ), OpenGL has no vertex buffers\n";
+			return 0;
+		}
+		GLuint bufferId{ };
+		g_Gl.genBuffers( 1, &bufferId );
+		UpdateStaticVertices( bufferId, pVertices, nrVertices );
+		return bufferId;
+	}
+
+	void UpdateStaticVertices( GLuint bufferId, const RenderVertex* pVertices, int nrVertices )
+	{
+		if ( bufferId == 0 )
+		{
+			return;
+		}
+		// The streamed vertices are bound again by the next flush
+		g_Gl.bindBuffer( GL_ARRAY_BUFFER, bufferId );
+		SpecifyStaticVertices( pVertices, nrVertices );
+		g_Gl.bindBuffer( GL_ARRAY_BUFFER, 0 );
+	}
+
+	void DeleteStaticVertices( GLuint bufferId )
+	{
+		if ( bufferId != 0 && g_HasBufferFunctions )
+		{
+			g_Gl.deleteBuffers( 1, &bufferId );
+		}
+	}
+
+	void RenderStaticVertices( GLuint bufferId, int nrVertices, GLuint textureId, float alphaTest, bool isPremultiplied )
+	{
+		if ( bufferId == 0 || nrVertices <= 0 )
+		{
+			return;
+		}
+		if ( IsRenderQueueRecording( ) )
+		{
+			QueueStaticDraw( bufferId, nrVertices, textureId, alphaTest, isPremultiplied );
+			return;
+		}
+
+		if ( g_Backend == RenderBackend::fixedFunction )
+		{
+			UseFixedFunctionState( textureId, alphaTest, isPremultiplied );
+			g_Gl.bindBuffer( GL_ARRAY_BUFFER, bufferId );
+			glEnableClientState( GL_VERTEX_ARRAY );
+			glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+			glEnableClientState( GL_COLOR_ARRAY );
+			glVertexPointer( 2, GL_FLOAT, sizeof( GpuVertex ), reinterpret_cast<const void*>( offsetof( GpuVertex, x ) ) );
+			glTexCoordPointer( 2, GL_FLOAT, sizeof( GpuVertex ), reinterpret_cast<const void*>( offsetof( GpuVertex, u ) ) );
+			glColorPointer( 4, GL_UNSIGNED_BYTE, sizeof( GpuVertex ), reinterpret_cast<const void*>( offsetof( GpuVertex, color ) ) );
+			glDrawArrays( GL_TRIANGLES, 0, nrVertices );
+			glDisableClientState( GL_COLOR_ARRAY );
+			glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+			glDisableClientState( GL_VERTEX_ARRAY );
+			g_Gl.bindBuffer( GL_ARRAY_BUFFER, 0 );
+			// The color array leaves the current color undefined
+			ForgetGlColor( );
+			CountDrawCall( nrVertices );
+			return;
+		}
+
+		// Drawn in call order with the batched vertices
+		FlushRenderBackend( );
+		UseShaderState( Batch{ GL_TRIANGLES, textureId, 0.0f, alphaTest, isPremultiplied } );
+		g_Gl.bindVertexArray( g_StaticVertexArrayId );
+		g_Gl.bindBuffer( GL_ARRAY_BUFFER, bufferId );
+		SetVertexAttributes( );
+		glDrawArrays( GL_TRIANGLES, 0, nrVertices );
+		CountDrawCall( nrVertices );
+	}
+
+	void GenerateMipmaps( )
+	{
+		if ( g_Backend == RenderBackend::shaders )
+		{
+			g_Gl.generateMipmap( GL_TEXTURE_2D );
+		}
+	}
+
+	bool IsGlExtensionSupported( const std::string& name )
+	{
+		if ( g_Extensions.empty( ) )
+		{
+			BuildExtensions( );
+		}
+		return g_Extensions.find( ' ' + name + ' ' ) != std::string::npos;
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <string>
+
+// How the framework draws: the OpenGL 2.1 fixed function pipeline (the default),
+// or shaders on an OpenGL 3.3 core profile context, chosen at start-up with DAE_RENDERER=gl33.
+//
+// The shader backend has no immediate mode: the dae:: draw functions, Texture, SdfFont and the HUD append their
+// vertices to one buffer, as triangle, line or point lists. The buffer is sent in one glDrawArrays each time the
+// texture, primitive type, line width or point size changes, and at the end of the frame.
+// Fixed function calls in game code (glBegin, glColor, glTranslatef...) don't work on the shader backend,
+// draw with the dae:: functions and Texture instead. Direct OpenGL calls that draw should call FlushRenderBackend first.
+enum class RenderBackend
+{
+	fixedFunction,
+	shaders
+};
+
+// Vertex of textured geometry, the texture is multiplied by the color
+struct RenderVertex
+{
+	float x;
+	float y;
+	float u;
+	float v;
+	Color4f color;
+};
+
+namespace dae
+{
+	// Called by Core after creating the context, with the window size.
+	// Returns false when the shader backend can't start, Core then falls back to the fixed function pipeline
+	bool StartRenderBackend( RenderBackend backend, float width, float height );
+	void StopRenderBackend( );
+	RenderBackend GetRenderBackend( );
+	// Draws the batched vertices. Called by Core before the swap, and before deleting a texture that may be in the batch
+	void FlushRenderBackend( );
+	// Debug builds: reports on std::cerr when called on another thread than StartRenderBackend's, which has the OpenGL context.
+	// Called where OpenGL resources are created and destroyed, see Game.h
+	void CheckRenderThread( const char* pCaller );
+	// Most vertices of a list mode (GL_QUADS, GL_TRIANGLES, GL_LINES, GL_POINTS) that fit in one batch of the shader backend.
+	// Larger draws are split, the render queue merges draws up to this
+	int GetMaxBatchVertices( GLenum mode );
+
+	// Used by the functions in utils.h, Texture and SdfFont. While the render queue records, see RenderQueue.h,
+	// the draws are queued instead
+	void SetRenderColor( const Color4f& color );
+	void SetRenderLineWidth( float width );
+	void SetRenderPointSize( float size );
+	// Any glBegin mode, GL_POLYGON must be convex. Uses the render color
+	void RenderVertices( GLenum mode, const Point2f* pVertices, int nrVertices );
+	// textureId 0 draws colored vertices. The texture is multiplied by the vertex colors.
+	// alphaTest > 0 discards the fragments with a lower alpha and draws the others without blending.
+	// isPremultiplied blends with GL_ONE, GL_ONE_MINUS_SRC_ALPHA
+	void RenderTexturedVertices( GLuint textureId, GLenum mode, const RenderVertex* pVertices, int nrVertices, float alphaTest = 0.0f, bool isPremultiplied = false );
+
+	// Vertices kept in video memory, for geometry that rarely changes such as the chunks of a Tilemap: drawing them
+	// sends nothing but the draw call. GL_TRIANGLES lists
+	GLuint CreateStaticVertices( const RenderVertex* pVertices, int nrVertices );
+	// Replaces the vertices, their number may change
+	void UpdateStaticVertices( GLuint bufferId, const RenderVertex* pVertices, int nrVertices );
+	void DeleteStaticVertices( GLuint bufferId );
+	// The first nrVertices, drawn like RenderTexturedVertices draws GL_TRIANGLES
+	void RenderStaticVertices( GLuint bufferId, int nrVertices, GLuint textureId, float alphaTest = 0.0f, bool isPremultiplied = false );
+
+	// Differences between the contexts
+	// Mipmaps of the bound texture. The fixed function pipeline generates them itself, see GL_GENERATE_MIPMAP
+	void GenerateMipmaps( );
+	bool IsGlExtensionSupported( const std::string& name );
+}
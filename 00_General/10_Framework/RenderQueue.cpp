@@ -0,0 +1,269 @@
+#include "stdafx.h"
+#include "RenderQueue.h"
+#include "RenderStats.h"
+#include <algorithm>
+#include <vector>
+
+namespace dae
+{
+	namespace
+	{
+		struct QueuedDraw
+		{
+			GLuint textureId;
+			GLenum mode;
+			// In g_Vertices
+			int firstVertex;
+			int nrVertices;
+			float size;
+			float alphaTest;
+			bool isPremultiplied;
+			// Static vertices instead of vertices in g_Vertices, 0 for none
+			GLuint bufferId;
+		};
+
+		struct SortItem
+		{
+			Uint64 key;
+			Uint32 drawIdx;
+		};
+
+		bool g_IsOn{ false };
+		bool g_IsRecording{ false };
+		int g_Layer{ 0 };
+		int g_Depth{ 0 };
+		// Texture of the previous draw in call order, to count the binds an unsorted frame needs
+		GLuint g_LastTextureId{ 0 };
+		std::vector<QueuedDraw> g_Draws;
+		std::vector<RenderVertex> g_Vertices;
+		std::vector<SortItem> g_Items;
+		std::vector<SortItem> g_SortBuffer;
+		// Vertices of consecutive draws that are submitted together
+		std::vector<RenderVertex> g_Merged;
+
+		enum class BlendMode
+		{
+			straight = 0,
+			premultiplied = 1,
+			alphaTest = 2
+		};
+
+		enum class Primitive
+		{
+			triangles = 0,
+			lines = 1,
+			points = 2
+		};
+
+		Primitive GetPrimitive( GLenum mode )
+		{
+			switch ( mode )
+			{
+			case GL_LINES:
+			case GL_LINE_STRIP:
+			case GL_LINE_LOOP:
+				return Primitive::lines;
+			case GL_POINTS:
+				return Primitive::points;
+			default:
+				return Primitive::triangles;
+			}
+		}
+
+		Uint64 GetSortKey( const QueuedDraw& draw )
+		{
+			const BlendMode blend{ draw.alphaTest > 0.0f ? BlendMode::alphaTest : draw.isPremultiplied ? BlendMode::premultiplied : BlendMode::straight };
+			return Uint64( g_Layer ) << 56
+				| Uint64( g_Depth ) << 40
+				| Uint64( blend ) << 38
+				| Uint64( draw.textureId & 0x3fffff ) << 16
+				| Uint64( GetPrimitive( draw.mode ) ) << 14
+				// Line width or point size in quarter pixels
+				| Uint64( std::clamp( int( draw.size * 4.0f + 0.5f ), 0, 0x3fff ) );
+		}
+
+		// Least significant byte first, 8 passes at most: each pass is stable, so the whole sort is.
+		// A pass is skipped when all keys have the same byte, usually the depth and the high texture bits
+		void RadixSort( )
+		{
+			const size_t nrItems{ g_Items.size( ) };
+			size_t counts[8][256]{ };
+			for ( const SortItem& item : g_Items )
+			{
+				for ( int byte{ 0 }; byte < 8; ++byte )
+				{
+					++counts[byte][( item.key >> ( byte * 8 ) ) & 0xff];
+				}
+			}
+
+			g_SortBuffer.resize( nrItems );
+			for ( int byte{ 0 }; byte < 8; ++byte )
+			{
+				size_t* pCounts{ counts[byte] };
+				if ( pCounts[( g_Items[0].key >> ( byte * 8 ) ) & 0xff] == nrItems )
+				{
+					continue;
+				}
+				size_t offset{ 0 };
+				for ( int digit{ 0 }; digit < 256; ++digit )
+				{
+					const size_t count{ pCounts[digit] };
+					pCounts[digit] = offset;
+					offset += count;
+				}
+				for ( const SortItem& item : g_Items )
+				{
+					g_SortBuffer[pCounts[( item.key >> ( byte * 8 ) ) & 0xff]++] = item;
+				}
+				g_Items.swap( g_SortBuffer );
+			}
+		}
+
+		// Modes of which two draws can be sent as one
+		bool IsList( GLenum mode )
+		{
+			return mode == GL_QUADS || mode == GL_TRIANGLES || mode == GL_LINES || mode == GL_POINTS;
+		}
+
+		// nrMerged: the vertices merged with first so far, first's included. Stops at the batch size of the backend
+		bool CanMerge( const QueuedDraw& first, const QueuedDraw& next, size_t nrMerged )
+		{
+			return first.bufferId == 0 && next.bufferId == 0 && IsList( first.mode ) && next.mode == first.mode
+				&& next.textureId == first.textureId && next.size == first.size && next.alphaTest == first.alphaTest && next.isPremultiplied == first.isPremultiplied
+				&& nrMerged + size_t( next.nrVertices ) <= size_t( GetMaxBatchVertices( first.mode ) );
+		}
+	}
+
+	void SetRenderQueueOn( bool isOn )
+	{
+		g_IsOn = isOn;
+	}
+
+	bool IsRenderQueueOn( )
+	{
+		return g_IsOn;
+	}
+
+	void BeginRenderQueue( )
+	{
+		g_IsRecording = g_IsOn;
+		g_Layer = 0;
+		g_Depth = 0;
+		g_LastTextureId = 0;
+	}
+
+	void EndRenderQueue( )
+	{
+		SubmitRenderQueue( );
+		g_IsRecording = false;
+	}
+
+	void SubmitRenderQueue( )
+	{
+		if ( g_Draws.empty( ) )
+		{
+			return;
+		}
+		RadixSort( );
+
+		// The backend draws instead of recording again
+		const bool wasRecording{ g_IsRecording };
+		g_IsRecording = false;
+		float lineWidth{ -1.0f };
+		float pointSize{ -1.0f };
+		size_t itemIdx{ 0 };
+		while ( itemIdx < g_Items.size( ) )
+		{
+			const QueuedDraw& first{ g_Draws[g_Items[itemIdx].drawIdx] };
+			if ( first.bufferId != 0 )
+			{
+				RenderStaticVertices( first.bufferId, first.nrVertices, first.textureId, first.alphaTest, first.isPremultiplied );
+				++itemIdx;
+				continue;
+			}
+			const RenderVertex* pVertices{ &g_Vertices[first.firstVertex] };
+			int nrVertices{ first.nrVertices };
+			++itemIdx;
+			if ( itemIdx < g_Items.size( ) && CanMerge( first, g_Draws[g_Items[itemIdx].drawIdx], size_t( nrVertices ) ) )
+			{
+				g_Merged.assign( pVertices, pVertices + nrVertices );
+				while ( itemIdx < g_Items.size( ) && CanMerge( first, g_Draws[g_Items[itemIdx].drawIdx], g_Merged.size( ) ) )
+				{
+					const QueuedDraw& next{ g_Draws[g_Items[itemIdx].drawIdx] };
+					g_Merged.insert( g_Merged.end( ), g_Vertices.begin( ) + next.firstVertex, g_Vertices.begin( ) + next.firstVertex + next.nrVertices );
+					++itemIdx;
+				}
+				pVertices = g_Merged.data( );
+				nrVertices = int( g_Merged.size( ) );
+			}
+
+			const Primitive primitive{ GetPrimitive( first.mode ) };
+			if ( primitive == Primitive::lines && first.size != lineWidth )
+			{
+				SetRenderLineWidth( first.size );
+				lineWidth = first.size;
+			}
+			else if ( primitive == Primitive::points && first.size != pointSize )
+			{
+				SetRenderPointSize( first.size );
+				pointSize = first.size;
+			}
+			RenderTexturedVertices( first.textureId, first.mode, pVertices, nrVertices, first.alphaTest, first.isPremultiplied );
+		}
+		g_IsRecording = wasRecording;
+
+		g_Draws.clear( );
+		g_Vertices.clear( );
+		g_Items.clear( );
+	}
+
+	void SetDrawLayer( int layer )
+	{
+		g_Layer = std::clamp( layer, 0, 255 );
+	}
+
+	void SetDrawDepth( int depth )
+	{
+		g_Depth = std::clamp( depth, 0, 0xffff );
+	}
+
+	bool IsRenderQueueRecording( )
+	{
+		return g_IsRecording;
+	}
+
+	void QueueDraw( GLuint textureId, GLenum mode, const RenderVertex* pVertices, int nrVertices, float size, float alphaTest, bool isPremultiplied )
+	{
+		if ( nrVertices <= 0 )
+		{
+			return;
+		}
+		if ( textureId != 0 && textureId != g_LastTextureId )
+		{
+			CountUnsortedTextureBind( );
+			g_LastTextureId = textureId;
+		}
+
+		const QueuedDraw draw{ textureId, mode, int( g_Vertices.size( ) ), nrVertices, size, alphaTest, isPremultiplied, 0 };
+		g_Items.push_back( SortItem{ GetSortKey( draw ), Uint32( g_Draws.size( ) ) } );
+		g_Draws.push_back( draw );
+		g_Vertices.insert( g_Vertices.end( ), pVertices, pVertices + nrVertices );
+	}
+
+	void QueueStaticDraw( GLuint bufferId, int nrVertices, GLuint textureId, float alphaTest, bool isPremultiplied )
+	{
+		if ( nrVertices <= 0 )
+		{
+			return;
+		}
+		if ( textureId != 0 && textureId != g_LastTextureId )
+		{
+			CountUnsortedTextureBind( );
+			g_LastTextureId = textureId;
+		}
+
+		const QueuedDraw draw{ textureId, GL_TRIANGLES, 0, nrVertices, 0.0f, alphaTest, isPremultiplied, bufferId };
+		g_Items.push_back( SortItem{ GetSortKey( draw ), Uint32( g_Draws.size( ) ) } );
+		g_Draws.push_back( draw );
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "RenderBackend.h"
+
+// Defers the draws of a frame and sorts them, so draws that use the same OpenGL state go together: each texture is
+// bound once per layer instead of once per sprite. Switched on with DAE_RENDER_QUEUE=1, Core then records
+// everything Game::Draw draws with Texture, SdfFont and the dae:: functions, and submits it when Game::Draw returns.
+//
+// Every draw gets a 64 bit sort key, from the most significant bits down:
+//		layer		8 bits	SetDrawLayer, layers are drawn in increasing order
+//		depth		16 bits	SetDrawDepth, lower depth first
+//		blend mode	2 bits	straight alpha, premultiplied alpha, alpha tested
+//		texture		22 bits	0 for colored geometry
+//		primitive	16 bits	triangles, lines or points, and the line width or point size
+// The sort is stable, so draws with the same key keep the order they were made in.
+// Consecutive draws of a list mode with the same state are sent as one call, of at most GetMaxBatchVertices vertices.
+// Within a layer and depth, draws with different textures don't keep their order: put what must be drawn over
+// something else at a higher depth, or in a higher layer. Direct OpenGL calls in Game::Draw (glClear...) happen
+// before the queued draws.
+namespace dae
+{
+	// Core, from DAE_RENDER_QUEUE
+	void SetRenderQueueOn( bool isOn );
+	bool IsRenderQueueOn( );
+	// Core, around Game::Draw: starts recording when the queue is on, at layer 0 and depth 0
+	void BeginRenderQueue( );
+	// Submits and stops recording
+	void EndRenderQueue( );
+	// Sorts and draws what was recorded so far, recording goes on. Texture calls it before deleting its texture
+	void SubmitRenderQueue( );
+
+	// For the draws that follow: layer 0 to 255, depth 0 to 65535
+	void SetDrawLayer( int layer );
+	void SetDrawDepth( int depth );
+
+	// Used by RenderBackend
+	bool IsRenderQueueRecording( );
+	// size is the line width or point size
+	void QueueDraw( GLuint textureId, GLenum mode, const RenderVertex* pVertices, int nrVertices, float size, float alphaTest, bool isPremultiplied );
+	// Static vertices, see RenderStaticVertices: only the buffer id is kept
+	void QueueStaticDraw( GLuint bufferId, int nrVertices, GLuint textureId, float alphaTest, bool isPremultiplied );
+}
@@ -0,0 +1,70 @@
+#include "stdafx.h"
+#include "RenderStats.h"
+
+RenderStats::RenderStats( )
+	:drawCalls{ 0 }
+	,vertices{ 0 }
+	,textureBinds{ 0 }
+	,stateChanges{ 0 }
+	,elidedTextureBinds{ 0 }
+	,elidedStateChanges{ 0 }
+	,unsortedTextureBinds{ 0 }
+{
+}
+
+FrameTimes::FrameTimes( )
+	:frame{ 0.0f }
+	,wait{ 0.0f }
+	,events{ 0.0f }
+	,update{ 0.0f }
+	,draw{ 0.0f }
+	,swap{ 0.0f }
+	,pacingError{ 0.0f }
+{
+}
+
+namespace dae
+{
+	static RenderStats g_RenderStats{ };
+
+	const RenderStats& GetRenderStats( )
+	{
+		return g_RenderStats;
+	}
+
+	void ResetRenderStats( )
+	{
+		g_RenderStats = RenderStats{ };
+	}
+
+	void CountDrawCall( int nrVertices )
+	{
+		++g_RenderStats.drawCalls;
+		g_RenderStats.vertices += nrVertices;
+	}
+
+	void CountTextureBind( )
+	{
+		++g_RenderStats.textureBinds;
+	}
+
+	void CountStateChange( int nrChanges )
+	{
+		g_RenderStats.stateChanges += nrChanges;
+	}
+
+	void CountUnsortedTextureBind( )
+	{
+		++g_RenderStats.unsortedTextureBinds;
+	}
+
+	void CountElidedTextureBind( )
+	{
+		++g_RenderStats.elidedTextureBinds;
+	}
+
+	void CountElidedStateChange( )
+	{
+		++g_RenderStats.elidedStateChanges;
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+// Counters of what the renderer sends to OpenGL during one frame
+struct RenderStats
+{
+	RenderStats( );
+
+	// glBegin/glEnd blocks
+	int drawCalls;
+	int vertices;
+	int textureBinds;
+	// glColor, glEnable, glLineWidth, ... calls
+	int stateChanges;
+	// Binds and state changes that were skipped because OpenGL already had that state, see GlState.h
+	int elidedTextureBinds;
+	int elidedStateChanges;
+	// With the render queue: the binds the textured draws need in the order the game makes them, see RenderQueue.h
+	int unsortedTextureBinds;
+};
+
+// Durations of the phases of one frame, in milliseconds
+struct FrameTimes
+{
+	FrameTimes( );
+
+	float frame;
+	// Time the frame pacer waited before the frame started
+	float wait;
+	float events;
+	float update;
+	float draw;
+	float swap;
+	// How late the frame started compared to the pacer's target
+	float pacingError;
+};
+
+namespace dae
+{
+	// Counters of the frame being drawn, Core resets them before Game::Draw
+	const RenderStats& GetRenderStats( );
+	void ResetRenderStats( );
+
+	// Called by every function that sends something to OpenGL
+	void CountDrawCall( int nrVertices );
+	void CountTextureBind( );
+	void CountStateChange( int nrChanges = 1 );
+	void CountUnsortedTextureBind( );
+	void CountElidedTextureBind( );
+	void CountElidedStateChange( );
+}
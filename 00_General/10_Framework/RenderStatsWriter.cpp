@@ -0,0 +1,57 @@
+#include "stdafx.h"
+#include "RenderStatsWriter.h"
+#include <iostream>
+
+RenderStatsWriter::RenderStatsWriter( const std::string& path )
+	:m_File{ path }
+	,m_Format{ Format::csv }
+	,m_FrameNr{ 0 }
+{
+	if ( !m_File )
+	{
+		std::cerr << "RenderStatsWriter::RenderStatsWriter( ), unable to open " << path << '\n';
+		return;
+	}
+
+	const std::string jsonExtension{ ".jsonl" };
+	if ( path.size( ) >= jsonExtension.size( ) && path.compare( path.size( ) - jsonExtension.size( ), jsonExtension.size( ), jsonExtension ) == 0 )
+	{
+		m_Format = Format::jsonLines;
+	}
+	else
+	{
+		m_File << "frame,ms,waitMs,eventsMs,updateMs,drawMs,swapMs,pacingErrorMs,drawCalls,vertices,textureBinds,stateChanges,unsortedTextureBinds,elidedTextureBinds,elidedStateChanges\n";
+	}
+}
+
+bool RenderStatsWriter::IsOpenOk( ) const
+{
+	return bool( m_File );
+}
+
+void RenderStatsWriter::Write( const FrameTimes& times, const RenderStats& stats )
+{
+	if ( !m_File )
+	{
+		return;
+	}
+
+	// The stream buffers the lines, only the destructor and full buffers reach the disk
+	switch ( m_Format )
+	{
+	case Format::csv:
+		m_File << m_FrameNr << ',' << times.frame << ',' << times.wait << ',' << times.events << ',' << times.update << ',' << times.draw << ',' << times.swap << ',' << times.pacingError
+			<< ',' << stats.drawCalls << ',' << stats.vertices << ',' << stats.textureBinds << ',' << stats.stateChanges << ',' << stats.unsortedTextureBinds
+			<< ',' << stats.elidedTextureBinds << ',' << stats.elidedStateChanges << '\n';
+		break;
+	case Format::jsonLines:
+		m_File << "{\"frame\":" << m_FrameNr << ",\"ms\":" << times.frame << ",\"waitMs\":" << times.wait << ",\"eventsMs\":" << times.events
+			<< ",\"updateMs\":" << times.update << ",\"drawMs\":" << times.draw << ",\"swapMs\":" << times.swap << ",\"pacingErrorMs\":" << times.pacingError
+			<< ",\"drawCalls\":" << stats.drawCalls << ",\"vertices\":" << stats.vertices
+			<< ",\"textureBinds\":" << stats.textureBinds << ",\"stateChanges\":" << stats.stateChanges
+			<< ",\"unsortedTextureBinds\":" << stats.unsortedTextureBinds
+			<< ",\"elidedTextureBinds\":" << stats.elidedTextureBinds << ",\"elidedStateChanges\":" << stats.elidedStateChanges << "}\n";
+		break;
+	}
+	++m_FrameNr;
+}
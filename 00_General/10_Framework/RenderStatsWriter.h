@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+#include <fstream>
+#include "RenderStats.h"
+
+// Streams the counters and frame times of every frame to a file, for offline analysis.
+// The format follows the extension of the path:
+//		.csv	one header line, then one comma separated line per frame
+//		.jsonl	one JSON object per line, e.g. {"frame":12,"ms":16.67,...,"drawCalls":40,...}
+// Core creates one when the environment variable DAE_RENDER_STATS holds a path.
+class RenderStatsWriter
+{
+public:
+	explicit RenderStatsWriter( const std::string& path );
+	RenderStatsWriter( const RenderStatsWriter& other ) = delete;
+	RenderStatsWriter& operator=( const RenderStatsWriter& other ) = delete;
+
+	bool IsOpenOk( ) const;
+	void Write( const FrameTimes& times, const RenderStats& stats );
+
+private:
+	enum class Format
+	{
+		csv,
+		jsonLines
+	};
+
+	// DATA MEMBERS
+	std::ofstream m_File;
+	Format m_Format;
+	int m_FrameNr;
+};
@@ -0,0 +1,242 @@
+#include "stdafx.h"
+#include "ResourcePreload.h"
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace dae
+{
+	namespace
+	{
+		struct Resource
+		{
+			std::string path;
+			// 0 for images
+			int ptSize;
+			SDL_Surface* pSurface;
+			TTF_Font* pFont;
+			bool isLoaded;
+		};
+
+		std::mutex g_Mutex;
+		std::condition_variable g_Loaded;
+		std::vector<Resource> g_Resources;
+		std::thread g_Worker;
+
+		std::once_flag g_ImageInitFlag;
+		std::once_flag g_FontInitFlag;
+		std::mutex g_FontMutex;
+		bool g_IsImageInitOk{ false };
+		bool g_IsFontInitOk{ false };
+
+		void LoadResources( )
+		{
+			// Only this thread adds results, the vector doesn't grow once preloading started
+			for ( size_t idx{ 0 }; ; ++idx )
+			{
+				std::string path;
+				int ptSize{ 0 };
+				{
+					std::lock_guard<std::mutex> lock{ g_Mutex };
+					if ( idx >= g_Resources.size( ) )
+					{
+						return;
+					}
+					path = g_Resources[idx].path;
+					ptSize = g_Resources[idx].ptSize;
+				}
+
+				SDL_Surface* pSurface{ nullptr };
+				TTF_Font* pFont{ nullptr };
+				if ( ptSize == 0 )
+				{
+					pSurface = InitImageLoading( ) ? IMG_Load( path.c_str( ) ) : nullptr;
+				}
+				else if ( InitFonts( ) )
+				{
+					std::lock_guard<std::mutex> lock{ g_FontMutex };
+					pFont = TTF_OpenFont( path.c_str( ), ptSize );
+				}
+
+				{
+					std::lock_guard<std::mutex> lock{ g_Mutex };
+					g_Resources[idx].pSurface = pSurface;
+					g_Resources[idx].pFont = pFont;
+					g_Resources[idx].isLoaded = true;
+				}
+				g_Loaded.notify_all( );
+			}
+		}
+
+		// Returns the index of the loaded resource, or -1
+		int WaitForResource( std::unique_lock<std::mutex>& lock, const std::string& path, int ptSize )
+		{
+			for ( size_t idx{ 0 }; idx < g_Resources.size( ); ++idx )
+			{
+				if ( g_Resources[idx].path == path && g_Resources[idx].ptSize == ptSize )
+				{
+					if ( !g_Worker.joinable( ) )
+					{
+						// Preloading never started, Core wasn't created yet
+						return -1;
+					}
+					g_Loaded.wait( lock, [idx] { return g_Resources[idx].isLoaded; } );
+					return int( idx );
+				}
+			}
+			return -1;
+		}
+	}
+
+	bool InitImageLoading( )
+	{
+		std::call_once( g_ImageInitFlag, [] {
+			const int imgFlags{ IMG_INIT_PNG };
+			g_IsImageInitOk = ( IMG_Init( imgFlags ) & imgFlags ) == imgFlags;
+			if ( !g_IsImageInitOk )
+			{
+				std::cerr << "dae::InitImageLoading( ), error when calling IMG_Init: " << IMG_GetError( ) << std::endl;
+			}
+		} );
+		return g_IsImageInitOk;
+	}
+
+	bool InitFonts( )
+	{
+		std::call_once( g_FontInitFlag, [] {
+			g_IsFontInitOk = TTF_Init( ) != -1;
+			if ( !g_IsFontInitOk )
+			{
+				std::cerr << "dae::InitFonts( ), error when calling TTF_Init: " << TTF_GetError( ) << std::endl;
+			}
+		} );
+		return g_IsFontInitOk;
+	}
+
+	std::mutex& GetFontMutex( )
+	{
+		return g_FontMutex;
+	}
+
+	bool GetGlyphPlacement( TTF_Font* pFont, Uint16 character, const SDL_Surface* pGlyph, GlyphPlacement& placement )
+	{
+		int minX{ 0 };
+		int maxX{ 0 };
+		int minY{ 0 };
+		int maxY{ 0 };
+		int advance{ 0 };
+		if ( TTF_GlyphMetrics( pFont, character, &minX, &maxX, &minY, &maxY, &advance ) != 0 )
+		{
+			return false;
+		}
+		placement.left = minX;
+		placement.top = maxY;
+		placement.advance = advance;
+		placement.source = SDL_Rect{ 0, 0, 0, 0 };
+		if ( pGlyph == nullptr || maxX <= minX || maxY <= minY )
+		{
+			return true;
+		}
+
+		const SDL_version* pVersion{ TTF_Linked_Version( ) };
+		if ( SDL_VERSIONNUM( pVersion->major, pVersion->minor, pVersion->patch ) >= SDL_VERSIONNUM( 2, 0, 18 ) )
+		{
+			// Rendered like a string of one character: the pen starts at x 0 unless the glyph sticks out to the left,
+			// the baseline is at the ascent unless the glyph sticks out above it
+			placement.source = SDL_Rect{ std::max( minX, 0 ), std::max( TTF_FontAscent( pFont ) - maxY, 0 ), maxX - minX, maxY - minY };
+		}
+		else
+		{
+			placement.source = SDL_Rect{ 0, 0, pGlyph->w, pGlyph->h };
+		}
+		placement.source.w = std::max( std::min( placement.source.w, pGlyph->w - placement.source.x ), 0 );
+		placement.source.h = std::max( std::min( placement.source.h, pGlyph->h - placement.source.y ), 0 );
+		return true;
+	}
+
+	void PreloadImage( const std::string& path )
+	{
+		std::lock_guard<std::mutex> lock{ g_Mutex };
+		if ( g_Worker.joinable( ) )
+		{
+			std::cerr << "dae::PreloadImage( ), " << path << " is queued after preloading started, it is ignored\n";
+			return;
+		}
+		g_Resources.push_back( Resource{ path, 0, nullptr, nullptr, false } );
+	}
+
+	void PreloadFont( const std::string& path, int ptSize )
+	{
+		std::lock_guard<std::mutex> lock{ g_Mutex };
+		if ( g_Worker.joinable( ) || ptSize <= 0 )
+		{
+			std::cerr << "dae::PreloadFont( ), " << path << " is queued after preloading started or has no size, it is ignored\n";
+			return;
+		}
+		g_Resources.push_back( Resource{ path, ptSize, nullptr, nullptr, false } );
+	}
+
+	void StartPreloading( )
+	{
+		std::lock_guard<std::mutex> lock{ g_Mutex };
+		if ( !g_Resources.empty( ) && !g_Worker.joinable( ) )
+		{
+			g_Worker = std::thread{ LoadResources };
+		}
+	}
+
+	void StopPreloading( )
+	{
+		if ( g_Worker.joinable( ) )
+		{
+			g_Worker.join( );
+		}
+		for ( Resource& resource : g_Resources )
+		{
+			SDL_FreeSurface( resource.pSurface );
+			if ( resource.pFont != nullptr )
+			{
+				TTF_CloseFont( resource.pFont );
+			}
+		}
+		g_Resources.clear( );
+
+		if ( g_IsFontInitOk )
+		{
+			TTF_Quit( );
+		}
+		if ( g_IsImageInitOk )
+		{
+			IMG_Quit( );
+		}
+	}
+
+	SDL_Surface* TakePreloadedImage( const std::string& path )
+	{
+		std::unique_lock<std::mutex> lock{ g_Mutex };
+		const int idx{ WaitForResource( lock, path, 0 ) };
+		if ( idx < 0 )
+		{
+			return nullptr;
+		}
+		SDL_Surface* pSurface{ g_Resources[idx].pSurface };
+		g_Resources[idx].pSurface = nullptr;
+		return pSurface;
+	}
+
+	TTF_Font* TakePreloadedFont( const std::string& path, int ptSize )
+	{
+		std::unique_lock<std::mutex> lock{ g_Mutex };
+		const int idx{ WaitForResource( lock, path, ptSize ) };
+		if ( idx < 0 )
+		{
+			return nullptr;
+		}
+		TTF_Font* pFont{ g_Resources[idx].pFont };
+		g_Resources[idx].pFont = nullptr;
+		return pFont;
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+#include <mutex>
+
+// Start-up helpers for SDL_image and SDL_ttf.
+//
+// The extension libraries are initialized on first use instead of at start-up,
+// so a game without images or fonts doesn't pay for them. Texture calls these functions itself,
+// code that calls IMG_Load or TTF_OpenFont directly calls them first.
+//
+// Images and fonts known up front can be decoded on a background thread while Core creates
+// the window and the OpenGL context. Queue them before creating Core, e.g. in main:
+//		dae::PreloadImage( "Resources/Background.png" );
+//		dae::PreloadFont( "Resources/DIN-Light.otf", 24 );
+//		Core core{ ... };
+// Texture picks up the decoded result instead of loading the file again.
+namespace dae
+{
+	// Thread safe, return false when the library failed to initialize
+	bool InitImageLoading( );
+	bool InitFonts( );
+	// SDL_ttf isn't thread safe, and the preload worker and the hot reload thread use it while the game runs:
+	// hold this lock during every SDL_ttf call
+	std::mutex& GetFontMutex( );
+
+	// Where the pixels of a glyph are, from TTF_GlyphMetrics and TTF_FontAscent
+	struct GlyphPlacement
+	{
+		// The glyph's pixels in the surface of TTF_RenderGlyph_Blended, empty for a space
+		SDL_Rect source;
+		// Top-left of those pixels relative to the pen position on the baseline, y up, and the pen advance
+		int left;
+		int top;
+		int advance;
+	};
+	// pGlyph is the surface TTF_RenderGlyph_Blended returned for character, or nullptr.
+	// SDL_ttf before 2.0.18 returns only the glyph's pixels, later versions a cell of the font height
+	// with the baseline at the ascent. Returns false when the font has no such glyph.
+	bool GetGlyphPlacement( TTF_Font* pFont, Uint16 character, const SDL_Surface* pGlyph, GlyphPlacement& placement );
+
+	void PreloadImage( const std::string& path );
+	void PreloadFont( const std::string& path, int ptSize );
+
+	// Called by Core: StartPreloading after SDL_Init, StopPreloading before SDL_Quit.
+	// StopPreloading frees what wasn't used and quits the extension libraries that were initialized.
+	void StartPreloading( );
+	void StopPreloading( );
+
+	// Wait for a queued resource and hand over its ownership, nullptr when it wasn't queued or failed to load
+	SDL_Surface* TakePreloadedImage( const std::string& path );
+	TTF_Font* TakePreloadedFont( const std::string& path, int ptSize );
+}
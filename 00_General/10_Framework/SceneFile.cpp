@@ -0,0 +1,338 @@
+#include "stdafx.h"
+#include "SceneFile.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//-----------------------------------------------------------------
+// SceneFile
+//-----------------------------------------------------------------
+SceneFile::SceneFile( const std::string& path )
+{
+	if ( Map( path ) )
+	{
+		m_LoadOk = FixUp( );
+		if ( !m_LoadOk )
+		{
+			std::cerr << "SceneFile::SceneFile( ), " << path << " is not a valid scene file of version " << g_SceneFileVersion << '\n';
+		}
+	}
+}
+
+SceneFile::~SceneFile( )
+{
+	Unmap( );
+}
+
+bool SceneFile::Map( const std::string& path )
+{
+#ifdef _WIN32
+	HANDLE file{ CreateFileA( path.c_str( ), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr ) };
+	if ( file == INVALID_HANDLE_VALUE )
+	{
+		std::cerr << "SceneFile::Map( ), error when calling CreateFile for " << path << ": " << GetLastError( ) << '\n';
+		return false;
+	}
+	m_FileHandle = file;
+	LARGE_INTEGER size{};
+	GetFileSizeEx( file, &size );
+	m_Size = size_t( size.QuadPart );
+	if ( m_Size == 0 )
+	{
+		return false;
+	}
+	m_MappingHandle = CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+	if ( m_MappingHandle == nullptr )
+	{
+		std::cerr << "SceneFile::Map( ), error when calling CreateFileMapping for " << path << ": " << GetLastError( ) << '\n';
+		return false;
+	}
+	m_pData = static_cast<const char*>( MapViewOfFile( m_MappingHandle, FILE_MAP_READ, 0, 0, 0 ) );
+	if ( m_pData == nullptr )
+	{
+		std::cerr << "SceneFile::Map( ), error when calling MapViewOfFile for " << path << ": " << GetLastError( ) << '\n';
+		return false;
+	}
+#else
+	int file{ open( path.c_str( ), O_RDONLY ) };
+	if ( file < 0 )
+	{
+		std::cerr << "SceneFile::Map( ), unable to open " << path << '\n';
+		return false;
+	}
+	struct stat fileInfo{};
+	if ( fstat( file, &fileInfo ) < 0 || fileInfo.st_size == 0 )
+	{
+		close( file );
+		return false;
+	}
+	m_Size = size_t( fileInfo.st_size );
+	void* pMapped{ mmap( nullptr, m_Size, PROT_READ, MAP_PRIVATE, file, 0 ) };
+	// The mapping stays valid after closing the file
+	close( file );
+	if ( pMapped == MAP_FAILED )
+	{
+		std::cerr << "SceneFile::Map( ), error when calling mmap for " << path << '\n';
+		return false;
+	}
+	m_pData = static_cast<const char*>( pMapped );
+#endif
+	return true;
+}
+
+void SceneFile::Unmap( )
+{
+#ifdef _WIN32
+	if ( m_pData != nullptr )
+	{
+		UnmapViewOfFile( m_pData );
+	}
+	if ( m_MappingHandle != nullptr )
+	{
+		CloseHandle( m_MappingHandle );
+	}
+	if ( m_FileHandle != nullptr )
+	{
+		CloseHandle( m_FileHandle );
+	}
+	m_MappingHandle = nullptr;
+	m_FileHandle = nullptr;
+#else
+	if ( m_pData != nullptr )
+	{
+		munmap( const_cast<char*>( m_pData ), m_Size );
+	}
+#endif
+	m_pData = nullptr;
+	m_Size = 0;
+}
+
+bool SceneFile::FixUp( )
+{
+	if ( m_Size < sizeof( SceneHeader ) )
+	{
+		return false;
+	}
+	m_pHeader = reinterpret_cast<const SceneHeader*>( m_pData );
+	if ( std::memcmp( m_pHeader->magic, "DAES", 4 ) != 0 || m_pHeader->version != g_SceneFileVersion || m_pHeader->fileSize != m_Size )
+	{
+		return false;
+	}
+
+	// Every section has to lie within the file and be aligned for its element type
+	const size_t elementSizes[int( SceneSection::count )]{ sizeof( Point2f ), sizeof( Rectf ), sizeof( Color4f ), sizeof( SceneEntity ), sizeof( SceneTexture ), 1 };
+	for ( int idx{ 0 }; idx < int( SceneSection::count ); ++idx )
+	{
+		const SceneSectionInfo& section{ m_pHeader->sections[idx] };
+		if ( section.offset % 16 != 0 || section.offset > m_Size || ( m_Size - section.offset ) / elementSizes[idx] < section.count )
+		{
+			return false;
+		}
+	}
+
+	m_pPoints = static_cast<const Point2f*>( GetSection( SceneSection::points ) );
+	m_pRects = static_cast<const Rectf*>( GetSection( SceneSection::rects ) );
+	m_pColors = static_cast<const Color4f*>( GetSection( SceneSection::colors ) );
+	m_pEntities = static_cast<const SceneEntity*>( GetSection( SceneSection::entities ) );
+	m_pTextures = static_cast<const SceneTexture*>( GetSection( SceneSection::textures ) );
+	m_pStrings = static_cast<const char*>( GetSection( SceneSection::strings ) );
+
+	// Texture paths have to be zero terminated within the strings section
+	const Uint32 stringsSize{ Uint32( GetCount( SceneSection::strings ) ) };
+	for ( int idx{ 0 }; idx < GetCount( SceneSection::textures ); ++idx )
+	{
+		const SceneTexture& texture{ m_pTextures[idx] };
+		if ( texture.pathOffset >= stringsSize || stringsSize - texture.pathOffset <= texture.pathLength
+			|| m_pStrings[texture.pathOffset + texture.pathLength] != '\0' )
+		{
+			return false;
+		}
+	}
+
+	// Entities refer to the other sections by index, so these have to be in range or -1
+	const auto isIndexOk{ [this]( int index, SceneSection section )
+	{
+		return index >= -1 && index < GetCount( section );
+	} };
+	for ( int idx{ 0 }; idx < GetCount( SceneSection::entities ); ++idx )
+	{
+		const SceneEntity& entity{ m_pEntities[idx] };
+		if ( !isIndexOk( entity.textureIndex, SceneSection::textures ) || !isIndexOk( entity.rectIndex, SceneSection::rects )
+			|| !isIndexOk( entity.colorIndex, SceneSection::colors ) || !isIndexOk( entity.firstPoint, SceneSection::points )
+			|| entity.nrPoints < 0 || ( entity.nrPoints > 0 && ( entity.firstPoint < 0 || GetCount( SceneSection::points ) - entity.firstPoint < entity.nrPoints ) ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+const void* SceneFile::GetSection( SceneSection section ) const
+{
+	const SceneSectionInfo& info{ m_pHeader->sections[int( section )] };
+	return info.count > 0 ? m_pData + info.offset : nullptr;
+}
+
+int SceneFile::GetCount( SceneSection section ) const
+{
+	return m_pHeader != nullptr ? int( m_pHeader->sections[int( section )].count ) : 0;
+}
+
+bool SceneFile::IsLoadOk( ) const
+{
+	return m_LoadOk;
+}
+
+Uint32 SceneFile::GetVersion( ) const
+{
+	return m_LoadOk ? m_pHeader->version : 0;
+}
+
+const Point2f* SceneFile::GetPoints( ) const
+{
+	return m_pPoints;
+}
+
+int SceneFile::GetNrPoints( ) const
+{
+	return m_LoadOk ? GetCount( SceneSection::points ) : 0;
+}
+
+const Rectf* SceneFile::GetRects( ) const
+{
+	return m_pRects;
+}
+
+int SceneFile::GetNrRects( ) const
+{
+	return m_LoadOk ? GetCount( SceneSection::rects ) : 0;
+}
+
+const Color4f* SceneFile::GetColors( ) const
+{
+	return m_pColors;
+}
+
+int SceneFile::GetNrColors( ) const
+{
+	return m_LoadOk ? GetCount( SceneSection::colors ) : 0;
+}
+
+const SceneEntity* SceneFile::GetEntities( ) const
+{
+	return m_pEntities;
+}
+
+int SceneFile::GetNrEntities( ) const
+{
+	return m_LoadOk ? GetCount( SceneSection::entities ) : 0;
+}
+
+int SceneFile::GetNrTextures( ) const
+{
+	return m_LoadOk ? GetCount( SceneSection::textures ) : 0;
+}
+
+const char* SceneFile::GetTexturePath( int textureIndex ) const
+{
+	if ( textureIndex < 0 || textureIndex >= GetNrTextures( ) )
+	{
+		return nullptr;
+	}
+	return m_pStrings + m_pTextures[textureIndex].pathOffset;
+}
+
+//-----------------------------------------------------------------
+// SceneWriter
+//-----------------------------------------------------------------
+int SceneWriter::AddPoint( const Point2f& point )
+{
+	m_Points.push_back( point );
+	return int( m_Points.size( ) ) - 1;
+}
+
+int SceneWriter::AddRect( const Rectf& rect )
+{
+	m_Rects.push_back( rect );
+	return int( m_Rects.size( ) ) - 1;
+}
+
+int SceneWriter::AddColor( const Color4f& color )
+{
+	m_Colors.push_back( color );
+	return int( m_Colors.size( ) ) - 1;
+}
+
+int SceneWriter::AddTexture( const std::string& path )
+{
+	for ( size_t idx{ 0 }; idx < m_Textures.size( ); ++idx )
+	{
+		if ( path == m_Strings.c_str( ) + m_Textures[idx].pathOffset )
+		{
+			return int( idx );
+		}
+	}
+	SceneTexture texture{};
+	texture.pathOffset = Uint32( m_Strings.size( ) );
+	texture.pathLength = Uint32( path.size( ) );
+	m_Strings.append( path );
+	m_Strings.push_back( '\0' );
+	m_Textures.push_back( texture );
+	return int( m_Textures.size( ) ) - 1;
+}
+
+int SceneWriter::AddEntity( const SceneEntity& entity )
+{
+	m_Entities.push_back( entity );
+	return int( m_Entities.size( ) ) - 1;
+}
+
+bool SceneWriter::Save( const std::string& path ) const
+{
+	// Lay out the sections after the header, each one 16 byte aligned
+	SceneHeader header{};
+	std::memcpy( header.magic, "DAES", 4 );
+	header.version = g_SceneFileVersion;
+
+	const void* pSources[int( SceneSection::count )]{ m_Points.data( ), m_Rects.data( ), m_Colors.data( ), m_Entities.data( ), m_Textures.data( ), m_Strings.data( ) };
+	const size_t sizes[int( SceneSection::count )]{ m_Points.size( ) * sizeof( Point2f ), m_Rects.size( ) * sizeof( Rectf ),
+		m_Colors.size( ) * sizeof( Color4f ), m_Entities.size( ) * sizeof( SceneEntity ), m_Textures.size( ) * sizeof( SceneTexture ), m_Strings.size( ) };
+	const size_t counts[int( SceneSection::count )]{ m_Points.size( ), m_Rects.size( ), m_Colors.size( ), m_Entities.size( ), m_Textures.size( ), m_Strings.size( ) };
+
+	size_t offset{ ( sizeof( SceneHeader ) + 15 ) / 16 * 16 };
+	for ( int idx{ 0 }; idx < int( SceneSection::count ); ++idx )
+	{
+		header.sections[idx].offset = Uint32( offset );
+		header.sections[idx].count = Uint32( counts[idx] );
+		offset = ( offset + sizes[idx] + 15 ) / 16 * 16;
+	}
+	header.fileSize = Uint32( offset );
+
+	// Build the whole file in memory, zero filled padding included, and write it at once
+	std::vector<char> buffer( offset, '\0' );
+	std::memcpy( buffer.data( ), &header, sizeof( SceneHeader ) );
+	for ( int idx{ 0 }; idx < int( SceneSection::count ); ++idx )
+	{
+		if ( sizes[idx] > 0 )
+		{
+			std::memcpy( buffer.data( ) + header.sections[idx].offset, pSources[idx], sizes[idx] );
+		}
+	}
+
+	std::ofstream file{ path, std::ios::binary };
+	if ( !file )
+	{
+		std::cerr << "SceneWriter::Save( ), unable to open " << path << " for writing\n";
+		return false;
+	}
+	file.write( buffer.data( ), buffer.size( ) );
+	return bool( file );
+}
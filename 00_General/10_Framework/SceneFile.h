@@ -0,0 +1,141 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Binary scene format
+// A scene file is a header followed by flat arrays of Point2f, Rectf, Color4f, SceneEntity,
+// SceneTexture and a blob of zero terminated texture paths. Arrays start at 16 byte aligned offsets
+// and padding is zero filled, so saving the same scene twice gives identical files that can be diffed.
+// All values are stored little-endian, in the in-memory layout of the structs.
+
+// Bump when the layout of any stored struct changes
+const Uint32 g_SceneFileVersion{ 1 };
+
+enum class SceneSection
+{
+	points,
+	rects,
+	colors,
+	entities,
+	textures,
+	strings,
+	count
+};
+
+struct SceneSectionInfo
+{
+	// Byte offset from the start of the file
+	Uint32 offset;
+	// Number of elements (bytes for the strings section)
+	Uint32 count;
+};
+
+struct SceneHeader
+{
+	char magic[4];
+	Uint32 version;
+	Uint32 fileSize;
+	Uint32 reserved;
+	SceneSectionInfo sections[int( SceneSection::count )];
+};
+
+// An entity refers to the other arrays by index, -1 meaning none
+struct SceneEntity
+{
+	// Meaning is up to the game
+	Uint32 type;
+	int textureIndex;
+	int rectIndex;
+	int colorIndex;
+	int firstPoint;
+	int nrPoints;
+	float radius;
+	float rotation;
+};
+
+struct SceneTexture
+{
+	// Byte offset of the zero terminated path in the strings section
+	Uint32 pathOffset;
+	Uint32 pathLength;
+};
+
+// Read-only view of a scene file.
+// The file is mapped in memory and the arrays are used in place: loading only validates the header and the entity indices
+// and turns the section offsets into pointers, there is no per-field parsing.
+class SceneFile
+{
+public:
+	explicit SceneFile( const std::string& path );
+	SceneFile( const SceneFile& other ) = delete;
+	SceneFile& operator=( const SceneFile& other ) = delete;
+	~SceneFile( );
+
+	bool IsLoadOk( ) const;
+	Uint32 GetVersion( ) const;
+
+	const Point2f* GetPoints( ) const;
+	int GetNrPoints( ) const;
+	const Rectf* GetRects( ) const;
+	int GetNrRects( ) const;
+	const Color4f* GetColors( ) const;
+	int GetNrColors( ) const;
+	const SceneEntity* GetEntities( ) const;
+	int GetNrEntities( ) const;
+	int GetNrTextures( ) const;
+	const char* GetTexturePath( int textureIndex ) const;
+
+private:
+	// DATA MEMBERS
+	// The mapped file
+	const char* m_pData{ };
+	size_t m_Size{ };
+#ifdef _WIN32
+	void* m_FileHandle{ };
+	void* m_MappingHandle{ };
+#endif
+	// Fixed-up section pointers, into the mapped file
+	const SceneHeader* m_pHeader{ };
+	const Point2f* m_pPoints{ };
+	const Rectf* m_pRects{ };
+	const Color4f* m_pColors{ };
+	const SceneEntity* m_pEntities{ };
+	const SceneTexture* m_pTextures{ };
+	const char* m_pStrings{ };
+	bool m_LoadOk{ };
+
+	// FUNCTIONS
+	bool Map( const std::string& path );
+	void Unmap( );
+	bool FixUp( );
+	const void* GetSection( SceneSection section ) const;
+	int GetCount( SceneSection section ) const;
+};
+
+// Builds a scene in memory and writes it in the SceneFile format
+class SceneWriter
+{
+public:
+	SceneWriter( ) = default;
+	SceneWriter( const SceneWriter& other ) = delete;
+	SceneWriter& operator=( const SceneWriter& other ) = delete;
+
+	// The Add functions return the index to use in a SceneEntity
+	int AddPoint( const Point2f& point );
+	int AddRect( const Rectf& rect );
+	int AddColor( const Color4f& color );
+	// Adding the same path twice returns the same index
+	int AddTexture( const std::string& path );
+	int AddEntity( const SceneEntity& entity );
+
+	bool Save( const std::string& path ) const;
+
+private:
+	// DATA MEMBERS
+	std::vector<Point2f> m_Points;
+	std::vector<Rectf> m_Rects;
+	std::vector<Color4f> m_Colors;
+	std::vector<SceneEntity> m_Entities;
+	std::vector<SceneTexture> m_Textures;
+	std::string m_Strings;
+};
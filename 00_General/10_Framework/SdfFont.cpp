@@ -0,0 +1,337 @@
+#include "stdafx.h"
+#include "SdfFont.h"
+#include "ResourcePreload.h"
+#include "RenderStats.h"
+#include "RenderBackend.h"
+#include "RenderQueue.h"
+#include "GlState.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+
+SdfFont::SdfFont( const std::string& fontPath, int atlasPtSize )
+	:m_AtlasId{ 0 }
+	,m_AtlasHeight{ 0 }
+	,m_AtlasPtSize{ atlasPtSize }
+	,m_LineHeight{ float( atlasPtSize ) }
+	,m_Baseline{ 0.0f }
+	,m_Glyphs{ }
+	,m_CreationOk{ false }
+{
+	dae::CheckRenderThread( "SdfFont::SdfFont( )" );
+	CreateAtlas( fontPath );
+}
+
+SdfFont::~SdfFont( )
+{
+	dae::CheckRenderThread( "SdfFont::~SdfFont( )" );
+	dae::SubmitRenderQueue( );
+	dae::FlushRenderBackend( );
+	dae::DeleteGlTexture( m_AtlasId );
+}
+
+bool SdfFont::IsCreationOk( ) const
+{
+	return m_CreationOk;
+}
+
+void SdfFont::Draw( const std::string& text, const Point2f& bottomLeft, float ptSize, const Color4f& color ) const
+{
+	if ( !m_CreationOk )
+	{
+		return;
+	}
+
+	// The quads include the spread around the glyphs
+	const float scale{ ptSize / m_AtlasPtSize };
+	const Color4f opaqueColor{ color.r, color.g, color.b, 1.0f };
+	m_Vertices.clear( );
+	float left{ bottomLeft.x };
+	for ( char character : text )
+	{
+		const int idx{ int( character ) - m_FirstGlyph };
+		if ( idx < 0 || idx >= m_NrGlyphs )
+		{
+			continue;
+		}
+		const Glyph& glyph{ m_Glyphs[idx] };
+		if ( glyph.width == 0.0f )
+		{
+			left += glyph.advance * scale;
+			continue;
+		}
+		const float quadLeft{ left + ( glyph.offsetLeft - m_Spread ) * scale };
+		const float quadTop{ bottomLeft.y + ( m_Baseline + glyph.offsetTop + m_Spread ) * scale };
+		const float quadRight{ quadLeft + glyph.width * scale };
+		const float quadBottom{ quadTop - glyph.height * scale };
+		// The atlas rows are stored top to bottom
+		const float texLeft{ glyph.left / m_AtlasWidth };
+		const float texRight{ ( glyph.left + glyph.width ) / m_AtlasWidth };
+		const float texTop{ glyph.top / m_AtlasHeight };
+		const float texBottom{ ( glyph.top + glyph.height ) / m_AtlasHeight };
+		m_Vertices.push_back( RenderVertex{ quadLeft, quadBottom, texLeft, texBottom, opaqueColor } );
+		m_Vertices.push_back( RenderVertex{ quadRight, quadBottom, texRight, texBottom, opaqueColor } );
+		m_Vertices.push_back( RenderVertex{ quadRight, quadTop, texRight, texTop, opaqueColor } );
+		m_Vertices.push_back( RenderVertex{ quadLeft, quadTop, texLeft, texTop, opaqueColor } );
+		left += glyph.advance * scale;
+	}
+	if ( m_Vertices.empty( ) )
+	{
+		return;
+	}
+
+	// Keep the fragments with a distance of at least 0.5, without blending: the outline is sharp at any scale
+	dae::RenderTexturedVertices( m_AtlasId, GL_QUADS, m_Vertices.data( ), int( m_Vertices.size( ) ), 0.5f );
+}
+
+float SdfFont::GetTextWidth( const std::string& text, float ptSize ) const
+{
+	float width{ 0.0f };
+	for ( char character : text )
+	{
+		const int idx{ int( character ) - m_FirstGlyph };
+		if ( idx >= 0 && idx < m_NrGlyphs )
+		{
+			width += m_Glyphs[idx].advance;
+		}
+	}
+	return width * ptSize / m_AtlasPtSize;
+}
+
+float SdfFont::GetLineHeight( float ptSize ) const
+{
+	return m_LineHeight * ptSize / m_AtlasPtSize;
+}
+
+int SdfFont::GetAtlasSize( ) const
+{
+	return m_AtlasWidth * m_AtlasHeight;
+}
+
+void SdfFont::CreateAtlas( const std::string& fontPath )
+{
+	if ( !dae::InitFonts( ) )
+	{
+		return;
+	}
+	std::unique_lock<std::mutex> fontLock{ dae::GetFontMutex( ) };
+	TTF_Font* pFont{ TTF_OpenFont( fontPath.c_str( ), m_AtlasPtSize * m_Oversampling ) };
+	if ( pFont == nullptr )
+	{
+		std::cerr << "SdfFont::CreateAtlas( ), error when calling TTF_OpenFont: " << TTF_GetError( ) << '\n';
+		return;
+	}
+
+	m_LineHeight = float( TTF_FontHeight( pFont ) ) / m_Oversampling;
+	m_Baseline = float( TTF_FontHeight( pFont ) - TTF_FontAscent( pFont ) ) / m_Oversampling;
+
+	// Distance fields of all glyphs, then packed in rows
+	std::vector<std::vector<Uint8>> fields( m_NrGlyphs );
+	const SDL_Color white{ 255, 255, 255, 255 };
+	for ( int idx{ 0 }; idx < m_NrGlyphs; ++idx )
+	{
+		const Uint16 character{ Uint16( m_FirstGlyph + idx ) };
+		SDL_Surface* pGlyph{ TTF_RenderGlyph_Blended( pFont, character, white ) };
+		dae::GlyphPlacement placement{ };
+		if ( dae::GetGlyphPlacement( pFont, character, pGlyph, placement ) )
+		{
+			Glyph& glyph{ m_Glyphs[idx] };
+			glyph.offsetLeft = float( placement.left ) / m_Oversampling;
+			glyph.offsetTop = float( placement.top ) / m_Oversampling;
+			glyph.advance = float( placement.advance ) / m_Oversampling;
+			if ( placement.source.w > 0 && placement.source.h > 0 )
+			{
+				int width{ 0 };
+				int height{ 0 };
+				fields[idx] = GetDistanceField( pGlyph, placement.source, width, height );
+				glyph.width = float( width );
+				glyph.height = float( height );
+			}
+		}
+		SDL_FreeSurface( pGlyph );
+	}
+	TTF_CloseFont( pFont );
+	fontLock.unlock( );
+
+	int penX{ 0 };
+	int penY{ 0 };
+	int rowHeight{ 0 };
+	for ( Glyph& glyph : m_Glyphs )
+	{
+		if ( penX + int( glyph.width ) > m_AtlasWidth )
+		{
+			penX = 0;
+			penY += rowHeight;
+			rowHeight = 0;
+		}
+		glyph.left = float( penX );
+		glyph.top = float( penY );
+		penX += int( glyph.width );
+		rowHeight = std::max( rowHeight, int( glyph.height ) );
+	}
+	// Power of 2 height, for old drivers
+	m_AtlasHeight = 1;
+	while ( m_AtlasHeight < penY + rowHeight )
+	{
+		m_AtlasHeight *= 2;
+	}
+
+	std::vector<Uint8> pixels( size_t( m_AtlasWidth ) * m_AtlasHeight, 0 );
+	for ( int idx{ 0 }; idx < m_NrGlyphs; ++idx )
+	{
+		const Glyph& glyph{ m_Glyphs[idx] };
+		for ( int y{ 0 }; y < int( glyph.height ); ++y )
+		{
+			std::copy_n( fields[idx].data( ) + y * int( glyph.width ), int( glyph.width ), pixels.data( ) + ( int( glyph.top ) + y ) * m_AtlasWidth + int( glyph.left ) );
+		}
+	}
+
+	glGenTextures( 1, &m_AtlasId );
+	dae::SetGlTexture( m_AtlasId );
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+	if ( dae::GetRenderBackend( ) == RenderBackend::shaders )
+	{
+		// A core profile has no alpha textures: a red one, read as white with the distance in alpha
+		glTexImage2D( GL_TEXTURE_2D, 0, GL_R8, m_AtlasWidth, m_AtlasHeight, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data( ) );
+		const GLint swizzle[]{ GL_ONE, GL_ONE, GL_ONE, GL_RED };
+		glTexParameteriv( GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle );
+	}
+	else
+	{
+		glTexImage2D( GL_TEXTURE_2D, 0, GL_ALPHA8, m_AtlasWidth, m_AtlasHeight, 0, GL_ALPHA, GL_UNSIGNED_BYTE, pixels.data( ) );
+	}
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+	// Linear filtering interpolates the distances, that's what makes the outline smooth
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+	m_CreationOk = true;
+}
+
+std::vector<Uint8> SdfFont::GetDistanceField( const SDL_Surface* pGlyph, const SDL_Rect& source, int& width, int& height )
+{
+	// Large glyph with a border of m_Spread atlas texels
+	const int border{ m_Spread * m_Oversampling };
+	width = ( source.w + m_Oversampling - 1 ) / m_Oversampling + 2 * m_Spread;
+	height = ( source.h + m_Oversampling - 1 ) / m_Oversampling + 2 * m_Spread;
+	const int largeWidth{ width * m_Oversampling };
+	const int largeHeight{ height * m_Oversampling };
+
+	// Distance of the outside pixels to the glyph and of the inside pixels to the outside
+	std::vector<float> toInside( size_t( largeWidth ) * largeHeight, FLT_MAX );
+	std::vector<float> toOutside( toInside.size( ), 0.0f );
+	const SDL_PixelFormat* pFormat{ pGlyph->format };
+	for ( int y{ 0 }; y < source.h; ++y )
+	{
+		const Uint32* pRow{ reinterpret_cast<const Uint32*>( static_cast<const Uint8*>( pGlyph->pixels ) + ( source.y + y ) * pGlyph->pitch ) + source.x };
+		for ( int x{ 0 }; x < source.w; ++x )
+		{
+			if ( ( ( pRow[x] & pFormat->Amask ) >> pFormat->Ashift ) >= 128 )
+			{
+				const size_t idx{ size_t( y + border ) * largeWidth + x + border };
+				toInside[idx] = 0.0f;
+				toOutside[idx] = FLT_MAX;
+			}
+		}
+	}
+	TransformDistances( toInside, largeWidth, largeHeight );
+	TransformDistances( toOutside, largeWidth, largeHeight );
+
+	// Sample the center of each texel, 0.5 is the outline and the values reach 0 and 1 at m_Spread texels
+	std::vector<Uint8> field( size_t( width ) * height );
+	const float range{ 2.0f * m_Spread * m_Oversampling };
+	for ( int y{ 0 }; y < height; ++y )
+	{
+		for ( int x{ 0 }; x < width; ++x )
+		{
+			// The 2x2 large pixels around the texel center.
+			// The outline lies half a pixel from the pixel centers on both sides of it.
+			float distance{ 0.0f };
+			for ( int sampleY{ m_Oversampling / 2 - 1 }; sampleY <= m_Oversampling / 2; ++sampleY )
+			{
+				for ( int sampleX{ m_Oversampling / 2 - 1 }; sampleX <= m_Oversampling / 2; ++sampleX )
+				{
+					const size_t idx{ size_t( y * m_Oversampling + sampleY ) * largeWidth + x * m_Oversampling + sampleX };
+					distance += toInside[idx] > 0.0f ? std::sqrt( toInside[idx] ) - 0.5f : 0.5f - std::sqrt( toOutside[idx] );
+				}
+			}
+			const float value{ std::clamp( 0.5f - distance / 4.0f / range, 0.0f, 1.0f ) };
+			field[size_t( y ) * width + x] = Uint8( value * 255.0f + 0.5f );
+		}
+	}
+	return field;
+}
+
+void SdfFont::TransformDistances( std::vector<float>& grid, int width, int height )
+{
+	// Separable: the columns first, then the rows of the result
+	const int size{ std::max( width, height ) };
+	std::vector<float> source( size );
+	std::vector<float> result( size );
+	std::vector<int> parabolas( size );
+	std::vector<float> bounds( size + 1 );
+	for ( int x{ 0 }; x < width; ++x )
+	{
+		for ( int y{ 0 }; y < height; ++y )
+		{
+			source[y] = grid[size_t( y ) * width + x];
+		}
+		TransformDistances( source.data( ), result.data( ), height, parabolas, bounds );
+		for ( int y{ 0 }; y < height; ++y )
+		{
+			grid[size_t( y ) * width + x] = result[y];
+		}
+	}
+	for ( int y{ 0 }; y < height; ++y )
+	{
+		float* pRow{ grid.data( ) + size_t( y ) * width };
+		std::copy_n( pRow, width, source.data( ) );
+		TransformDistances( source.data( ), pRow, width, parabolas, bounds );
+	}
+}
+
+void SdfFont::TransformDistances( const float* pSource, float* pResult, int count, std::vector<int>& parabolas, std::vector<float>& bounds )
+{
+	// Lower envelope of the parabolas ( q - p )^2 + source[p], FLT_MAX cells have no parabola
+	int nrParabolas{ 0 };
+	for ( int q{ 0 }; q < count; ++q )
+	{
+		if ( pSource[q] == FLT_MAX )
+		{
+			continue;
+		}
+		float intersection{ -FLT_MAX };
+		while ( nrParabolas > 0 )
+		{
+			const int p{ parabolas[nrParabolas - 1] };
+			intersection = ( ( pSource[q] + q * q ) - ( pSource[p] + p * p ) ) / ( 2.0f * ( q - p ) );
+			if ( intersection > bounds[nrParabolas - 1] )
+			{
+				break;
+			}
+			--nrParabolas;
+			intersection = -FLT_MAX;
+		}
+		parabolas[nrParabolas] = q;
+		bounds[nrParabolas] = intersection;
+		++nrParabolas;
+	}
+
+	if ( nrParabolas == 0 )
+	{
+		std::fill_n( pResult, count, FLT_MAX );
+		return;
+	}
+	int parabola{ 0 };
+	for ( int q{ 0 }; q < count; ++q )
+	{
+		while ( parabola + 1 < nrParabolas && bounds[parabola + 1] < q )
+		{
+			++parabola;
+		}
+		const int p{ parabolas[parabola] };
+		pResult[q] = float( q - p ) * float( q - p ) + pSource[p];
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "RenderBackend.h"
+
+// Text that stays sharp at any size, from one glyph atlas per font.
+// Each glyph is rendered once with TTF_RenderGlyph_Blended at 4 times the atlas size and turned into
+// a signed distance field: each atlas texel stores its distance to the glyph outline, 0.5 being the outline.
+// Bilinear filtering interpolates distances instead of coverage, so testing against 0.5 gives a sharp edge
+// however much the glyph is magnified (alpha tested magnification, as in Valve's "Improved Alpha-Tested
+// Magnification for Vector Textures and Special Effects").
+//		SdfFont font{ "Resources/DIN-Light.otf" };
+//		font.Draw( "Game over", Point2f{ 100, 200 }, 72, Color4f{ 1, 0, 0, 1 } );
+//		font.Draw( "Press space", Point2f{ 100, 150 }, 18, Color4f{ 1, 1, 1, 1 } );
+// The text is opaque: the alpha of the color is not used.
+class SdfFont
+{
+public:
+	// atlasPtSize: size of the glyphs in the atlas, 32 stays sharp up to large sizes
+	explicit SdfFont( const std::string& fontPath, int atlasPtSize = 32 );
+	SdfFont( const SdfFont& other ) = delete;
+	SdfFont& operator=( const SdfFont& other ) = delete;
+	~SdfFont( );
+
+	bool IsCreationOk( ) const;
+
+	// All text is drawn in one glDrawArrays call
+	void Draw( const std::string& text, const Point2f& bottomLeft, float ptSize, const Color4f& color ) const;
+	float GetTextWidth( const std::string& text, float ptSize ) const;
+	float GetLineHeight( float ptSize ) const;
+	// Bytes of the atlas texture
+	int GetAtlasSize( ) const;
+
+private:
+	struct Glyph
+	{
+		// Position in the atlas, in texels, 0 width for a space
+		float left;
+		float top;
+		float width;
+		float height;
+		// Top-left of the glyph without the spread, relative to the pen position on the baseline, and the pen advance, in texels
+		float offsetLeft;
+		float offsetTop;
+		float advance;
+	};
+
+	static const int m_FirstGlyph{ 32 };
+	static const int m_NrGlyphs{ 95 };
+	// The glyphs are rendered this many times larger than the atlas
+	static const int m_Oversampling{ 4 };
+	// Atlas texels around each glyph, the distances are clamped at this many texels from the outline
+	static const int m_Spread{ 4 };
+	static const int m_AtlasWidth{ 512 };
+
+	// DATA MEMBERS
+	GLuint m_AtlasId;
+	int m_AtlasHeight;
+	int m_AtlasPtSize;
+	float m_LineHeight;
+	// Height of the baseline above the bottom of a line, in texels
+	float m_Baseline;
+	Glyph m_Glyphs[m_NrGlyphs];
+	bool m_CreationOk;
+	mutable std::vector<RenderVertex> m_Vertices;
+
+	// FUNCTIONS
+	void CreateAtlas( const std::string& fontPath );
+	// Distance field of the source pixels of a glyph rendered m_Oversampling times too large, one byte per texel
+	static std::vector<Uint8> GetDistanceField( const SDL_Surface* pGlyph, const SDL_Rect& source, int& width, int& height );
+	// Squared distance of each cell to the nearest cell that is 0 (Felzenszwalb and Huttenlocher)
+	static void TransformDistances( std::vector<float>& grid, int width, int height );
+	static void TransformDistances( const float* pSource, float* pResult, int count, std::vector<int>& parabolas, std::vector<float>& bounds );
+};
@@ -0,0 +1,58 @@
+#include "stdafx.h"
+#include "StartupProfile.h"
+#include <fstream>
+#include <iomanip>
+
+StartupProfile::StartupProfile( )
+	:m_Start{ SDL_GetPerformanceCounter( ) }
+	,m_LastStep{ m_Start }
+{
+}
+
+void StartupProfile::AddStep( const std::string& name )
+{
+	const Uint64 now{ SDL_GetPerformanceCounter( ) };
+	m_Steps.push_back( Step{ name, ( now - m_LastStep ) * 1000.0f / SDL_GetPerformanceFrequency( ) } );
+	m_LastStep = now;
+}
+
+float StartupProfile::GetTotalMs( ) const
+{
+	return ( m_LastStep - m_Start ) * 1000.0f / SDL_GetPerformanceFrequency( );
+}
+
+void StartupProfile::Report( std::ostream& os ) const
+{
+	os << "Startup times\n" << std::fixed << std::setprecision( 2 );
+	for ( const Step& step : m_Steps )
+	{
+		os << "  " << std::left << std::setw( 20 ) << step.name << std::right << std::setw( 9 ) << step.ms << " ms\n";
+	}
+	os << "  " << std::left << std::setw( 20 ) << "total" << std::right << std::setw( 9 ) << GetTotalMs( ) << " ms\n";
+	os << std::defaultfloat;
+}
+
+bool StartupProfile::AppendCsv( const std::string& path ) const
+{
+	const bool isNew{ !std::ifstream{ path } };
+	std::ofstream file{ path, std::ios::app };
+	if ( !file )
+	{
+		return false;
+	}
+
+	if ( isNew )
+	{
+		for ( const Step& step : m_Steps )
+		{
+			file << step.name << ',';
+		}
+		file << "total\n";
+	}
+	for ( const Step& step : m_Steps )
+	{
+		file << step.ms << ',';
+	}
+	file << GetTotalMs( ) << '\n';
+	return bool( file );
+}
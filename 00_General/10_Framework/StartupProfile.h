@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <ostream>
+
+// Durations of the start-up steps, from the construction of the profile to the first frame.
+// Each step lasts from the end of the previous one until AddStep is called with its name.
+class StartupProfile
+{
+public:
+	StartupProfile( );
+
+	void AddStep( const std::string& name );
+	float GetTotalMs( ) const;
+
+	void Report( std::ostream& os ) const;
+	// Appends one line with the duration of each step, writing the step names first when the file is new,
+	// so repeated runs build a time series
+	bool AppendCsv( const std::string& path ) const;
+
+private:
+	struct Step
+	{
+		std::string name;
+		float ms;
+	};
+
+	// DATA MEMBERS
+	Uint64 m_Start;
+	Uint64 m_LastStep;
+	std::vector<Step> m_Steps;
+};
@@ -0,0 +1,279 @@
+#include "stdafx.h"
+#include "StateHistory.h"
+#include <iostream>
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+
+StateHistory::StateHistory( int maxFrames, size_t bufferSize, int keyFrameInterval )
+	:m_StateSize{ 0 }
+	,m_Frames( maxFrames > 0 ? maxFrames : 1 )
+	,m_FirstFrame{ 0 }
+	,m_NrFrames{ 0 }
+	,m_Buffer( bufferSize / sizeof( Uint32 ) )
+	,m_WritePos{ 0 }
+	,m_KeyFrameInterval{ keyFrameInterval > 0 ? keyFrameInterval : 1 }
+	,m_FramesSinceKeyFrame{ 0 }
+	,m_LastFrameSize{ 0 }
+	,m_LastCaptureMs{ 0.0f }
+{
+}
+
+void StateHistory::AddRegion( void* pData, size_t size )
+{
+	m_Regions.push_back( Region{ static_cast<char*>( pData ), size } );
+	m_StateSize += size;
+	ResizeStates( );
+	Clear( );
+}
+
+void StateHistory::Clear( )
+{
+	m_FirstFrame = 0;
+	m_NrFrames = 0;
+	m_WritePos = 0;
+	m_FramesSinceKeyFrame = 0;
+}
+
+void StateHistory::ResizeStates( )
+{
+	// Round up to whole words, the padding stays 0
+	const size_t nrWords{ ( m_StateSize + sizeof( Uint32 ) - 1 ) / sizeof( Uint32 ) };
+	m_Previous.assign( nrWords, 0 );
+	m_Current.assign( nrWords, 0 );
+	// Worst case encoding: one run header and all words
+	m_Encoded.assign( nrWords + 2, 0 );
+}
+
+void StateHistory::Capture( )
+{
+	std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now( ) };
+
+	// Gather the regions
+	char* pState{ reinterpret_cast<char*>( m_Current.data( ) ) };
+	for ( const Region& region : m_Regions )
+	{
+		std::memcpy( pState, region.pData, region.size );
+		pState += region.size;
+	}
+
+	// Key frames are encoded against an all zero state, so they are complete
+	bool isKeyFrame{ m_NrFrames == 0 || m_FramesSinceKeyFrame + 1 >= m_KeyFrameInterval };
+	size_t size{ Encode( m_Current, isKeyFrame ? nullptr : &m_Previous ) };
+	if ( Store( size, isKeyFrame ) )
+	{
+		m_FramesSinceKeyFrame = isKeyFrame ? 0 : m_FramesSinceKeyFrame + 1;
+	}
+	m_Previous.swap( m_Current );
+
+	m_LastFrameSize = size * sizeof( Uint32 );
+	m_LastCaptureMs = std::chrono::duration<float, std::milli>( std::chrono::steady_clock::now( ) - start ).count( );
+}
+
+bool StateHistory::Restore( int framesAgo )
+{
+	if ( !Reconstruct( framesAgo ) )
+	{
+		return false;
+	}
+	Scatter( m_Current );
+	return true;
+}
+
+bool StateHistory::Rewind( int framesAgo )
+{
+	if ( !Reconstruct( framesAgo ) )
+	{
+		return false;
+	}
+	Scatter( m_Current );
+
+	// Drop the newer frames and continue writing after the restored one
+	m_NrFrames -= framesAgo;
+	const Frame& newest{ GetFrame( m_NrFrames - 1 ) };
+	m_WritePos = newest.offset + newest.size;
+	m_FramesSinceKeyFrame = 0;
+	for ( int age{ m_NrFrames - 1 }; !GetFrame( age ).isKeyFrame; --age )
+	{
+		++m_FramesSinceKeyFrame;
+	}
+	m_Previous.swap( m_Current );
+	return true;
+}
+
+int StateHistory::GetNrFrames( ) const
+{
+	return m_NrFrames;
+}
+
+size_t StateHistory::GetStateSize( ) const
+{
+	return m_StateSize;
+}
+
+size_t StateHistory::GetLastFrameSize( ) const
+{
+	return m_LastFrameSize;
+}
+
+float StateHistory::GetLastCaptureMs( ) const
+{
+	return m_LastCaptureMs;
+}
+
+size_t StateHistory::Encode( const std::vector<Uint32>& state, const std::vector<Uint32>* pReference )
+{
+	// Runs of: number of unchanged words to skip, number of changed words, the changed words XOR the reference
+	const size_t nrWords{ state.size( ) };
+	size_t size{ 0 };
+	size_t idx{ 0 };
+	while ( idx < nrWords )
+	{
+		size_t skipStart{ idx };
+		while ( idx < nrWords && ( state[idx] ^ ( pReference ? ( *pReference )[idx] : 0 ) ) == 0 )
+		{
+			++idx;
+		}
+		if ( idx == nrWords )
+		{
+			break;
+		}
+
+		// A single unchanged word doesn't end a run, that would cost more than storing it
+		size_t header{ size };
+		size += 2;
+		size_t literalStart{ idx };
+		while ( idx < nrWords )
+		{
+			Uint32 delta{ state[idx] ^ ( pReference ? ( *pReference )[idx] : 0 ) };
+			if ( delta == 0 && ( idx + 1 == nrWords || ( state[idx + 1] ^ ( pReference ? ( *pReference )[idx + 1] : 0 ) ) == 0 ) )
+			{
+				break;
+			}
+			m_Encoded[size++] = delta;
+			++idx;
+		}
+		m_Encoded[header] = Uint32( literalStart - skipStart );
+		m_Encoded[header + 1] = Uint32( idx - literalStart );
+	}
+	return size;
+}
+
+void StateHistory::Decode( const Frame& frame, std::vector<Uint32>& state ) const
+{
+	const Uint32* pRun{ m_Buffer.data( ) + frame.offset };
+	const Uint32* pEnd{ pRun + frame.size };
+	size_t idx{ 0 };
+	while ( pRun < pEnd )
+	{
+		idx += pRun[0];
+		const Uint32 nrLiterals{ pRun[1] };
+		pRun += 2;
+		for ( Uint32 literal{ 0 }; literal < nrLiterals; ++literal )
+		{
+			state[idx++] ^= *pRun++;
+		}
+	}
+}
+
+bool StateHistory::Store( size_t& size, bool& isKeyFrame )
+{
+	if ( size > m_Buffer.size( ) )
+	{
+		std::cerr << "StateHistory::Capture( ), frame of " << size * sizeof( Uint32 ) << " bytes doesn't fit in the buffer of "
+			<< m_Buffer.size( ) * sizeof( Uint32 ) << " bytes\n";
+		Clear( );
+		return false;
+	}
+
+	// Frames are never split: start over at the beginning when the frame doesn't fit at the end.
+	// Any frame still behind the write position then is older than the ones at the beginning.
+	size_t offset{ m_WritePos };
+	if ( offset + size > m_Buffer.size( ) )
+	{
+		offset = 0;
+		while ( m_NrFrames > 0 && GetFrame( 0 ).offset >= m_WritePos )
+		{
+			DropOldestFrame( );
+		}
+	}
+	while ( m_NrFrames > 0 && IsOverlapping( GetFrame( 0 ), offset, size ) )
+	{
+		DropOldestFrame( );
+	}
+	if ( m_NrFrames == int( m_Frames.size( ) ) )
+	{
+		DropOldestFrame( );
+	}
+
+	// All frames were dropped, including the key frame this delta frame needs: store a key frame instead
+	if ( m_NrFrames == 0 && !isKeyFrame )
+	{
+		m_WritePos = 0;
+		isKeyFrame = true;
+		size = Encode( m_Current, nullptr );
+		return Store( size, isKeyFrame );
+	}
+
+	std::memcpy( m_Buffer.data( ) + offset, m_Encoded.data( ), size * sizeof( Uint32 ) );
+	m_Frames[( m_FirstFrame + m_NrFrames ) % m_Frames.size( )] = Frame{ offset, size, isKeyFrame };
+	++m_NrFrames;
+	m_WritePos = offset + size;
+	return true;
+}
+
+void StateHistory::DropOldestFrame( )
+{
+	// Delta frames can't be decoded without the key frame before them, so drop those too
+	do
+	{
+		m_FirstFrame = ( m_FirstFrame + 1 ) % m_Frames.size( );
+		--m_NrFrames;
+	}
+	while ( m_NrFrames > 0 && !GetFrame( 0 ).isKeyFrame );
+}
+
+bool StateHistory::IsOverlapping( const Frame& frame, size_t offset, size_t size ) const
+{
+	// A frame without changes has size 0, it still has to go when its position is written
+	const bool startsInside{ frame.offset >= offset && frame.offset < offset + size };
+	const bool endsInside{ frame.offset < offset && frame.offset + frame.size > offset };
+	return startsInside || endsInside;
+}
+
+const StateHistory::Frame& StateHistory::GetFrame( int age ) const
+{
+	return m_Frames[( m_FirstFrame + age ) % m_Frames.size( )];
+}
+
+bool StateHistory::Reconstruct( int framesAgo )
+{
+	if ( framesAgo < 0 || framesAgo >= m_NrFrames )
+	{
+		return false;
+	}
+
+	// Start from the key frame at or before the requested one and apply the deltas after it
+	const int target{ m_NrFrames - 1 - framesAgo };
+	int age{ target };
+	while ( !GetFrame( age ).isKeyFrame )
+	{
+		--age;
+	}
+	std::fill( m_Current.begin( ), m_Current.end( ), 0 );
+	for ( ; age <= target; ++age )
+	{
+		Decode( GetFrame( age ), m_Current );
+	}
+	return true;
+}
+
+void StateHistory::Scatter( const std::vector<Uint32>& state )
+{
+	const char* pState{ reinterpret_cast<const char*>( state.data( ) ) };
+	for ( const Region& region : m_Regions )
+	{
+		std::memcpy( region.pData, pState, region.size );
+		pState += region.size;
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <vector>
+
+// Keeps the last frames of the simulation state, for replays, debugging and rewinding.
+// The state consists of registered memory regions, e.g.
+//		StateHistory history{ 600, 16 * 1024 * 1024 };
+//		history.AddRegion( g_Balls, sizeof( g_Balls ) );
+//		...
+//		history.Capture( );		// once per Update
+//		history.Rewind( 60 );	// back one second at 60 fps
+// Only trivially copyable data can be registered (no pointers to heap memory, no std::string, ...).
+//
+// Frames are stored in one ring buffer, the oldest frames are dropped when it is full.
+// Each frame is the XOR with the previous frame with runs of unchanged words left out,
+// every keyFrameInterval frames a complete key frame is stored instead.
+// Restoring decodes the nearest key frame and the deltas after it, so its cost
+// is proportional to the state size. Capture and restore don't allocate memory.
+class StateHistory
+{
+public:
+	// maxFrames: maximum number of frames kept, bufferSize: bytes available for all frames
+	explicit StateHistory( int maxFrames, size_t bufferSize, int keyFrameInterval = 30 );
+	StateHistory( const StateHistory& other ) = delete;
+	StateHistory& operator=( const StateHistory& other ) = delete;
+
+	// Registering a region clears the history
+	void AddRegion( void* pData, size_t size );
+	void Clear( );
+
+	// Stores the current content of the regions as the newest frame
+	void Capture( );
+	// Copies a stored frame back into the regions, 0 being the newest frame
+	bool Restore( int framesAgo );
+	// Restores a frame and drops the newer ones, so capturing continues from that frame
+	bool Rewind( int framesAgo );
+
+	int GetNrFrames( ) const;
+	size_t GetStateSize( ) const;
+	// Statistics of the last Capture
+	size_t GetLastFrameSize( ) const;
+	float GetLastCaptureMs( ) const;
+
+private:
+	struct Region
+	{
+		char* pData;
+		size_t size;
+	};
+	struct Frame
+	{
+		// Offset and size in m_Buffer, in words
+		size_t offset;
+		size_t size;
+		bool isKeyFrame;
+	};
+
+	// DATA MEMBERS
+	std::vector<Region> m_Regions;
+	size_t m_StateSize;
+	// The frames, oldest one at m_FirstFrame
+	std::vector<Frame> m_Frames;
+	int m_FirstFrame;
+	int m_NrFrames;
+	// Encoded frames
+	std::vector<Uint32> m_Buffer;
+	size_t m_WritePos;
+	int m_KeyFrameInterval;
+	int m_FramesSinceKeyFrame;
+	// State of the newest frame, the state being captured or restored, an encoded frame
+	std::vector<Uint32> m_Previous;
+	std::vector<Uint32> m_Current;
+	std::vector<Uint32> m_Encoded;
+
+	size_t m_LastFrameSize;
+	float m_LastCaptureMs;
+
+	// FUNCTIONS
+	void ResizeStates( );
+	size_t Encode( const std::vector<Uint32>& state, const std::vector<Uint32>* pReference );
+	void Decode( const Frame& frame, std::vector<Uint32>& state ) const;
+	bool Store( size_t& size, bool& isKeyFrame );
+	void DropOldestFrame( );
+	bool IsOverlapping( const Frame& frame, size_t offset, size_t size ) const;
+	const Frame& GetFrame( int age ) const;
+	bool Reconstruct( int framesAgo );
+	void Scatter( const std::vector<Uint32>& state );
+};
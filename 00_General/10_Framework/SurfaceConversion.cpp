@@ -0,0 +1,219 @@
+#include "stdafx.h"
+#include "SurfaceConversion.h"
+#include <iostream>
+
+#if defined( _M_X64 ) || defined( _M_IX86 ) || defined( __x86_64__ ) || defined( __i386__ )
+#define DAE_X86
+#include <emmintrin.h>
+#include <tmmintrin.h>
+// SSSE3 is chosen at run time, gcc and clang have to be told these functions may use it
+#if defined( __GNUC__ )
+#define DAE_TARGET_SSSE3 __attribute__( ( target( "ssse3" ) ) )
+#define DAE_TARGET_SSE2 __attribute__( ( target( "sse2" ) ) )
+#else
+#define DAE_TARGET_SSSE3
+#define DAE_TARGET_SSE2
+#endif
+#endif
+
+namespace dae
+{
+	namespace
+	{
+		// Byte of each channel within a source pixel, a is -1 when the format has no alpha
+		struct ChannelBytes
+		{
+			int r;
+			int g;
+			int b;
+			int a;
+		};
+
+		// Only 8 bit channels on byte boundaries
+		int GetChannelByte( Uint32 mask, Uint8 shift, int bytesPerPixel )
+		{
+			if ( shift % 8 != 0 || mask != Uint32( 0xff ) << shift )
+			{
+				return -2;
+			}
+			// The masks describe the pixel as a native integer
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+			return bytesPerPixel - 1 - shift / 8;
+#else
+			( void )bytesPerPixel;
+			return shift / 8;
+#endif
+		}
+
+		bool GetChannelBytes( const SDL_PixelFormat* pFormat, ChannelBytes& channels )
+		{
+			const int bytesPerPixel{ pFormat->BytesPerPixel };
+			if ( bytesPerPixel != 3 && bytesPerPixel != 4 )
+			{
+				return false;
+			}
+			channels.r = GetChannelByte( pFormat->Rmask, pFormat->Rshift, bytesPerPixel );
+			channels.g = GetChannelByte( pFormat->Gmask, pFormat->Gshift, bytesPerPixel );
+			channels.b = GetChannelByte( pFormat->Bmask, pFormat->Bshift, bytesPerPixel );
+			channels.a = pFormat->Amask == 0 ? -1 : GetChannelByte( pFormat->Amask, pFormat->Ashift, bytesPerPixel );
+			return channels.r >= 0 && channels.g >= 0 && channels.b >= 0 && channels.a >= -1;
+		}
+
+		void ConvertRow( const Uint8* pSource, Uint8* pResult, int from, int to, int bytesPerPixel, const ChannelBytes& channels )
+		{
+			for ( int x{ from }; x < to; ++x )
+			{
+				const Uint8* pPixel{ pSource + x * bytesPerPixel };
+				Uint8* pRgba{ pResult + x * 4 };
+				pRgba[0] = pPixel[channels.r];
+				pRgba[1] = pPixel[channels.g];
+				pRgba[2] = pPixel[channels.b];
+				pRgba[3] = channels.a >= 0 ? pPixel[channels.a] : 255;
+			}
+		}
+
+		// x * alpha / 255, rounded
+		Uint8 MultiplyByAlpha( Uint8 value, Uint8 alpha )
+		{
+			const Uint32 product{ Uint32( value ) * alpha + 128 };
+			return Uint8( ( product + ( product >> 8 ) ) >> 8 );
+		}
+
+#ifdef DAE_X86
+		bool HasSsse3( )
+		{
+			static const bool hasSsse3{ SDL_HasSSSE3( ) == SDL_TRUE };
+			return hasSsse3;
+		}
+
+		bool HasSse2( )
+		{
+			static const bool hasSse2{ SDL_HasSSE2( ) == SDL_TRUE };
+			return hasSse2;
+		}
+
+		// Returns the first pixel that wasn't converted
+		DAE_TARGET_SSSE3 int ConvertRowSsse3( const Uint8* pSource, Uint8* pResult, int width, int bytesPerPixel, const ChannelBytes& channels )
+		{
+			// Source byte of each result byte for 4 pixels, 0x80 gives 0
+			alignas( 16 ) Uint8 shuffle[16];
+			alignas( 16 ) Uint8 opaque[16]{};
+			for ( int pixel{ 0 }; pixel < 4; ++pixel )
+			{
+				shuffle[pixel * 4 + 0] = Uint8( pixel * bytesPerPixel + channels.r );
+				shuffle[pixel * 4 + 1] = Uint8( pixel * bytesPerPixel + channels.g );
+				shuffle[pixel * 4 + 2] = Uint8( pixel * bytesPerPixel + channels.b );
+				shuffle[pixel * 4 + 3] = channels.a >= 0 ? Uint8( pixel * bytesPerPixel + channels.a ) : Uint8( 0x80 );
+				opaque[pixel * 4 + 3] = channels.a >= 0 ? 0 : 0xff;
+			}
+			const __m128i shuffleMask{ _mm_load_si128( reinterpret_cast<const __m128i*>( shuffle ) ) };
+			const __m128i opaqueMask{ _mm_load_si128( reinterpret_cast<const __m128i*>( opaque ) ) };
+
+			// Each step loads 16 bytes: 4 pixels and, for 24 bit pixels, 4 bytes that must still be in the row
+			const int lastStart{ width - ( 16 + bytesPerPixel - 1 ) / bytesPerPixel };
+			int x{ 0 };
+			for ( ; x <= lastStart; x += 4 )
+			{
+				const __m128i source{ _mm_loadu_si128( reinterpret_cast<const __m128i*>( pSource + x * bytesPerPixel ) ) };
+				const __m128i rgba{ _mm_or_si128( _mm_shuffle_epi8( source, shuffleMask ), opaqueMask ) };
+				_mm_storeu_si128( reinterpret_cast<__m128i*>( pResult + x * 4 ), rgba );
+			}
+			return x;
+		}
+
+		// 2 pixels as 16 bit channels
+		DAE_TARGET_SSE2 __m128i MultiplyByAlpha( __m128i pixels )
+		{
+			// The alpha of each pixel in its 4 channels, with 255 for the alpha channel itself so alpha stays the same
+			__m128i alpha{ _mm_shufflehi_epi16( _mm_shufflelo_epi16( pixels, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 3, 3, 3, 3 ) ) };
+			alpha = _mm_or_si128( _mm_and_si128( alpha, _mm_set_epi16( 0, -1, -1, -1, 0, -1, -1, -1 ) ), _mm_set_epi16( 255, 0, 0, 0, 255, 0, 0, 0 ) );
+			const __m128i product{ _mm_add_epi16( _mm_mullo_epi16( pixels, alpha ), _mm_set1_epi16( 128 ) ) };
+			return _mm_srli_epi16( _mm_add_epi16( product, _mm_srli_epi16( product, 8 ) ), 8 );
+		}
+
+		DAE_TARGET_SSE2 size_t PremultiplyAlphaSse2( Uint8* pRgba, size_t nrPixels )
+		{
+			const __m128i zero{ _mm_setzero_si128( ) };
+			size_t pixel{ 0 };
+			for ( ; pixel + 4 <= nrPixels; pixel += 4 )
+			{
+				__m128i* pPixels{ reinterpret_cast<__m128i*>( pRgba + pixel * 4 ) };
+				const __m128i pixels{ _mm_loadu_si128( pPixels ) };
+				const __m128i low{ MultiplyByAlpha( _mm_unpacklo_epi8( pixels, zero ) ) };
+				const __m128i high{ MultiplyByAlpha( _mm_unpackhi_epi8( pixels, zero ) ) };
+				_mm_storeu_si128( pPixels, _mm_packus_epi16( low, high ) );
+			}
+			return pixel;
+		}
+#endif
+	}
+
+	bool ConvertToRgba8( const SDL_Surface* pSurface, std::vector<Uint8>& rgba, bool premultiplyAlpha )
+	{
+		ChannelBytes channels{};
+		if ( !GetChannelBytes( pSurface->format, channels ) )
+		{
+			// Palettes, 16 bit, 10 bit channels...: SDL_PIXELFORMAT_ABGR8888 is R, G, B, A in memory on little endian processors
+			SDL_Surface* pConverted{ SDL_ConvertSurfaceFormat( const_cast<SDL_Surface*>( pSurface ), SDL_PIXELFORMAT_ABGR8888, 0 ) };
+			if ( pConverted == nullptr || !GetChannelBytes( pConverted->format, channels ) )
+			{
+				std::cerr << "dae::ConvertToRgba8( ), can't convert the pixel format, BytesPerPixel: " << int( pSurface->format->BytesPerPixel )
+					<< ", " << SDL_GetError( ) << '\n';
+				SDL_FreeSurface( pConverted );
+				return false;
+			}
+			const bool isConverted{ ConvertToRgba8( pConverted, rgba, premultiplyAlpha ) };
+			SDL_FreeSurface( pConverted );
+			return isConverted;
+		}
+
+		const int width{ pSurface->w };
+		const int height{ pSurface->h };
+		const int bytesPerPixel{ pSurface->format->BytesPerPixel };
+		rgba.resize( size_t( width ) * height * 4 );
+		for ( int y{ 0 }; y < height; ++y )
+		{
+			const Uint8* pSource{ static_cast<const Uint8*>( pSurface->pixels ) + size_t( y ) * pSurface->pitch };
+			Uint8* pResult{ rgba.data( ) + size_t( y ) * width * 4 };
+			int x{ 0 };
+#ifdef DAE_X86
+			if ( HasSsse3( ) )
+			{
+				x = ConvertRowSsse3( pSource, pResult, width, bytesPerPixel, channels );
+			}
+#endif
+			ConvertRow( pSource, pResult, x, width, bytesPerPixel, channels );
+		}
+
+		if ( premultiplyAlpha && channels.a >= 0 )
+		{
+			PremultiplyAlpha( rgba.data( ), size_t( width ) * height );
+		}
+		return true;
+	}
+
+	bool IsRgba8( const SDL_Surface* pSurface )
+	{
+		ChannelBytes channels{};
+		return GetChannelBytes( pSurface->format, channels ) && pSurface->format->BytesPerPixel == 4 && pSurface->pitch == pSurface->w * 4
+			&& channels.r == 0 && channels.g == 1 && channels.b == 2 && channels.a == 3;
+	}
+
+	void PremultiplyAlpha( Uint8* pRgba, size_t nrPixels )
+	{
+		size_t pixel{ 0 };
+#ifdef DAE_X86
+		if ( HasSse2( ) )
+		{
+			pixel = PremultiplyAlphaSse2( pRgba, nrPixels );
+		}
+#endif
+		for ( ; pixel < nrPixels; ++pixel )
+		{
+			Uint8* pPixel{ pRgba + pixel * 4 };
+			pPixel[0] = MultiplyByAlpha( pPixel[0], pPixel[3] );
+			pPixel[1] = MultiplyByAlpha( pPixel[1], pPixel[3] );
+			pPixel[2] = MultiplyByAlpha( pPixel[2], pPixel[3] );
+		}
+	}
+}
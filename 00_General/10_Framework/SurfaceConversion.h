@@ -0,0 +1,19 @@
+#pragma once
+#include <vector>
+
+// Turns any SDL_Surface into tightly packed RGBA8: 4 bytes per pixel in the order R, G, B, A, rows without padding.
+// That is the layout of a GL_RGBA8 texture, so glTexImage2D( ..., GL_RGBA, GL_UNSIGNED_BYTE, ... ) is a plain copy
+// for the driver, whatever the width: rows of 4 byte pixels always meet the default GL_UNPACK_ALIGNMENT of 4.
+//
+// 24 and 32 bit surfaces with 8 bit channels (RGB, BGR, RGBA, BGRA, ARGB, ...) are converted with SSSE3 byte shuffles
+// when the processor has them, 4 pixels at a time. Other surfaces (palettes, 16 bit) are converted by SDL first.
+namespace dae
+{
+	// pitch is honored. premultiplyAlpha multiplies the color channels by alpha, for blending with
+	// glBlendFunc( GL_ONE, GL_ONE_MINUS_SRC_ALPHA ): filtering then doesn't bleed the color of transparent texels.
+	// Returns false when SDL can't convert the surface
+	bool ConvertToRgba8( const SDL_Surface* pSurface, std::vector<Uint8>& rgba, bool premultiplyAlpha = false );
+	void PremultiplyAlpha( Uint8* pRgba, size_t nrPixels );
+	// Already tightly packed RGBA8: its pixels can be uploaded as they are
+	bool IsRgba8( const SDL_Surface* pSurface );
+}
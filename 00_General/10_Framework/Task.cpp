@@ -0,0 +1,398 @@
+#include "stdafx.h"
+#include "Task.h"
+#include <iostream>
+#include <exception>
+#include <new>
+
+namespace
+{
+	// Coroutine frame pool: free lists per size class of 64 bytes, larger frames use the heap.
+	// Frames are only allocated and freed on the thread that runs Game::Update.
+	const size_t g_FrameAlignment{ 64 };
+	const int g_NrSizeClasses{ 16 };
+	const int g_FramesPerChunk{ 64 };
+
+	struct FreeFrame
+	{
+		FreeFrame* pNext;
+	};
+	FreeFrame* g_pFreeFrames[g_NrSizeClasses]{ };
+	std::vector<void*> g_Chunks;
+	size_t g_FramePoolSize{ 0 };
+
+	struct ChunkReleaser
+	{
+		~ChunkReleaser( )
+		{
+			for ( void* pChunk : g_Chunks )
+			{
+				::operator delete( pChunk );
+			}
+		}
+	};
+	ChunkReleaser g_ChunkReleaser;
+
+	int GetSizeClass( size_t size )
+	{
+		return int( ( size + g_FrameAlignment - 1 ) / g_FrameAlignment ) - 1;
+	}
+
+	void* AllocateFrame( size_t size )
+	{
+		const int sizeClass{ GetSizeClass( size ) };
+		if ( sizeClass >= g_NrSizeClasses )
+		{
+			return ::operator new( size );
+		}
+		if ( g_pFreeFrames[sizeClass] == nullptr )
+		{
+			// Carve a new chunk into frames of this size class
+			const size_t frameSize{ ( sizeClass + 1 ) * g_FrameAlignment };
+			char* pChunk{ static_cast<char*>( ::operator new( frameSize * g_FramesPerChunk ) ) };
+			g_Chunks.push_back( pChunk );
+			g_FramePoolSize += frameSize * g_FramesPerChunk;
+			for ( int idx{ g_FramesPerChunk - 1 }; idx >= 0; --idx )
+			{
+				FreeFrame* pFrame{ reinterpret_cast<FreeFrame*>( pChunk + idx * frameSize ) };
+				pFrame->pNext = g_pFreeFrames[sizeClass];
+				g_pFreeFrames[sizeClass] = pFrame;
+			}
+		}
+		FreeFrame* pFrame{ g_pFreeFrames[sizeClass] };
+		g_pFreeFrames[sizeClass] = pFrame->pNext;
+		return pFrame;
+	}
+
+	void FreeFrameMemory( void* pMemory, size_t size )
+	{
+		const int sizeClass{ GetSizeClass( size ) };
+		if ( sizeClass >= g_NrSizeClasses )
+		{
+			::operator delete( pMemory );
+			return;
+		}
+		FreeFrame* pFrame{ static_cast<FreeFrame*>( pMemory ) };
+		pFrame->pNext = g_pFreeFrames[sizeClass];
+		g_pFreeFrames[sizeClass] = pFrame;
+	}
+}
+
+//-----------------------------------------------------------------
+// Task
+//-----------------------------------------------------------------
+Task::Task( std::coroutine_handle<TaskPromise> handle )
+	:m_Handle{ handle }
+{
+}
+
+Task::Task( Task&& other ) noexcept
+	:m_Handle{ other.m_Handle }
+{
+	other.m_Handle = nullptr;
+}
+
+Task::~Task( )
+{
+	if ( m_Handle )
+	{
+		m_Handle.destroy( );
+	}
+}
+
+//-----------------------------------------------------------------
+// TaskPromise
+//-----------------------------------------------------------------
+TaskPromise::TaskPromise( )
+	:pScheduler{ nullptr }
+	,slot{ -1 }
+{
+}
+
+Task TaskPromise::get_return_object( )
+{
+	return Task{ std::coroutine_handle<TaskPromise>::from_promise( *this ) };
+}
+
+std::suspend_always TaskPromise::initial_suspend( ) noexcept
+{
+	return std::suspend_always{ };
+}
+
+std::suspend_always TaskPromise::final_suspend( ) noexcept
+{
+	return std::suspend_always{ };
+}
+
+void TaskPromise::return_void( )
+{
+}
+
+void TaskPromise::unhandled_exception( )
+{
+	std::cerr << "Task, unhandled exception in a task\n";
+	std::terminate( );
+}
+
+void* TaskPromise::operator new( size_t size )
+{
+	return AllocateFrame( size );
+}
+
+void TaskPromise::operator delete( void* pFrame, size_t size )
+{
+	FreeFrameMemory( pFrame, size );
+}
+
+//-----------------------------------------------------------------
+// Awaitables
+//-----------------------------------------------------------------
+bool NextFrame::await_ready( ) const
+{
+	return false;
+}
+
+void NextFrame::await_suspend( std::coroutine_handle<TaskPromise> handle ) const
+{
+	handle.promise( ).pScheduler->WaitNextFrame( handle.promise( ).slot );
+}
+
+void NextFrame::await_resume( ) const
+{
+}
+
+Seconds::Seconds( float seconds )
+	:seconds{ seconds }
+{
+}
+
+bool Seconds::await_ready( ) const
+{
+	return false;
+}
+
+void Seconds::await_suspend( std::coroutine_handle<TaskPromise> handle ) const
+{
+	handle.promise( ).pScheduler->WaitSeconds( handle.promise( ).slot, seconds );
+}
+
+void Seconds::await_resume( ) const
+{
+}
+
+Until::Until( std::function<bool( )> predicate )
+	:predicate{ std::move( predicate ) }
+{
+}
+
+bool Until::await_ready( ) const
+{
+	return predicate( );
+}
+
+void Until::await_suspend( std::coroutine_handle<TaskPromise> handle )
+{
+	handle.promise( ).predicate = std::move( predicate );
+	handle.promise( ).pScheduler->WaitUntil( handle.promise( ).slot );
+}
+
+void Until::await_resume( ) const
+{
+}
+
+//-----------------------------------------------------------------
+// TaskScheduler
+//-----------------------------------------------------------------
+TaskScheduler::TaskScheduler( TimerWheel& timers )
+	:m_Timers{ timers }
+	,m_FirstFree{ m_NoSlot }
+	,m_NrTasks{ 0 }
+{
+}
+
+TaskScheduler::~TaskScheduler( )
+{
+	Clear( );
+}
+
+TaskHandle TaskScheduler::Start( Task&& task )
+{
+	if ( !task.m_Handle )
+	{
+		return TaskHandle{ };
+	}
+
+	int slot{ m_FirstFree };
+	if ( slot == m_NoSlot )
+	{
+		if ( m_Slots.size( ) >= TaskHandle::indexMask )
+		{
+			std::cerr << "TaskScheduler::Start( ), too many tasks, maximum is " << TaskHandle::indexMask - 1 << '\n';
+			return TaskHandle{ };
+		}
+		slot = int( m_Slots.size( ) );
+		// Generation 0 is never used, so no handle has id 0
+		m_Slots.push_back( Slot{ nullptr, m_NoSlot, 1, false, false } );
+	}
+	else
+	{
+		m_FirstFree = m_Slots[slot].nextFree;
+	}
+
+	m_Slots[slot].handle = task.m_Handle;
+	task.m_Handle = nullptr;
+	TaskPromise& promise{ m_Slots[slot].handle.promise( ) };
+	promise.pScheduler = this;
+	promise.slot = slot;
+	++m_NrTasks;
+
+	const TaskHandle handle{ unsigned( slot ), m_Slots[slot].generation };
+	Resume( slot );
+	return handle;
+}
+
+bool TaskScheduler::Stop( TaskHandle handle )
+{
+	const int slot{ GetSlot( handle ) };
+	if ( slot < 0 )
+	{
+		return false;
+	}
+	if ( m_Slots[slot].isRunning )
+	{
+		std::cerr << "TaskScheduler::Stop( ), a task can't stop itself, use co_return\n";
+		return false;
+	}
+	Free( slot );
+	return true;
+}
+
+bool TaskScheduler::IsRunning( TaskHandle handle ) const
+{
+	return GetSlot( handle ) >= 0;
+}
+
+void TaskScheduler::Clear( )
+{
+	for ( int slot{ 0 }; slot < int( m_Slots.size( ) ); ++slot )
+	{
+		if ( m_Slots[slot].isRunning )
+		{
+			// Destroying a coroutine that is running is undefined, Resume frees it
+			m_Slots[slot].isStopping = true;
+		}
+		else if ( m_Slots[slot].handle )
+		{
+			Free( slot );
+		}
+	}
+	m_NextFrame.clear( );
+	m_Until.clear( );
+}
+
+void TaskScheduler::Update( )
+{
+	// Tasks that wait for the next frame again go to the new list
+	m_Resuming.clear( );
+	m_Resuming.swap( m_NextFrame );
+	for ( const Waiting& waiting : m_Resuming )
+	{
+		if ( m_Slots[waiting.slot].generation == waiting.generation && m_Slots[waiting.slot].handle )
+		{
+			Resume( waiting.slot );
+		}
+	}
+
+	m_Resuming.clear( );
+	m_Resuming.swap( m_Until );
+	for ( const Waiting& waiting : m_Resuming )
+	{
+		if ( m_Slots[waiting.slot].generation != waiting.generation || !m_Slots[waiting.slot].handle )
+		{
+			continue;
+		}
+		TaskPromise& promise{ m_Slots[waiting.slot].handle.promise( ) };
+		if ( promise.predicate( ) )
+		{
+			promise.predicate = nullptr;
+			Resume( waiting.slot );
+		}
+		else
+		{
+			m_Until.push_back( waiting );
+		}
+	}
+	m_Resuming.clear( );
+}
+
+int TaskScheduler::GetNrTasks( ) const
+{
+	return m_NrTasks;
+}
+
+size_t TaskScheduler::GetFramePoolSize( )
+{
+	return g_FramePoolSize;
+}
+
+int TaskScheduler::GetSlot( TaskHandle handle ) const
+{
+	const unsigned int slot{ handle.GetIndex( ) };
+	if ( !handle.IsValid( ) || slot >= m_Slots.size( ) )
+	{
+		return -1;
+	}
+	if ( !m_Slots[slot].handle || m_Slots[slot].generation != handle.GetGeneration( ) )
+	{
+		return -1;
+	}
+	return int( slot );
+}
+
+void TaskScheduler::Resume( int slot )
+{
+	// Copy the handle, the task can start other tasks and so grow m_Slots
+	const std::coroutine_handle<TaskPromise> handle{ m_Slots[slot].handle };
+	m_Slots[slot].isRunning = true;
+	handle.resume( );
+	m_Slots[slot].isRunning = false;
+	if ( handle.done( ) || m_Slots[slot].isStopping )
+	{
+		Free( slot );
+	}
+}
+
+void TaskScheduler::Free( int slot )
+{
+	Slot& taskSlot{ m_Slots[slot] };
+	m_Timers.Cancel( taskSlot.handle.promise( ).timer );
+	taskSlot.handle.destroy( );
+	taskSlot.handle = nullptr;
+	taskSlot.isStopping = false;
+	taskSlot.generation = TaskHandle::GetNextGeneration( taskSlot.generation );
+	taskSlot.nextFree = m_FirstFree;
+	m_FirstFree = slot;
+	--m_NrTasks;
+}
+
+void TaskScheduler::WaitNextFrame( int slot )
+{
+	m_NextFrame.push_back( Waiting{ slot, m_Slots[slot].generation } );
+}
+
+void TaskScheduler::WaitSeconds( int slot, float seconds )
+{
+	const unsigned int generation{ m_Slots[slot].generation };
+	m_Slots[slot].handle.promise( ).timer = m_Timers.Schedule( seconds, [this, slot, generation]
+	{
+		if ( m_Slots[slot].generation == generation && m_Slots[slot].handle )
+		{
+			m_Slots[slot].handle.promise( ).timer = TimerHandle{ };
+			Resume( slot );
+		}
+	} );
+}
+
+void TaskScheduler::WaitUntil( int slot )
+{
+	m_Until.push_back( Waiting{ slot, m_Slots[slot].generation } );
+}
@@ -0,0 +1,178 @@
+#pragma once
+#include <coroutine>
+#include <functional>
+#include <vector>
+#include "TimerWheel.h"
+#include "GenerationalHandle.h"
+
+class TaskScheduler;
+struct TaskPromise;
+
+// Coroutine for game logic that spans frames, e.g.
+//		Task Game::SpawnWave( )
+//		{
+//			co_await Until{ [this] { return m_IsFadedIn; } };
+//			co_await Seconds{ 2.0f };
+//			for ( int idx{ 0 }; idx < 10; ++idx )
+//			{
+//				SpawnEnemy( );
+//				co_await NextFrame{ };
+//			}
+//		}
+//		m_Tasks.Start( SpawnWave( ) );
+// A task only runs when the TaskScheduler resumes it: a task waiting for Seconds sits in the
+// TimerWheel and costs nothing until it is due, a task waiting for NextFrame or Until is in a list
+// the scheduler goes through once per frame.
+// The coroutine frames come from a pool, starting thousands of tasks doesn't call the heap once the pool is warm.
+class Task
+{
+public:
+	using promise_type = TaskPromise;
+
+	explicit Task( std::coroutine_handle<TaskPromise> handle );
+	Task( const Task& other ) = delete;
+	Task& operator=( const Task& other ) = delete;
+	Task( Task&& other ) noexcept;
+	Task& operator=( Task&& other ) = delete;
+	// Destroys the coroutine when it wasn't started
+	~Task( );
+
+private:
+	friend class TaskScheduler;
+
+	// DATA MEMBERS
+	std::coroutine_handle<TaskPromise> m_Handle;
+};
+
+struct TaskPromise
+{
+	TaskPromise( );
+
+	Task get_return_object( );
+	// Tasks don't run until they are started, and stay suspended at the end so the scheduler can free them
+	std::suspend_always initial_suspend( ) noexcept;
+	std::suspend_always final_suspend( ) noexcept;
+	void return_void( );
+	void unhandled_exception( );
+
+	// Coroutine frames come from the pool
+	static void* operator new( size_t size );
+	static void operator delete( void* pFrame, size_t size );
+
+	TaskScheduler* pScheduler;
+	int slot;
+	// The timer of Seconds, the predicate of Until
+	TimerHandle timer;
+	std::function<bool( )> predicate;
+};
+
+// Awaitables, only for use in a Task
+// Resumes the task in the next frame
+struct NextFrame
+{
+	bool await_ready( ) const;
+	void await_suspend( std::coroutine_handle<TaskPromise> handle ) const;
+	void await_resume( ) const;
+};
+
+// Resumes the task after the given game time, driven by the TimerWheel
+struct Seconds
+{
+	explicit Seconds( float seconds );
+
+	bool await_ready( ) const;
+	void await_suspend( std::coroutine_handle<TaskPromise> handle ) const;
+	void await_resume( ) const;
+
+	float seconds;
+};
+
+// Resumes the task in the first frame the predicate returns true, checked once per frame.
+// Doesn't suspend when it is true already.
+struct Until
+{
+	explicit Until( std::function<bool( )> predicate );
+
+	bool await_ready( ) const;
+	void await_suspend( std::coroutine_handle<TaskPromise> handle );
+	void await_resume( ) const;
+
+	std::function<bool( )> predicate;
+};
+
+// Handle to a started Task, see GenerationalHandle.h. A handle stays safe to use after the task finished
+struct TaskHandle : GenerationalHandle<TaskHandle>
+{
+	using GenerationalHandle::GenerationalHandle;
+};
+
+// Runs the Tasks of the game.
+// Core owns the scheduler: tasks waiting for Seconds resume while Core advances the TimerWheel,
+// the tasks waiting for NextFrame or Until resume in Update, which Core calls right after that.
+// Both happen before Game::Update, on the thread that runs Game::Update.
+class TaskScheduler
+{
+public:
+	explicit TaskScheduler( TimerWheel& timers );
+	TaskScheduler( const TaskScheduler& other ) = delete;
+	TaskScheduler& operator=( const TaskScheduler& other ) = delete;
+	~TaskScheduler( );
+
+	// Runs the task until its first co_await
+	TaskHandle Start( Task&& task );
+	// Destroys a suspended task, a task can't stop itself (co_return instead)
+	bool Stop( TaskHandle handle );
+	bool IsRunning( TaskHandle handle ) const;
+	// Also from a task: the tasks that are running, the caller and the tasks that started it, are destroyed
+	// when they suspend, right after the co_await they reach next
+	void Clear( );
+
+	// Resumes the tasks waiting for NextFrame and the ones waiting for Until whose predicate is true
+	void Update( );
+
+	int GetNrTasks( ) const;
+	// Bytes of coroutine frames allocated from the pool, in use or free
+	static size_t GetFramePoolSize( );
+
+private:
+	friend struct NextFrame;
+	friend struct Seconds;
+	friend struct Until;
+
+	struct Slot
+	{
+		std::coroutine_handle<TaskPromise> handle;
+		// Next free slot while free
+		int nextFree;
+		unsigned int generation;
+		bool isRunning;
+		// Cleared while running, freed when it suspends
+		bool isStopping;
+	};
+	// Entry of a wait list, stale when the generation of the slot changed
+	struct Waiting
+	{
+		int slot;
+		unsigned int generation;
+	};
+
+	static const int m_NoSlot{ -1 };
+
+	// DATA MEMBERS
+	TimerWheel& m_Timers;
+	std::vector<Slot> m_Slots;
+	int m_FirstFree;
+	int m_NrTasks;
+	std::vector<Waiting> m_NextFrame;
+	std::vector<Waiting> m_Until;
+	// Lists being processed by Update
+	std::vector<Waiting> m_Resuming;
+
+	// FUNCTIONS
+	int GetSlot( TaskHandle handle ) const;
+	void Resume( int slot );
+	void Free( int slot );
+	void WaitNextFrame( int slot );
+	void WaitSeconds( int slot, float seconds );
+	void WaitUntil( int slot );
+};
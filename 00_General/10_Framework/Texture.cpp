@@ -0,0 +1,581 @@
+#include "stdafx.h"
+#include "Texture.h"
+#include "RenderStats.h"
+#include "ResourcePreload.h"
+#include "HotReload.h"
+#include "TextureBudget.h"
+#include "SurfaceConversion.h"
+#include "RenderBackend.h"
+#include "RenderQueue.h"
+#include "GlState.h"
+
+#include <iostream>
+#include <cstring>
+
+namespace
+{
+	// Vertices of the batched Draw, kept between calls
+	std::vector<RenderVertex> g_QuadVertices;
+}
+
+TextureOptions::TextureOptions( )
+	:TextureOptions{ false }
+{
+}
+
+TextureOptions::TextureOptions( bool isMipmapped, TextureCompression compression, bool isPremultiplied, bool hasCollisionMask )
+	:isMipmapped{ isMipmapped }
+	,compression{ compression }
+	,isPremultiplied{ isPremultiplied }
+	,hasCollisionMask{ hasCollisionMask }
+{
+}
+
+Texture::Texture( const std::string& imagePath, const TextureOptions& options )
+	:m_Options{ options }
+{
+	dae::CheckRenderThread( "Texture::Texture( )" );
+	CreateFromImage( imagePath );
+}
+
+Texture::Texture( const std::string& text, TTF_Font *pFont, const Color4f& textColor )
+{
+	dae::CheckRenderThread( "Texture::Texture( )" );
+	CreateFromString( text, pFont, textColor );
+}
+
+Texture::Texture( const std::string& text, const std::string& fontPath, int ptSize, const Color4f& textColor )
+{
+	dae::CheckRenderThread( "Texture::Texture( )" );
+	CreateFromString( text, fontPath, ptSize, textColor );
+}
+
+Texture::~Texture()
+{
+	dae::CheckRenderThread( "Texture::~Texture( )" );
+	dae::UnwatchFiles( this );
+	dae::RemoveResidentTexture( m_BudgetId );
+	dae::RemoveVideoMemory( m_VideoBytes, m_UncompressedBytes );
+	dae::SubmitRenderQueue( );
+	dae::FlushRenderBackend( );
+	dae::DeleteGlTexture( m_Id );
+}
+
+void Texture::CreateFromImage( const std::string& path )
+{
+	m_CreationOk = true;
+
+	// Also watched when loading failed, fixing the file then fixes the texture
+	dae::WatchFile( path, this,
+		[path] { return dae::InitImageLoading( ) ? IMG_Load( path.c_str( ) ) : nullptr; },
+		[this]( SDL_Surface* pSurface ) { ReloadFromSurface( pSurface ); } );
+
+	// Load image at specified path, unless it was decoded while Core started
+	SDL_Surface* pLoadedSurface = dae::TakePreloadedImage( path );
+	if ( pLoadedSurface == nullptr && dae::InitImageLoading( ) )
+	{
+		pLoadedSurface = IMG_Load( path.c_str( ) );
+	}
+	if ( pLoadedSurface == nullptr )
+	{
+		std::cerr << "Texture::CreateFromImage, error when calling IMG_Load: " << SDL_GetError( ) << std::endl;
+		m_CreationOk = false;
+		return;
+	}
+	CreateFromSurface( pLoadedSurface );
+
+	// Free loaded surface
+	SDL_FreeSurface( pLoadedSurface );
+}
+
+void Texture::CreateFromString( const std::string& text, const std::string& fontPath, int ptSize, const Color4f& textColor )
+{
+	m_CreationOk = true;
+
+	// A changed font renders the text again
+	dae::WatchFile( fontPath, this,
+		[text, fontPath, ptSize, textColor]
+		{
+			// Runs on the watch thread, while the game may use SDL_ttf too
+			if ( !dae::InitFonts( ) )
+			{
+				return static_cast<SDL_Surface*>( nullptr );
+			}
+			std::lock_guard<std::mutex> lock{ dae::GetFontMutex( ) };
+			TTF_Font* pFont{ TTF_OpenFont( fontPath.c_str( ), ptSize ) };
+			if ( pFont == nullptr )
+			{
+				return static_cast<SDL_Surface*>( nullptr );
+			}
+			const SDL_Color color{ Uint8( textColor.r * 255 ), Uint8( textColor.g * 255 ), Uint8( textColor.b * 255 ), Uint8( textColor.a * 255 ) };
+			SDL_Surface* pSurface{ TTF_RenderText_Blended( pFont, text.c_str( ), color ) };
+			TTF_CloseFont( pFont );
+			return pSurface;
+		},
+		[this]( SDL_Surface* pSurface ) { ReloadFromSurface( pSurface ); } );
+
+	// Create font, unless it was opened while Core started
+	TTF_Font *pFont{};
+	pFont = dae::TakePreloadedFont( fontPath, ptSize );
+	if ( pFont == nullptr && dae::InitFonts( ) )
+	{
+		std::lock_guard<std::mutex> lock{ dae::GetFontMutex( ) };
+		pFont = TTF_OpenFont( fontPath.c_str( ), ptSize );
+	}
+	if(pFont == nullptr )
+	{
+		std::cerr << "Texture::CreateFromString, error when calling TTF_OpenFont: " << TTF_GetError( ) << std::endl;
+		m_CreationOk = false;
+		return;
+	}
+
+	// Create texture using this font and close font afterwards
+	CreateFromString( text, pFont, textColor );
+	std::lock_guard<std::mutex> lock{ dae::GetFontMutex( ) };
+	TTF_CloseFont( pFont );
+}
+
+void Texture::CreateFromString( const std::string& text, TTF_Font *pFont, const Color4f& color )
+{
+	m_CreationOk = true;
+
+	// Render text surface
+	SDL_Color textColor{};
+	textColor.r = Uint8( color.r * 255 );
+	textColor.g = Uint8( color.g * 255 );
+	textColor.b = Uint8( color.b * 255 );
+	textColor.a = Uint8( color.a * 255 );
+
+	SDL_Surface* pLoadedSurface{ };
+	{
+		std::lock_guard<std::mutex> lock{ dae::GetFontMutex( ) };
+		pLoadedSurface = TTF_RenderText_Blended( pFont, text.c_str( ), textColor );
+	}
+	if ( pLoadedSurface == nullptr )
+	{
+		std::cerr << "Texture::CreateFromString, error when calling TTF_RenderText_Blended: " << TTF_GetError( ) << std::endl;
+		m_CreationOk = false;
+		return;
+	}
+
+	// Copy to video memory
+	CreateFromSurface( pLoadedSurface );
+
+	// Free loaded surface
+	SDL_FreeSurface( pLoadedSurface );
+}
+
+void Texture::CreateFromSurface( SDL_Surface *pSurface )
+{
+	m_CreationOk = true;
+
+	//Get image dimensions
+	m_Width = float(pSurface->w);
+	m_Height =float( pSurface->h);
+
+	// Convert whatever the image holds to the layout of the texture, so the upload is a plain copy
+	const Uint8* pPixels{ ConvertPixels( pSurface ) };
+	if ( pPixels == nullptr )
+	{
+		std::cerr << "Texture::CreateFromSurface, unknow pixel format, BytesPerPixel: " << int( pSurface->format->BytesPerPixel ) << '\n';
+		m_CreationOk = false;
+		return;
+	}
+
+	//Generate an array of textures.  We only want one texture (one element array), so trick
+	//it by treating "texture" as array of length one.
+	glGenTextures(1, &m_Id);
+
+	//Select (bind) the texture we just generated as the current 2D texture OpenGL is using/modifying.
+	//All subsequent changes to OpenGL's texturing state for 2D textures will affect this texture.
+	dae::SetGlTexture( m_Id );
+	// check for errors. Can happen if a texture is created while a static pointer is being initialized, even before the call to the main function.
+	GLenum e = glGetError();
+	if (e != GL_NO_ERROR)
+	{
+		std::cerr << "Texture::CreateFromSurface, error binding textures, Error id = " << e << '\n';
+		std::cerr << "Can happen if a texture is created before performing the initialization code (e.g. a static Texture object).\n";
+		std::cerr << "There might be a white rectangle instead of the image.\n";
+	}
+
+	// Specify the texture's data, with mipmaps and compression when asked
+	SpecifyImage( pPixels );
+	if ( m_Options.hasCollisionMask )
+	{
+		m_CollisionMask = CollisionMask{ pPixels, pSurface->w, pSurface->h };
+	}
+
+	if ( dae::IsTextureBudgetOn( ) )
+	{
+		if ( m_BudgetId < 0 )
+		{
+			m_BudgetId = dae::AddResidentTexture( [this] { Evict( ); } );
+		}
+		dae::SetTextureUploaded( m_BudgetId, m_VideoBytes );
+	}
+	ReleasePixels( );
+}
+
+void Texture::ReloadFromSurface( SDL_Surface* pSurface )
+{
+	if ( m_Id == 0 )
+	{
+		// The first load failed
+		CreateFromSurface( pSurface );
+		return;
+	}
+
+	const Uint8* pPixels{ ConvertPixels( pSurface ) };
+	if ( pPixels == nullptr )
+	{
+		std::cerr << "Texture::ReloadFromSurface( ), unknown pixel format, BytesPerPixel: " << int( pSurface->format->BytesPerPixel ) << '\n';
+		return;
+	}
+
+	dae::SetGlTexture( m_Id );
+	if ( pSurface->w == int( m_Width ) && pSurface->h == int( m_Height ) && m_Options.compression == TextureCompression::none )
+	{
+		// Same size: only replace the texels, the storage is reused. Generated mipmaps follow
+		glTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, pSurface->w, pSurface->h, GL_RGBA, GL_UNSIGNED_BYTE, pPixels );
+		if ( m_Options.isMipmapped )
+		{
+			dae::GenerateMipmaps( );
+		}
+	}
+	else
+	{
+		m_Width = float( pSurface->w );
+		m_Height = float( pSurface->h );
+		// Also when compressed: the driver only compresses whole images
+		SpecifyImage( pPixels );
+	}
+	if ( m_Options.hasCollisionMask )
+	{
+		m_CollisionMask = CollisionMask{ pPixels, pSurface->w, pSurface->h };
+	}
+	m_CreationOk = true;
+
+	if ( m_BudgetId >= 0 )
+	{
+		dae::SetTextureUploaded( m_BudgetId, m_VideoBytes );
+	}
+	ReleasePixels( );
+}
+
+const Uint8* Texture::ConvertPixels( const SDL_Surface* pSurface )
+{
+	// Most images already are RGBA, those are uploaded without a copy unless the budget keeps one
+	if ( dae::IsRgba8( pSurface ) && !m_Options.isPremultiplied && !dae::IsTextureBudgetOn( ) )
+	{
+		return static_cast<const Uint8*>( pSurface->pixels );
+	}
+	return dae::ConvertToRgba8( pSurface, m_Pixels, m_Options.isPremultiplied ) ? m_Pixels.data( ) : nullptr;
+}
+
+void Texture::ReleasePixels( )
+{
+	// Kept for uploading again after an eviction, see TextureBudget.h
+	if ( m_BudgetId < 0 )
+	{
+		std::vector<Uint8>( ).swap( m_Pixels );
+	}
+}
+
+void Texture::SpecifyImage( const Uint8* pPixels ) const
+{
+	GLenum internalFormat{ GL_RGBA };
+	if ( IsCompressionSupported( m_Options.compression ) )
+	{
+		switch ( m_Options.compression )
+		{
+		case TextureCompression::s3tc:
+			internalFormat = HasTranslucentPixels( pPixels ) ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+			break;
+		case TextureCompression::rgtc:
+			internalFormat = GL_COMPRESSED_RED_RGTC1;
+			break;
+		default:
+			break;
+		}
+	}
+
+	// The fixed function pipeline generates the mipmaps on each change of level 0 (OpenGL 1.4), so reloads keep them up to date.
+	// A core profile context generates them on request
+	if ( dae::GetRenderBackend( ) == RenderBackend::fixedFunction )
+	{
+		glTexParameteri( GL_TEXTURE_2D, GL_GENERATE_MIPMAP, m_Options.isMipmapped ? GL_TRUE : GL_FALSE );
+	}
+
+	// Specify the texture's data.  
+	// This function is a bit tricky, and it's hard to find helpful documentation. 
+	// A summary:
+	//    GL_TEXTURE_2D:    The currently bound 2D texture (i.e. the one we just made)
+	//                0:    The mipmap level.  0, since we want to update the base level mipmap image (i.e., the image itself,
+	//                         not cached smaller copies)
+	//   internalFormat:    Specifies the number of color components in the texture.
+	//                     This is how OpenGL will store the texture internally (kinda)--
+	//                     It's essentially the texture's type. A compressed format makes the driver compress the pixels.
+	//          m_Width:    The width of the texture
+	//         m_Height:    The height of the texture
+	//                0:    The border.  Don't worry about this if you're just starting.
+	//          GL_RGBA:    The format that the *data* is in--NOT the texture! Always RGBA, see SurfaceConversion.h
+	// GL_UNSIGNED_BYTE:    The type the data is in.  In SDL, the data is stored as an array of bytes, with each channel
+	//                         getting one byte.  This is fairly typical--it means that the image can store, for each channel,
+	//                         any value that fits in one byte (so 0 through 255).  These values are to be interpreted as
+	//                         *unsigned* values (since 0x00 should be dark and 0xFF should be bright).
+	//          pPixels:    The actual data.  As above, an array of bytes.
+	glTexImage2D( GL_TEXTURE_2D, 0, internalFormat, int( m_Width ), int( m_Height ), 0, GL_RGBA, GL_UNSIGNED_BYTE, pPixels );
+	if ( m_Options.isMipmapped )
+	{
+		dae::GenerateMipmaps( );
+	}
+
+	// Set the minification and magnification filters.  In this case, when the texture is minified (i.e., the texture's pixels (texels) are
+	// *smaller* than the screen pixels you're seeing them on, linearly filter them (i.e. blend them together).  This blends four texels for
+	// each sample--which is not very much.  With mipmaps, minification blends the two mipmap levels nearest to the size on screen
+	// (trilinear filtering), which samples far less memory for textures drawn small and doesn't shimmer.  Conversely, when the texture is magnified (i.e., the texture's texels are *larger* than the screen pixels you're seeing
+	// them on), linearly filter them.  Qualitatively, this causes "blown up" (overmagnified) textures to look blurry instead of blocky.
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_Options.isMipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+
+	CountVideoMemory( );
+}
+
+void Texture::CountVideoMemory( ) const
+{
+	dae::RemoveVideoMemory( m_VideoBytes, m_UncompressedBytes );
+	m_VideoBytes = 0;
+	m_UncompressedBytes = 0;
+	if ( m_Id == 0 )
+	{
+		return;
+	}
+
+	// Asks the driver, per mipmap level, what the texture really takes. Expects the texture to be bound
+	for ( int level{ 0 }; level < 32; ++level )
+	{
+		GLint width{};
+		GLint height{};
+		glGetTexLevelParameteriv( GL_TEXTURE_2D, level, GL_TEXTURE_WIDTH, &width );
+		glGetTexLevelParameteriv( GL_TEXTURE_2D, level, GL_TEXTURE_HEIGHT, &height );
+		if ( width == 0 || height == 0 )
+		{
+			break;
+		}
+		const size_t uncompressedBytes{ size_t( width ) * size_t( height ) * 4 };
+		GLint isCompressed{};
+		glGetTexLevelParameteriv( GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED, &isCompressed );
+		GLint compressedBytes{};
+		if ( isCompressed )
+		{
+			glGetTexLevelParameteriv( GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &compressedBytes );
+		}
+		m_VideoBytes += isCompressed ? size_t( compressedBytes ) : uncompressedBytes;
+		m_UncompressedBytes += uncompressedBytes;
+		if ( width == 1 && height == 1 )
+		{
+			break;
+		}
+	}
+	dae::AddVideoMemory( m_VideoBytes, m_UncompressedBytes );
+}
+
+bool Texture::HasTranslucentPixels( const Uint8* pPixels ) const
+{
+	const size_t nrBytes{ size_t( m_Width ) * size_t( m_Height ) * 4 };
+	for ( size_t alphaIdx{ 3 }; alphaIdx < nrBytes; alphaIdx += 4 )
+	{
+		if ( pPixels[alphaIdx] != 255 )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool Texture::IsCompressionSupported( TextureCompression compression )
+{
+	switch ( compression )
+	{
+	case TextureCompression::s3tc:
+		return dae::IsGlExtensionSupported( "GL_EXT_texture_compression_s3tc" );
+	case TextureCompression::rgtc:
+		// Part of OpenGL 3.0
+		return dae::GetRenderBackend( ) == RenderBackend::shaders
+			|| dae::IsGlExtensionSupported( "GL_ARB_texture_compression_rgtc" ) || dae::IsGlExtensionSupported( "GL_EXT_texture_compression_rgtc" );
+	default:
+		return false;
+	}
+}
+
+size_t Texture::GetVideoMemorySize( ) const
+{
+	return m_VideoBytes;
+}
+
+const CollisionMask& Texture::GetCollisionMask( ) const
+{
+	return m_CollisionMask;
+}
+
+void Texture::Upload( ) const
+{
+	glGenTextures( 1, &m_Id );
+	dae::SetGlTexture( m_Id );
+	SpecifyImage( m_Pixels.data( ) );
+	dae::SetTextureUploaded( m_BudgetId, m_VideoBytes );
+}
+
+void Texture::Evict( ) const
+{
+	dae::FlushRenderBackend( );
+	dae::DeleteGlTexture( m_Id );
+	m_Id = 0;
+	CountVideoMemory( );
+}
+
+void Texture::Draw( const Point2f& dstBottomLeft, const Rectf& srcRect ) const
+{
+	if ( !m_CreationOk )
+	{
+		DrawFilledRect( dstBottomLeft );
+	}
+	else
+	{
+		Rectf vertexRect{ dstBottomLeft.x, dstBottomLeft.y, m_Width, m_Height };
+		Draw( vertexRect, srcRect );
+	}
+}
+
+void Texture::Draw( const Rectf& destRect, const Rectf& srcRect ) const
+{
+	if ( !m_CreationOk )
+	{
+		DrawFilledRect( { destRect.left,destRect.bottom } );
+		return;
+	}
+
+	RenderVertex vertices[4];
+	GetQuad( destRect, srcRect, vertices );
+	Prepare( );
+	dae::RenderTexturedVertices( m_Id, GL_QUADS, vertices, 4, 0.0f, m_Options.isPremultiplied );
+}
+
+void Texture::Draw( const Rectf* pDestRects, const Rectf* pSrcRects, int nrRects ) const
+{
+	if ( !m_CreationOk )
+	{
+		for ( int idx{ 0 }; idx < nrRects; ++idx )
+		{
+			DrawFilledRect( { pDestRects[idx].left, pDestRects[idx].bottom } );
+		}
+		return;
+	}
+	if ( nrRects <= 0 )
+	{
+		return;
+	}
+
+	g_QuadVertices.resize( size_t( nrRects ) * 4 );
+	for ( int idx{ 0 }; idx < nrRects; ++idx )
+	{
+		GetQuad( pDestRects[idx], pSrcRects == nullptr ? Rectf{ } : pSrcRects[idx], &g_QuadVertices[size_t( idx ) * 4] );
+	}
+	Prepare( );
+	dae::RenderTexturedVertices( m_Id, GL_QUADS, g_QuadVertices.data( ), nrRects * 4, 0.0f, m_Options.isPremultiplied );
+}
+
+void Texture::DrawStaticVertices( GLuint bufferId, int nrVertices ) const
+{
+	if ( !m_CreationOk )
+	{
+		return;
+	}
+	Prepare( );
+	dae::RenderStaticVertices( bufferId, nrVertices, m_Id, 0.0f, m_Options.isPremultiplied );
+}
+
+void Texture::GetQuad( const Rectf& destRect, const Rectf& srcRect, RenderVertex* pQuad ) const
+{
+	// Determine texture coordinates
+	float textLeft{};
+	float textRight{};
+	float textTop{};
+	float textBottom{};
+	if ( !( srcRect.width > 0.0f && srcRect.height > 0.0f ) ) // No rect specified, use complete texture
+	{
+		textLeft = 0.0f;
+		textRight = 1.0f;
+		textBottom = 0.0f;
+		textTop = 1.0f;
+	}
+	else // Clip specified, convert them to the range [0.0, 1.0]
+	{
+		textLeft = srcRect.left / m_Width;
+		textRight = ( srcRect.left + srcRect.width ) / m_Width;
+		textTop = ( srcRect.bottom + srcRect.height ) / m_Height;
+		textBottom = srcRect.bottom / m_Height;
+	}
+
+	// Determine vertexCoordinates
+	float vertexLeft{ destRect.left };
+	float vertexBottom{ destRect.bottom };
+	float vertexRight{};
+	float vertexTop{};
+	if ( !( destRect.width > 0.0f && destRect.height > 0.0f ) ) // If no size specified use size of texture
+	{
+		vertexRight = vertexLeft + m_Width;
+		vertexTop = vertexBottom + m_Height;
+	}
+	else
+	{
+		vertexRight = vertexLeft + destRect.width;
+		vertexTop = vertexBottom + destRect.height;
+	}
+	
+	// Map left-bottom texture -> left-top vertex, left-top texture -> left-bottom vertex,
+	// right-top texture -> right-bottom vertex, right-bottom texture -> right-top vertex
+	const Color4f white{ 1.0f, 1.0f, 1.0f, 1.0f };
+	pQuad[0] = RenderVertex{ vertexLeft, vertexTop, textLeft, textBottom, white };
+	pQuad[1] = RenderVertex{ vertexLeft, vertexBottom, textLeft, textTop, white };
+	pQuad[2] = RenderVertex{ vertexRight, vertexBottom, textRight, textTop, white };
+	pQuad[3] = RenderVertex{ vertexRight, vertexTop, textRight, textBottom, white };
+}
+
+void Texture::Prepare( ) const
+{
+	// Evicted by the video memory budget
+	if ( m_Id == 0 )
+	{
+		Upload( );
+	}
+	dae::TouchTexture( m_BudgetId );
+}
+
+float Texture::GetWidth() const
+{
+	return m_Width;
+}
+
+float Texture::GetHeight() const
+{
+	return m_Height;
+}
+
+bool Texture::IsCreationOk( ) const
+{
+	return m_CreationOk;
+}
+
+void Texture::DrawFilledRect( const Point2f& dstBottomLeft ) const
+{
+	dae::SetRenderColor( Color4f{ 1.0f, 0.0f, 1.0f, 1.0f } );
+	const Point2f vertices[]
+	{
+		Point2f{ dstBottomLeft.x, dstBottomLeft.y + m_Height },
+		Point2f{ dstBottomLeft.x, dstBottomLeft.y },
+		Point2f{ dstBottomLeft.x + m_Width, dstBottomLeft.y + m_Height },
+		Point2f{ dstBottomLeft.x + m_Width, dstBottomLeft.y }
+	};
+	dae::RenderVertices( GL_TRIANGLE_STRIP, vertices, 4 );
+}
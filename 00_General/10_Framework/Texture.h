@@ -0,0 +1,104 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "CollisionMask.h"
+
+struct RenderVertex;
+
+enum class TextureCompression
+{
+	none,
+	// S3TC, compressed by the driver: DXT1 (4 bits per texel) for opaque images, DXT5 (8 bits per texel) otherwise
+	s3tc,
+	// RGTC1: only the red channel, 4 bits per texel. For masks and data textures, drawn as shades of red
+	rgtc
+};
+
+// How an image texture is kept in video memory
+struct TextureOptions
+{
+	TextureOptions( );
+	explicit TextureOptions( bool isMipmapped, TextureCompression compression = TextureCompression::none, bool isPremultiplied = false, bool hasCollisionMask = false );
+
+	// Mipmaps generated by the driver and trilinear filtering: for textures drawn smaller than their size.
+	// Costs a third more memory, but drawing them small samples far less memory and doesn't shimmer
+	bool isMipmapped;
+	// Uncompressed when the driver doesn't support it
+	TextureCompression compression;
+	// Colors multiplied by alpha when loading, Draw blends with GL_ONE, GL_ONE_MINUS_SRC_ALPHA.
+	// Keeps the color of transparent texels from bleeding into the edges of scaled or mipmapped sprites
+	bool isPremultiplied;
+	// Keeps a collision mask of the pixels with alpha of at least 128, see CollisionMask.h. One bit per pixel in memory
+	bool hasCollisionMask;
+};
+
+class Texture
+{
+public:
+	explicit Texture( const std::string& imagePath, const TextureOptions& options = TextureOptions{ } );
+	explicit Texture( const std::string& text, TTF_Font *pFont, const Color4f& textColor );
+	explicit Texture( const std::string& text, const std::string& fontPath, int ptSize, const Color4f& textColor );
+	Texture( const Texture& other ) = delete;
+	Texture& operator=( const Texture& other ) = delete;
+	~Texture();
+
+	void Draw( const Point2f& destBottomLeft, const Rectf& srcRect = {} ) const;
+	void Draw( const Rectf& destRect, const Rectf& srcRect = {} ) const;
+	// nrRects sprites of this texture in one draw call, as many Draw( destRect, srcRect ) calls.
+	// pSrcRects can be nullptr to draw the whole texture each time
+	void Draw( const Rectf* pDestRects, const Rectf* pSrcRects, int nrRects ) const;
+	// Static vertices made with GetQuad, see RenderStaticVertices and Tilemap
+	void DrawStaticVertices( GLuint bufferId, int nrVertices ) const;
+	// The 4 GL_QUADS vertices Draw sends for these rects
+	void GetQuad( const Rectf& destRect, const Rectf& srcRect, RenderVertex* pQuad ) const;
+
+	float GetWidth() const;
+	float GetHeight() const;
+	bool IsCreationOk( ) const;
+	// Bytes in video memory, all mipmap levels. 0 while evicted
+	size_t GetVideoMemorySize( ) const;
+	// Empty unless TextureOptions::hasCollisionMask. For a frame of a sprite sheet: CollisionMask{ GetCollisionMask( ), srcRect }
+	const CollisionMask& GetCollisionMask( ) const;
+
+	static bool IsCompressionSupported( TextureCompression compression );
+
+private:
+	//DATA MEMBERS
+	// 0 while evicted by the video memory budget, Draw uploads it again
+	mutable GLuint m_Id{};
+	float m_Width{ 10.0f };
+	float m_Height{ 10.0f };
+	bool m_CreationOk{};
+	// Video memory budget, see TextureBudget.h
+	int m_BudgetId{ -1 };
+	// RGBA8, see SurfaceConversion.h. Only kept after the upload when there is a budget
+	std::vector<Uint8> m_Pixels;
+	TextureOptions m_Options{};
+	CollisionMask m_CollisionMask;
+	// What the texture takes in video memory, and what it would take as uncompressed RGBA
+	mutable size_t m_VideoBytes{};
+	mutable size_t m_UncompressedBytes{};
+
+	// FUNCTIONS
+	void CreateFromImage( const std::string& path );
+	void CreateFromString( const std::string& text, TTF_Font *pFont, const Color4f & textColor );
+	void CreateFromString( const std::string& text, const std::string& fontPath, int ptSize, const Color4f& textColor );
+	void CreateFromSurface( SDL_Surface *pSurface );
+	// Hot reload, see HotReload.h: keeps m_Id, so the texture stays valid for its users
+	void ReloadFromSurface( SDL_Surface* pSurface );
+	// The pixels to upload: converted into m_Pixels, or those of the surface when it already is RGBA8. nullptr when conversion failed
+	const Uint8* ConvertPixels( const SDL_Surface* pSurface );
+	void ReleasePixels( );
+	// RGBA8 pixels of the texture's size. Chooses DXT1 or DXT5
+	bool HasTranslucentPixels( const Uint8* pPixels ) const;
+	// glTexImage2D of RGBA8 pixels into the bound texture with m_Options, then counts its video memory
+	void SpecifyImage( const Uint8* pPixels ) const;
+	void CountVideoMemory( ) const;
+	void Upload( ) const;
+	void Evict( ) const;
+	// Uploads the texture again when evicted, and tells the budget it is used
+	void Prepare( ) const;
+	void DrawFilledRect( const Point2f& dstBottomLeft ) const;
+};
+
+
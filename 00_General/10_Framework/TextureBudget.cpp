@@ -0,0 +1,199 @@
+#include "stdafx.h"
+#include "TextureBudget.h"
+#include <iostream>
+#include <vector>
+
+TextureMemoryStats::TextureMemoryStats( )
+	:budget{ 0 }
+	,residentBytes{ 0 }
+	,nrTextures{ 0 }
+	,nrResident{ 0 }
+	,nrUploads{ 0 }
+	,nrEvictions{ 0 }
+	,videoBytes{ 0 }
+	,savedBytes{ 0 }
+{
+}
+
+namespace dae
+{
+	namespace
+	{
+		struct Entry
+		{
+			std::function<void( )> evict;
+			size_t bytes;
+			Uint32 lastDrawFrame;
+			// Neighbours in the list of resident textures, most recently drawn first. Next free entry while free
+			int previous;
+			int next;
+			bool isResident;
+		};
+
+		const int g_NoEntry{ -1 };
+
+		std::vector<Entry> g_Entries;
+		int g_FirstFree{ g_NoEntry };
+		int g_MostRecent{ g_NoEntry };
+		int g_LeastRecent{ g_NoEntry };
+		Uint32 g_Frame{ 1 };
+		bool g_IsOverBudgetReported{ false };
+		TextureMemoryStats g_Stats{ };
+
+		void Unlink( int entryIdx )
+		{
+			Entry& entry{ g_Entries[entryIdx] };
+			( entry.previous != g_NoEntry ? g_Entries[entry.previous].next : g_MostRecent ) = entry.next;
+			( entry.next != g_NoEntry ? g_Entries[entry.next].previous : g_LeastRecent ) = entry.previous;
+			entry.previous = g_NoEntry;
+			entry.next = g_NoEntry;
+		}
+
+		void LinkFirst( int entryIdx )
+		{
+			Entry& entry{ g_Entries[entryIdx] };
+			entry.previous = g_NoEntry;
+			entry.next = g_MostRecent;
+			( g_MostRecent != g_NoEntry ? g_Entries[g_MostRecent].previous : g_LeastRecent ) = entryIdx;
+			g_MostRecent = entryIdx;
+		}
+
+		void SetNotResident( int entryIdx )
+		{
+			Entry& entry{ g_Entries[entryIdx] };
+			if ( entry.isResident )
+			{
+				Unlink( entryIdx );
+				entry.isResident = false;
+				g_Stats.residentBytes -= entry.bytes;
+				--g_Stats.nrResident;
+			}
+		}
+
+		void EnforceBudget( )
+		{
+			if ( g_Stats.budget == 0 )
+			{
+				return;
+			}
+			while ( g_Stats.residentBytes > g_Stats.budget && g_LeastRecent != g_NoEntry )
+			{
+				const int entryIdx{ g_LeastRecent };
+				if ( g_Entries[entryIdx].lastDrawFrame == g_Frame )
+				{
+					// Everything left is used by this frame
+					if ( !g_IsOverBudgetReported )
+					{
+						std::cerr << "dae::TextureBudget, one frame uses " << g_Stats.residentBytes / ( 1024 * 1024 ) << " MB of textures, the budget is "
+							<< g_Stats.budget / ( 1024 * 1024 ) << " MB\n";
+						g_IsOverBudgetReported = true;
+					}
+					return;
+				}
+				SetNotResident( entryIdx );
+				g_Entries[entryIdx].evict( );
+				++g_Stats.nrEvictions;
+			}
+		}
+	}
+
+	void SetTextureBudget( size_t bytes )
+	{
+		g_Stats.budget = bytes;
+	}
+
+	bool IsTextureBudgetOn( )
+	{
+		return g_Stats.budget > 0;
+	}
+
+	void NextTextureFrame( )
+	{
+		++g_Frame;
+		g_Stats.nrUploads = 0;
+		g_Stats.nrEvictions = 0;
+		// A frame that needed more than the budget left the total over it
+		EnforceBudget( );
+	}
+
+	const TextureMemoryStats& GetTextureMemoryStats( )
+	{
+		return g_Stats;
+	}
+
+	int AddResidentTexture( std::function<void( )> evict )
+	{
+		int entryIdx{ g_FirstFree };
+		if ( entryIdx != g_NoEntry )
+		{
+			g_FirstFree = g_Entries[entryIdx].next;
+		}
+		else
+		{
+			entryIdx = int( g_Entries.size( ) );
+			g_Entries.emplace_back( );
+		}
+		g_Entries[entryIdx] = Entry{ std::move( evict ), 0, g_Frame, g_NoEntry, g_NoEntry, false };
+		++g_Stats.nrTextures;
+		return entryIdx;
+	}
+
+	void RemoveResidentTexture( int textureId )
+	{
+		if ( textureId < 0 )
+		{
+			return;
+		}
+		SetNotResident( textureId );
+		Entry& entry{ g_Entries[textureId] };
+		entry.evict = nullptr;
+		entry.next = g_FirstFree;
+		g_FirstFree = textureId;
+		--g_Stats.nrTextures;
+	}
+
+	void SetTextureUploaded( int textureId, size_t bytes )
+	{
+		if ( textureId < 0 )
+		{
+			return;
+		}
+		// A reload can change the size of a resident texture
+		SetNotResident( textureId );
+		Entry& entry{ g_Entries[textureId] };
+		entry.bytes = bytes;
+		entry.isResident = true;
+		entry.lastDrawFrame = g_Frame;
+		LinkFirst( textureId );
+		g_Stats.residentBytes += bytes;
+		++g_Stats.nrResident;
+		++g_Stats.nrUploads;
+		EnforceBudget( );
+	}
+
+	void TouchTexture( int textureId )
+	{
+		if ( textureId < 0 || !g_Entries[textureId].isResident )
+		{
+			return;
+		}
+		g_Entries[textureId].lastDrawFrame = g_Frame;
+		if ( g_MostRecent != textureId )
+		{
+			Unlink( textureId );
+			LinkFirst( textureId );
+		}
+	}
+
+	void AddVideoMemory( size_t bytes, size_t uncompressedBytes )
+	{
+		g_Stats.videoBytes += bytes;
+		g_Stats.savedBytes += uncompressedBytes - bytes;
+	}
+
+	void RemoveVideoMemory( size_t bytes, size_t uncompressedBytes )
+	{
+		g_Stats.videoBytes -= bytes;
+		g_Stats.savedBytes -= uncompressedBytes - bytes;
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <functional>
+
+// Video memory budget for the textures, e.g. DAE_VRAM_BUDGET=256 (MB).
+// Without a budget every Texture stays in video memory until it is destroyed (the default).
+// With a budget, textures keep a copy of their pixels in system memory and the least recently drawn
+// ones are deleted from video memory when the total exceeds the budget. Drawing an evicted texture
+// uploads it again. Textures drawn in the current frame are never evicted, so a frame that needs more
+// than the budget goes over it instead of thrashing.
+// The video memory of all textures is counted, also without a budget.
+struct TextureMemoryStats
+{
+	TextureMemoryStats( );
+
+	size_t budget;
+	size_t residentBytes;
+	int nrTextures;
+	int nrResident;
+	// Since the previous NextTextureFrame
+	int nrUploads;
+	int nrEvictions;
+	// All textures in video memory, and what compression saves compared to uncompressed RGBA with the same mipmap levels
+	size_t videoBytes;
+	size_t savedBytes;
+};
+
+namespace dae
+{
+	// Called by Core, before textures are created. 0: no budget
+	void SetTextureBudget( size_t bytes );
+	bool IsTextureBudgetOn( );
+	// Called by Core after each frame
+	void NextTextureFrame( );
+	const TextureMemoryStats& GetTextureMemoryStats( );
+
+	// Called by Texture. evict deletes the OpenGL texture, the texture is not resident until it is uploaded again
+	int AddResidentTexture( std::function<void( )> evict );
+	void RemoveResidentTexture( int textureId );
+	// After each upload: counts the bytes and evicts other textures when over budget
+	void SetTextureUploaded( int textureId, size_t bytes );
+	// On each draw
+	void TouchTexture( int textureId );
+	// After each upload and before each delete, with or without a budget
+	void AddVideoMemory( size_t bytes, size_t uncompressedBytes );
+	void RemoveVideoMemory( size_t bytes, size_t uncompressedBytes );
+}
@@ -0,0 +1,157 @@
+#include "stdafx.h"
+#include "Tilemap.h"
+#include "Texture.h"
+#include "RenderBackend.h"
+#include "RenderQueue.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// The triangles of the chunk being built, kept between builds
+	std::vector<RenderVertex> g_ChunkVertices;
+}
+
+Tilemap::Tilemap( const Texture& tileSheet, float tileWidth, float tileHeight, int nrCols, int nrRows, const Point2f& bottomLeft )
+	:m_TileSheet{ tileSheet }
+	,m_TileWidth{ tileWidth }
+	,m_TileHeight{ tileHeight }
+	,m_NrCols{ std::max( nrCols, 0 ) }
+	,m_NrRows{ std::max( nrRows, 0 ) }
+	,m_BottomLeft{ bottomLeft }
+	,m_NrSheetCols{ std::max( int( tileSheet.GetWidth( ) / tileWidth ), 1 ) }
+	,m_Tiles( size_t( m_NrCols ) * m_NrRows, -1 )
+	,m_NrChunkCols{ ( m_NrCols + m_ChunkSize - 1 ) / m_ChunkSize }
+	,m_NrChunkRows{ ( m_NrRows + m_ChunkSize - 1 ) / m_ChunkSize }
+	,m_Chunks( size_t( m_NrChunkCols ) * m_NrChunkRows, Chunk{ 0, 0, false } )
+{
+}
+
+Tilemap::~Tilemap( )
+{
+	dae::CheckRenderThread( "Tilemap::~Tilemap( )" );
+	// Queued draws may still use the buffers
+	dae::SubmitRenderQueue( );
+	for ( const Chunk& chunk : m_Chunks )
+	{
+		dae::DeleteStaticVertices( chunk.bufferId );
+	}
+}
+
+void Tilemap::SetTile( int col, int row, int tile )
+{
+	if ( col < 0 || col >= m_NrCols || row < 0 || row >= m_NrRows )
+	{
+		return;
+	}
+	int& cell{ m_Tiles[size_t( row ) * m_NrCols + col] };
+	tile = std::max( tile, -1 );
+	if ( cell != tile )
+	{
+		cell = tile;
+		m_Chunks[size_t( row / m_ChunkSize ) * m_NrChunkCols + col / m_ChunkSize].isDirty = true;
+	}
+}
+
+int Tilemap::GetTile( int col, int row ) const
+{
+	if ( col < 0 || col >= m_NrCols || row < 0 || row >= m_NrRows )
+	{
+		return -1;
+	}
+	return m_Tiles[size_t( row ) * m_NrCols + col];
+}
+
+void Tilemap::Fill( int tile )
+{
+	std::fill( m_Tiles.begin( ), m_Tiles.end( ), std::max( tile, -1 ) );
+	for ( Chunk& chunk : m_Chunks )
+	{
+		chunk.isDirty = true;
+	}
+}
+
+void Tilemap::Draw( const Rectf& camera ) const
+{
+	// The chunks the camera overlaps
+	const float chunkWidth{ m_ChunkSize * m_TileWidth };
+	const float chunkHeight{ m_ChunkSize * m_TileHeight };
+	const int firstCol{ std::max( int( std::floor( ( camera.left - m_BottomLeft.x ) / chunkWidth ) ), 0 ) };
+	const int lastCol{ std::min( int( std::ceil( ( camera.left + camera.width - m_BottomLeft.x ) / chunkWidth ) ), m_NrChunkCols ) - 1 };
+	const int firstRow{ std::max( int( std::floor( ( camera.bottom - m_BottomLeft.y ) / chunkHeight ) ), 0 ) };
+	const int lastRow{ std::min( int( std::ceil( ( camera.bottom + camera.height - m_BottomLeft.y ) / chunkHeight ) ), m_NrChunkRows ) - 1 };
+
+	for ( int chunkRow{ firstRow }; chunkRow <= lastRow; ++chunkRow )
+	{
+		for ( int chunkCol{ firstCol }; chunkCol <= lastCol; ++chunkCol )
+		{
+			const Chunk& chunk{ m_Chunks[size_t( chunkRow ) * m_NrChunkCols + chunkCol] };
+			if ( chunk.isDirty )
+			{
+				Build( chunkCol, chunkRow );
+			}
+			if ( chunk.nrVertices > 0 )
+			{
+				m_TileSheet.DrawStaticVertices( chunk.bufferId, chunk.nrVertices );
+			}
+		}
+	}
+}
+
+int Tilemap::GetNrCols( ) const
+{
+	return m_NrCols;
+}
+
+int Tilemap::GetNrRows( ) const
+{
+	return m_NrRows;
+}
+
+Rectf Tilemap::GetBounds( ) const
+{
+	return Rectf{ m_BottomLeft.x, m_BottomLeft.y, m_NrCols * m_TileWidth, m_NrRows * m_TileHeight };
+}
+
+void Tilemap::Build( int chunkCol, int chunkRow ) const
+{
+	g_ChunkVertices.clear( );
+	const int lastCol{ std::min( ( chunkCol + 1 ) * m_ChunkSize, m_NrCols ) };
+	const int lastRow{ std::min( ( chunkRow + 1 ) * m_ChunkSize, m_NrRows ) };
+	for ( int row{ chunkRow * m_ChunkSize }; row < lastRow; ++row )
+	{
+		for ( int col{ chunkCol * m_ChunkSize }; col < lastCol; ++col )
+		{
+			const int tile{ m_Tiles[size_t( row ) * m_NrCols + col] };
+			if ( tile < 0 )
+			{
+				continue;
+			}
+			const Rectf destRect{ m_BottomLeft.x + col * m_TileWidth, m_BottomLeft.y + row * m_TileHeight, m_TileWidth, m_TileHeight };
+			const Rectf srcRect{ ( tile % m_NrSheetCols ) * m_TileWidth, ( tile / m_NrSheetCols ) * m_TileHeight, m_TileWidth, m_TileHeight };
+			RenderVertex quad[4];
+			m_TileSheet.GetQuad( destRect, srcRect, quad );
+			// Two triangles
+			const int corners[]{ 0, 1, 2, 0, 2, 3 };
+			for ( int corner : corners )
+			{
+				g_ChunkVertices.push_back( quad[corner] );
+			}
+		}
+	}
+
+	Chunk& chunk{ m_Chunks[size_t( chunkRow ) * m_NrChunkCols + chunkCol] };
+	chunk.nrVertices = int( g_ChunkVertices.size( ) );
+	chunk.isDirty = false;
+	if ( chunk.bufferId == 0 )
+	{
+		if ( chunk.nrVertices > 0 )
+		{
+			chunk.bufferId = dae::CreateStaticVertices( g_ChunkVertices.data( ), chunk.nrVertices );
+		}
+	}
+	else
+	{
+		dae::UpdateStaticVertices( chunk.bufferId, g_ChunkVertices.data( ), chunk.nrVertices );
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <vector>
+
+class Texture;
+
+// A grid of tiles from a tile sheet, such as EnvironmentGrid.png, in place of a Texture::Draw per visible tile:
+//		Tilemap level{ m_TileSheet, 32.0f, 32.0f, 200, 50 };
+//		level.SetTile( col, row, tile );		// tile 0 is the top left one of the sheet, then left to right, top to bottom
+//		...
+//		level.Draw( cameraRect );				// Game::Draw
+//
+// The map is split into chunks of 32 x 32 tiles. The vertices of a chunk are built once and kept in video memory
+// (see RenderStaticVertices), Draw only sends a draw call for each chunk that overlaps the camera: with 32x32 pixel
+// tiles a 1280x800 window takes 6 draw calls at most, whatever the size of the map.
+// SetTile marks the chunk, which is built again the next time it is drawn.
+class Tilemap
+{
+public:
+	// The tiles are drawn at their size on the sheet, the bottom left tile at bottomLeft. All tiles start empty.
+	// The tile sheet must outlive the Tilemap
+	Tilemap( const Texture& tileSheet, float tileWidth, float tileHeight, int nrCols, int nrRows, const Point2f& bottomLeft = Point2f{ } );
+	Tilemap( const Tilemap& other ) = delete;
+	Tilemap& operator=( const Tilemap& other ) = delete;
+	~Tilemap( );
+
+	// Row 0 is the bottom row. A negative tile empties the cell, tiles outside the map are ignored
+	void SetTile( int col, int row, int tile );
+	// -1 when empty or outside the map
+	int GetTile( int col, int row ) const;
+	void Fill( int tile );
+
+	// camera: what is visible, in the coordinates the tiles are drawn in
+	void Draw( const Rectf& camera ) const;
+
+	int GetNrCols( ) const;
+	int GetNrRows( ) const;
+	Rectf GetBounds( ) const;
+
+private:
+	struct Chunk
+	{
+		// 0 until the chunk has tiles
+		GLuint bufferId;
+		int nrVertices;
+		bool isDirty;
+	};
+
+	static const int m_ChunkSize{ 32 };
+
+	// DATA MEMBERS
+	const Texture& m_TileSheet;
+	float m_TileWidth;
+	float m_TileHeight;
+	int m_NrCols;
+	int m_NrRows;
+	Point2f m_BottomLeft;
+	// Tiles per row of the sheet
+	int m_NrSheetCols;
+	// Bottom row first
+	std::vector<int> m_Tiles;
+	int m_NrChunkCols;
+	int m_NrChunkRows;
+	// Built by Draw
+	mutable std::vector<Chunk> m_Chunks;
+
+	// FUNCTIONS
+	void Build( int chunkCol, int chunkRow ) const;
+};
@@ -0,0 +1,292 @@
+#include "stdafx.h"
+#include "TimerWheel.h"
+#include <iostream>
+#include <algorithm>
+
+//-----------------------------------------------------------------
+// TimerWheel
+//-----------------------------------------------------------------
+TimerWheel::TimerWheel( )
+	:m_FirstFree{ m_NoSlot }
+	,m_Slots{ }
+	,m_Tick{ 0 }
+	,m_TickFraction{ 0.0f }
+	,m_NextSequenceNr{ 0 }
+	,m_NrPending{ 0 }
+	,m_NrClears{ 0 }
+{
+	std::fill( std::begin( m_Slots ), std::end( m_Slots ), int( m_NoSlot ) );
+}
+
+TimerHandle TimerWheel::Schedule( float delaySec, std::function<void( )> callback )
+{
+	return Add( delaySec, 0, callback );
+}
+
+TimerHandle TimerWheel::ScheduleRepeating( float intervalSec, std::function<void( )> callback )
+{
+	const Uint64 intervalTicks{ std::max( ToTicks( intervalSec ), Uint64( 1 ) ) };
+	return Add( intervalSec, Uint32( std::min( intervalTicks, Uint64( 0xffffffff ) ) ), callback );
+}
+
+bool TimerWheel::Cancel( TimerHandle handle )
+{
+	const int idx{ GetIndex( handle ) };
+	if ( idx < 0 )
+	{
+		return false;
+	}
+	// A timer in the expired list is skipped when its turn comes
+	if ( m_Timers[idx].slot != m_Firing )
+	{
+		Unlink( idx );
+	}
+	Free( idx );
+	return true;
+}
+
+bool TimerWheel::IsPending( TimerHandle handle ) const
+{
+	return GetIndex( handle ) >= 0;
+}
+
+float TimerWheel::GetRemaining( TimerHandle handle ) const
+{
+	const int idx{ GetIndex( handle ) };
+	if ( idx < 0 )
+	{
+		return 0.0f;
+	}
+	return std::max( ( m_Timers[idx].dueTick - m_Tick ) / 1000.0f - m_TickFraction / 1000.0f, 0.0f );
+}
+
+void TimerWheel::Advance( float elapsedSec )
+{
+	m_TickFraction += elapsedSec * 1000.0f;
+	const int nrTicks{ int( m_TickFraction ) };
+	m_TickFraction -= nrTicks;
+	for ( int tick{ 0 }; tick < nrTicks; ++tick )
+	{
+		++m_Tick;
+		// When a level wraps, the current slot of the level above is due to move down
+		for ( int level{ 1 }; level < m_NrLevels; ++level )
+		{
+			if ( ( m_Tick & ( ( Uint64( 1 ) << ( m_SlotBits * level ) ) - 1 ) ) != 0 )
+			{
+				break;
+			}
+			Cascade( level );
+		}
+		FireTick( );
+	}
+}
+
+void TimerWheel::Clear( )
+{
+	// The timers are freed, not removed: FireTick may still index them when a callback clears the wheel,
+	// and the new generations make the handles of the cleared timers stale, like ObjectPool::Clear
+	m_FirstFree = m_NoSlot;
+	for ( int idx{ int( m_Timers.size( ) ) - 1 }; idx >= 0; --idx )
+	{
+		Timer& timer{ m_Timers[idx] };
+		if ( timer.slot != m_NoSlot )
+		{
+			timer.callback = nullptr;
+			timer.slot = m_NoSlot;
+			timer.generation = TimerHandle::GetNextGeneration( timer.generation );
+		}
+		timer.next = m_FirstFree;
+		m_FirstFree = idx;
+	}
+	std::fill( std::begin( m_Slots ), std::end( m_Slots ), int( m_NoSlot ) );
+	m_NrPending = 0;
+	m_Expired.clear( );
+	++m_NrClears;
+}
+
+int TimerWheel::GetNrPending( ) const
+{
+	return m_NrPending;
+}
+
+double TimerWheel::GetTime( ) const
+{
+	return m_Tick / 1000.0;
+}
+
+TimerHandle TimerWheel::Add( float delaySec, Uint32 intervalTicks, std::function<void( )>& callback )
+{
+	int idx{ m_FirstFree };
+	if ( idx == m_NoSlot )
+	{
+		if ( m_Timers.size( ) >= TimerHandle::indexMask )
+		{
+			std::cerr << "TimerWheel::Schedule( ), too many timers, maximum is " << TimerHandle::indexMask - 1 << '\n';
+			return TimerHandle{ };
+		}
+		idx = int( m_Timers.size( ) );
+		m_Timers.push_back( Timer{ } );
+		// Generation 0 is never used, so no handle has id 0
+		m_Timers[idx].generation = 1;
+	}
+	else
+	{
+		m_FirstFree = m_Timers[idx].next;
+	}
+
+	Timer& timer{ m_Timers[idx] };
+	timer.callback = std::move( callback );
+	// Due at the earliest at the next tick, at the latest at the end of the wheel
+	const Uint64 maxDelayTicks{ ( Uint64( 1 ) << ( m_SlotBits * m_NrLevels ) ) - 1 };
+	timer.dueTick = m_Tick + std::min( std::max( ToTicks( delaySec ), Uint64( 1 ) ), maxDelayTicks );
+	timer.sequenceNr = m_NextSequenceNr++;
+	timer.intervalTicks = intervalTicks;
+	Insert( idx );
+	++m_NrPending;
+	return TimerHandle{ unsigned( idx ), timer.generation };
+}
+
+int TimerWheel::GetIndex( TimerHandle handle ) const
+{
+	const unsigned int idx{ handle.GetIndex( ) };
+	if ( !handle.IsValid( ) || idx >= m_Timers.size( ) )
+	{
+		return -1;
+	}
+	const Timer& timer{ m_Timers[idx] };
+	if ( timer.slot == m_NoSlot || timer.generation != handle.GetGeneration( ) )
+	{
+		return -1;
+	}
+	return int( idx );
+}
+
+void TimerWheel::Insert( int idx )
+{
+	// The level is chosen by the distance to the due tick, the slot by the bits of the due tick at that level
+	Timer& timer{ m_Timers[idx] };
+	const Uint64 delta{ timer.dueTick - m_Tick };
+	int level{ 0 };
+	while ( level < m_NrLevels - 1 && delta >= ( Uint64( 1 ) << ( m_SlotBits * ( level + 1 ) ) ) )
+	{
+		++level;
+	}
+	const int slot{ level * m_NrSlots + int( ( timer.dueTick >> ( m_SlotBits * level ) ) & ( m_NrSlots - 1 ) ) };
+
+	timer.slot = slot;
+	timer.previous = m_NoSlot;
+	timer.next = m_Slots[slot];
+	if ( timer.next != m_NoSlot )
+	{
+		m_Timers[timer.next].previous = idx;
+	}
+	m_Slots[slot] = idx;
+}
+
+void TimerWheel::Unlink( int idx )
+{
+	Timer& timer{ m_Timers[idx] };
+	if ( timer.previous != m_NoSlot )
+	{
+		m_Timers[timer.previous].next = timer.next;
+	}
+	else
+	{
+		m_Slots[timer.slot] = timer.next;
+	}
+	if ( timer.next != m_NoSlot )
+	{
+		m_Timers[timer.next].previous = timer.previous;
+	}
+}
+
+void TimerWheel::Free( int idx )
+{
+	Timer& timer{ m_Timers[idx] };
+	timer.callback = nullptr;
+	timer.slot = m_NoSlot;
+	timer.generation = TimerHandle::GetNextGeneration( timer.generation );
+	timer.next = m_FirstFree;
+	m_FirstFree = idx;
+	--m_NrPending;
+}
+
+void TimerWheel::Cascade( int level )
+{
+	const int slot{ level * m_NrSlots + int( ( m_Tick >> ( m_SlotBits * level ) ) & ( m_NrSlots - 1 ) ) };
+	int idx{ m_Slots[slot] };
+	m_Slots[slot] = m_NoSlot;
+	while ( idx != m_NoSlot )
+	{
+		const int next{ m_Timers[idx].next };
+		Insert( idx );
+		idx = next;
+	}
+}
+
+void TimerWheel::FireTick( )
+{
+	const int slot{ int( m_Tick & ( m_NrSlots - 1 ) ) };
+	if ( m_Slots[slot] == m_NoSlot )
+	{
+		return;
+	}
+
+	// Take the whole slot first: callbacks can schedule and cancel timers
+	m_Expired.clear( );
+	for ( int idx{ m_Slots[slot] }; idx != m_NoSlot; idx = m_Timers[idx].next )
+	{
+		m_Timers[idx].slot = m_Firing;
+		m_Expired.push_back( idx );
+	}
+	m_Slots[slot] = m_NoSlot;
+	std::sort( m_Expired.begin( ), m_Expired.end( ), [this]( int left, int right )
+	{
+		return m_Timers[left].sequenceNr < m_Timers[right].sequenceNr;
+	} );
+
+	const Uint32 nrClears{ m_NrClears };
+	for ( size_t expired{ 0 }; expired < m_Expired.size( ); ++expired )
+	{
+		const int idx{ m_Expired[expired] };
+		if ( m_Timers[idx].slot != m_Firing )
+		{
+			// Cancelled by an earlier callback of this tick
+			continue;
+		}
+		const unsigned int generation{ m_Timers[idx].generation };
+
+		// Scheduling from the callback can reallocate m_Timers, so call a moved-out copy
+		std::function<void( )> callback{ std::move( m_Timers[idx].callback ) };
+		callback( );
+		if ( m_NrClears != nrClears )
+		{
+			// The callback cleared the wheel, with the rest of this tick
+			return;
+		}
+
+		Timer& timer{ m_Timers[idx] };
+		if ( timer.slot != m_Firing || timer.generation != generation )
+		{
+			// The callback cancelled its own timer
+			continue;
+		}
+		if ( timer.intervalTicks > 0 )
+		{
+			timer.callback = std::move( callback );
+			timer.dueTick = m_Tick + timer.intervalTicks;
+			timer.sequenceNr = m_NextSequenceNr++;
+			Insert( idx );
+		}
+		else
+		{
+			Free( idx );
+		}
+	}
+	m_Expired.clear( );
+}
+
+Uint64 TimerWheel::ToTicks( float seconds )
+{
+	return seconds > 0.0f ? Uint64( seconds * 1000.0f + 0.5f ) : 0;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <vector>
+#include <functional>
+#include "GenerationalHandle.h"
+
+// 32-bit handle to a timer in a TimerWheel, see GenerationalHandle.h.
+// A handle stays safe to use after its timer fired or was cancelled, it is then no longer pending.
+struct TimerHandle : GenerationalHandle<TimerHandle>
+{
+	using GenerationalHandle::GenerationalHandle;
+};
+
+// Delays, cooldowns and spawn timers without per-frame polling.
+// Timers are kept in a hierarchical timing wheel of 4 levels of 256 slots with 1 ms ticks:
+// level 0 holds the timers due in the next 256 ms, level 1 those due in the next 65 s, ...
+// Scheduling and cancelling are O(1). Advancing only visits the slot of each elapsed tick,
+// and every 256 ticks moves the timers of one higher level slot down a level.
+// Timers due at the same tick fire in the order they were scheduled, so a replay gives the same order.
+//
+// Core owns one TimerWheel and advances it with the same elapsed time as Game::Update,
+// right before calling Update. The callbacks run on the thread that calls Update.
+class TimerWheel
+{
+public:
+	TimerWheel( );
+	TimerWheel( const TimerWheel& other ) = delete;
+	TimerWheel& operator=( const TimerWheel& other ) = delete;
+
+	// The callback fires once after delaySec, at the earliest at the next Advance
+	TimerHandle Schedule( float delaySec, std::function<void( )> callback );
+	// The callback fires every intervalSec until the timer is cancelled
+	TimerHandle ScheduleRepeating( float intervalSec, std::function<void( )> callback );
+	// Returns false when the timer already fired or was cancelled
+	bool Cancel( TimerHandle handle );
+	bool IsPending( TimerHandle handle ) const;
+	// Time left before the timer fires, 0 when it isn't pending
+	float GetRemaining( TimerHandle handle ) const;
+
+	void Advance( float elapsedSec );
+	// Cancels all timers, also from a callback: the timers of the tick being fired that didn't fire yet don't
+	void Clear( );
+
+	int GetNrPending( ) const;
+	// Time since construction, in seconds, counted in whole ticks
+	double GetTime( ) const;
+
+private:
+	struct Timer
+	{
+		std::function<void( )> callback;
+		Uint64 dueTick;
+		// Schedule order, for the order within a tick
+		Uint64 sequenceNr;
+		Uint32 intervalTicks;
+		unsigned int generation;
+		// Doubly linked list of the slot
+		int previous;
+		int next;
+		// m_NoSlot when free, m_Firing while in the list of expired timers
+		int slot;
+	};
+
+	static const int m_NrLevels{ 4 };
+	static const int m_SlotBits{ 8 };
+	static const int m_NrSlots{ 1 << m_SlotBits };
+	static const int m_NoSlot{ -1 };
+	static const int m_Firing{ -2 };
+
+	// DATA MEMBERS
+	std::vector<Timer> m_Timers;
+	int m_FirstFree;
+	// First timer of each slot, level by level
+	int m_Slots[m_NrLevels * m_NrSlots];
+	Uint64 m_Tick;
+	float m_TickFraction;
+	Uint64 m_NextSequenceNr;
+	int m_NrPending;
+	// Counts the calls of Clear, so FireTick notices a callback that cleared the wheel
+	Uint32 m_NrClears;
+	// Timer indices of the tick being fired
+	std::vector<int> m_Expired;
+
+	// FUNCTIONS
+	TimerHandle Add( float delaySec, Uint32 intervalTicks, std::function<void( )>& callback );
+	int GetIndex( TimerHandle handle ) const;
+	void Insert( int idx );
+	void Unlink( int idx );
+	void Free( int idx );
+	void Cascade( int level );
+	void FireTick( );
+	static Uint64 ToTicks( float seconds );
+};
@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+
+// Hands the newest value from one writer thread to one reader thread without locks.
+// Three copies of T: the writer fills the back one, the reader uses the front one and
+// the middle one holds the newest published value. Publishing and reading exchange
+// a buffer with the middle one, so neither thread ever waits for the other
+// and the reader always gets the newest complete value.
+//		Writer:	Fill( buffer.GetWriteBuffer( ) );	buffer.Publish( );
+//		Reader:	buffer.Update( );					Use( buffer.GetReadBuffer( ) );
+// The write buffer holds an old value, not the last published one: the writer has to fill it completely.
+template <typename T>
+class TripleBuffer
+{
+public:
+	TripleBuffer( );
+	TripleBuffer( const TripleBuffer& other ) = delete;
+	TripleBuffer& operator=( const TripleBuffer& other ) = delete;
+
+	// Writer thread
+	T& GetWriteBuffer( );
+	void Publish( );
+
+	// Reader thread, Update returns false when nothing new was published since the last Update
+	bool Update( );
+	const T& GetReadBuffer( ) const;
+
+private:
+	// The middle index has this bit set when it holds a value the reader didn't take yet
+	static const int m_NewBit{ 4 };
+	static const int m_IndexMask{ 3 };
+
+	// DATA MEMBERS
+	T m_Buffers[3];
+	// Each index on its own cache line, they are written by different threads
+	alignas( 64 ) std::atomic<int> m_Middle;
+	alignas( 64 ) int m_Back;
+	alignas( 64 ) int m_Front;
+};
+
+template <typename T>
+TripleBuffer<T>::TripleBuffer( )
+	:m_Buffers{ }
+	,m_Middle{ 1 }
+	,m_Back{ 2 }
+	,m_Front{ 0 }
+{
+}
+
+template <typename T>
+T& TripleBuffer<T>::GetWriteBuffer( )
+{
+	return m_Buffers[m_Back];
+}
+
+template <typename T>
+void TripleBuffer<T>::Publish( )
+{
+	// Release: the reader sees the complete content of the buffer
+	m_Back = m_Middle.exchange( m_Back | m_NewBit, std::memory_order_acq_rel ) & m_IndexMask;
+}
+
+template <typename T>
+bool TripleBuffer<T>::Update( )
+{
+	if ( ( m_Middle.load( std::memory_order_relaxed ) & m_NewBit ) == 0 )
+	{
+		return false;
+	}
+	// Acquire: the content written before Publish is visible
+	m_Front = m_Middle.exchange( m_Front, std::memory_order_acq_rel ) & m_IndexMask;
+	return true;
+}
+
+template <typename T>
+const T& TripleBuffer<T>::GetReadBuffer( ) const
+{
+	return m_Buffers[m_Front];
+}
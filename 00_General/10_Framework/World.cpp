@@ -0,0 +1,457 @@
+#include "stdafx.h"
+#include "World.h"
+#include <iostream>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <algorithm>
+
+namespace dae
+{
+	struct ComponentType
+	{
+		size_t size;
+		size_t alignment;
+	};
+
+	static ComponentType g_ComponentTypes[g_MaxComponentTypes]{ };
+	static int g_NrComponentTypes{ 0 };
+	static std::mutex g_ComponentTypesMutex{ };
+
+	int RegisterComponentType( size_t size, size_t alignment )
+	{
+		std::lock_guard<std::mutex> lock{ g_ComponentTypesMutex };
+		if ( g_NrComponentTypes == g_MaxComponentTypes )
+		{
+			std::cerr << "dae::RegisterComponentType( ), more than " << g_MaxComponentTypes << " component types\n";
+			std::abort( );
+		}
+		g_ComponentTypes[g_NrComponentTypes] = ComponentType{ size, alignment };
+		return g_NrComponentTypes++;
+	}
+
+	size_t GetComponentSize( int componentId )
+	{
+		return g_ComponentTypes[componentId].size;
+	}
+
+	size_t GetComponentAlignment( int componentId )
+	{
+		return g_ComponentTypes[componentId].alignment;
+	}
+}
+
+void CommandBuffer::Destroy( Entity entity )
+{
+	Record( Type::destroy, 0, -1, entity, nullptr, 0 );
+}
+
+bool CommandBuffer::IsEmpty( ) const
+{
+	return m_Data.empty( );
+}
+
+void CommandBuffer::Clear( )
+{
+	m_Data.clear( );
+}
+
+void CommandBuffer::Record( Type type, Uint64 mask, int componentId, Entity entity, const void* pComponent, size_t size )
+{
+	const Command command{ mask, type, componentId, entity, Uint32( size ) };
+	const size_t pos{ m_Data.size( ) };
+	m_Data.resize( pos + sizeof( Command ) + size );
+	std::memcpy( m_Data.data( ) + pos, &command, sizeof( Command ) );
+	if ( size > 0 )
+	{
+		std::memcpy( m_Data.data( ) + pos + sizeof( Command ), pComponent, size );
+	}
+}
+
+World::World( )
+	:m_FirstFreeRecord{ m_NoRecord }
+	,m_NrEntities{ 0 }
+	,m_QueryDepth{ 0 }
+{
+	// Archetype 0 has no components
+	GetArchetype( 0 );
+}
+
+World::~World( )
+{
+	for ( Archetype& archetype : m_Archetypes )
+	{
+		for ( char* pChunk : archetype.chunks )
+		{
+			::operator delete( pChunk, std::align_val_t{ 64 } );
+		}
+	}
+}
+
+bool World::Destroy( Entity entity )
+{
+	if ( !IsChangeAllowed( "World::Destroy( )" ) || GetRecord( entity ) == nullptr )
+	{
+		return false;
+	}
+	const int recordIdx{ int( entity.GetIndex( ) ) };
+	Record& record{ m_Records[recordIdx] };
+	FreeRow( record.archetype, record.row );
+
+	// Invalidate all handles to this record
+	record.generation = Entity::GetNextGeneration( record.generation );
+	record.archetype = -1;
+	record.row = m_FirstFreeRecord;
+	m_FirstFreeRecord = recordIdx;
+	--m_NrEntities;
+	return true;
+}
+
+bool World::IsAlive( Entity entity ) const
+{
+	return GetRecord( entity ) != nullptr;
+}
+
+int World::GetNrEntities( ) const
+{
+	return m_NrEntities;
+}
+
+int World::GetNrArchetypes( ) const
+{
+	return int( m_Archetypes.size( ) );
+}
+
+void World::Clear( )
+{
+	if ( !IsChangeAllowed( "World::Clear( )" ) )
+	{
+		return;
+	}
+	// Keep the archetypes and their chunks for the next entities, only stale the handles
+	for ( Archetype& archetype : m_Archetypes )
+	{
+		archetype.nrEntities = 0;
+	}
+	for ( int recordIdx{ 0 }; recordIdx < int( m_Records.size( ) ); ++recordIdx )
+	{
+		Record& record{ m_Records[recordIdx] };
+		if ( record.archetype >= 0 )
+		{
+			record.generation = Entity::GetNextGeneration( record.generation );
+			record.archetype = -1;
+			record.row = m_FirstFreeRecord;
+			m_FirstFreeRecord = recordIdx;
+		}
+	}
+	m_NrEntities = 0;
+}
+
+void World::Playback( CommandBuffer& commands )
+{
+	if ( !IsChangeAllowed( "World::Playback( )" ) )
+	{
+		return;
+	}
+	Entity created{ };
+	size_t pos{ 0 };
+	while ( pos < commands.m_Data.size( ) )
+	{
+		CommandBuffer::Command command;
+		std::memcpy( &command, commands.m_Data.data( ) + pos, sizeof( command ) );
+		const char* pComponent{ commands.m_Data.data( ) + pos + sizeof( command ) };
+		pos += sizeof( command ) + command.size;
+
+		switch ( command.type )
+		{
+		case CommandBuffer::Type::create:
+			created = CreateEntity( command.mask, true );
+			break;
+		case CommandBuffer::Type::destroy:
+			Destroy( command.entity );
+			break;
+		case CommandBuffer::Type::add:
+			AddComponent( command.entity.IsValid( ) ? command.entity : created, command.componentId, pComponent );
+			break;
+		case CommandBuffer::Type::remove:
+			RemoveComponent( command.entity, command.componentId );
+			break;
+		}
+	}
+	commands.Clear( );
+}
+
+int World::GetArchetype( Uint64 mask )
+{
+	std::unordered_map<Uint64, int>::const_iterator it{ m_ArchetypeIndices.find( mask ) };
+	if ( it != m_ArchetypeIndices.end( ) )
+	{
+		return it->second;
+	}
+
+	Archetype archetype{ };
+	archetype.mask = mask;
+	std::fill( std::begin( archetype.addEdges ), std::end( archetype.addEdges ), -1 );
+	std::fill( std::begin( archetype.removeEdges ), std::end( archetype.removeEdges ), -1 );
+	Layout( archetype );
+
+	const int archetypeIdx{ int( m_Archetypes.size( ) ) };
+	m_Archetypes.push_back( std::move( archetype ) );
+	m_ArchetypeIndices[mask] = archetypeIdx;
+	return archetypeIdx;
+}
+
+int World::GetAddTarget( int archetypeIdx, int componentId )
+{
+	int targetIdx{ m_Archetypes[archetypeIdx].addEdges[componentId] };
+	if ( targetIdx < 0 )
+	{
+		// Look up first, GetArchetype can move m_Archetypes
+		targetIdx = GetArchetype( m_Archetypes[archetypeIdx].mask | ( Uint64( 1 ) << componentId ) );
+		m_Archetypes[archetypeIdx].addEdges[componentId] = targetIdx;
+		m_Archetypes[targetIdx].removeEdges[componentId] = archetypeIdx;
+	}
+	return targetIdx;
+}
+
+int World::GetRemoveTarget( int archetypeIdx, int componentId )
+{
+	int targetIdx{ m_Archetypes[archetypeIdx].removeEdges[componentId] };
+	if ( targetIdx < 0 )
+	{
+		targetIdx = GetArchetype( m_Archetypes[archetypeIdx].mask & ~( Uint64( 1 ) << componentId ) );
+		m_Archetypes[archetypeIdx].removeEdges[componentId] = targetIdx;
+		m_Archetypes[targetIdx].addEdges[componentId] = archetypeIdx;
+	}
+	return targetIdx;
+}
+
+void World::Layout( Archetype& archetype ) const
+{
+	size_t rowBytes{ sizeof( Entity ) };
+	for ( int componentId{ 0 }; componentId < dae::g_MaxComponentTypes; ++componentId )
+	{
+		archetype.offsets[componentId] = -1;
+		if ( archetype.mask & ( Uint64( 1 ) << componentId ) )
+		{
+			archetype.componentIds.push_back( componentId );
+			rowBytes += dae::GetComponentSize( componentId );
+		}
+	}
+	// Huge components get a bigger chunk rather than a chunk with room for only a few of them
+	const size_t arrayAlignment{ 16 };
+	const int nrArrays{ 1 + int( archetype.componentIds.size( ) ) };
+	archetype.chunkBytes = std::max( size_t( m_ChunkBytes ), 16 * rowBytes + nrArrays * arrayAlignment );
+
+	// The arrays start 16 byte aligned for SIMD, which can make the initial estimate not fit
+	for ( int capacity{ int( archetype.chunkBytes / rowBytes ) }; capacity > 0; --capacity )
+	{
+		size_t offset{ sizeof( Entity ) * capacity };
+		for ( int componentId : archetype.componentIds )
+		{
+			const size_t alignment{ std::max( arrayAlignment, dae::GetComponentAlignment( componentId ) ) };
+			offset = ( offset + alignment - 1 ) / alignment * alignment;
+			archetype.offsets[componentId] = int( offset );
+			offset += dae::GetComponentSize( componentId ) * capacity;
+		}
+		if ( offset <= archetype.chunkBytes )
+		{
+			archetype.capacity = capacity;
+			return;
+		}
+	}
+}
+
+int World::AllocateRow( int archetypeIdx, bool isZeroed )
+{
+	Archetype& archetype{ m_Archetypes[archetypeIdx] };
+	const int row{ archetype.nrEntities };
+	if ( row / archetype.capacity == int( archetype.chunks.size( ) ) )
+	{
+		archetype.chunks.push_back( static_cast<char*>( ::operator new( archetype.chunkBytes, std::align_val_t{ 64 } ) ) );
+	}
+	++archetype.nrEntities;
+
+	// New components start zeroed, like value initialized structs
+	if ( isZeroed )
+	{
+		for ( int componentId : archetype.componentIds )
+		{
+			std::memset( GetRowData( archetype, row, componentId ), 0, dae::GetComponentSize( componentId ) );
+		}
+	}
+	return row;
+}
+
+void World::FreeRow( int archetypeIdx, int row )
+{
+	// Move the last entity into the hole to keep the entities packed
+	Archetype& archetype{ m_Archetypes[archetypeIdx] };
+	const int lastRow{ archetype.nrEntities - 1 };
+	if ( row != lastRow )
+	{
+		Entity* pLastEntity{ reinterpret_cast<Entity*>( GetRowData( archetype, lastRow, -1 ) ) };
+		*reinterpret_cast<Entity*>( GetRowData( archetype, row, -1 ) ) = *pLastEntity;
+		for ( int componentId : archetype.componentIds )
+		{
+			std::memcpy( GetRowData( archetype, row, componentId ), GetRowData( archetype, lastRow, componentId ), dae::GetComponentSize( componentId ) );
+		}
+		m_Records[pLastEntity->GetIndex( )].row = row;
+	}
+	--archetype.nrEntities;
+
+	// Keep one empty chunk, so an entity moving back and forth doesn't allocate each time
+	const int nrUsedChunks{ ( archetype.nrEntities + archetype.capacity - 1 ) / archetype.capacity };
+	while ( int( archetype.chunks.size( ) ) > nrUsedChunks + 1 )
+	{
+		::operator delete( archetype.chunks.back( ), std::align_val_t{ 64 } );
+		archetype.chunks.pop_back( );
+	}
+}
+
+char* World::GetRowData( const Archetype& archetype, int row, int componentId ) const
+{
+	// componentId -1: the entity
+	char* pChunk{ archetype.chunks[row / archetype.capacity] };
+	const int idx{ row % archetype.capacity };
+	if ( componentId < 0 )
+	{
+		return pChunk + idx * sizeof( Entity );
+	}
+	return pChunk + archetype.offsets[componentId] + idx * dae::GetComponentSize( componentId );
+}
+
+int World::GetChunkSize( const Archetype& archetype, int chunkIdx ) const
+{
+	return std::clamp( archetype.nrEntities - chunkIdx * archetype.capacity, 0, archetype.capacity );
+}
+
+void World::MoveEntity( int recordIdx, int targetIdx )
+{
+	const int sourceIdx{ m_Records[recordIdx].archetype };
+	const int sourceRow{ m_Records[recordIdx].row };
+	const int targetRow{ AllocateRow( targetIdx, true ) };
+	const Archetype& source{ m_Archetypes[sourceIdx] };
+	const Archetype& target{ m_Archetypes[targetIdx] };
+
+	*reinterpret_cast<Entity*>( GetRowData( target, targetRow, -1 ) ) = *reinterpret_cast<Entity*>( GetRowData( source, sourceRow, -1 ) );
+	for ( int componentId : source.componentIds )
+	{
+		if ( target.offsets[componentId] >= 0 )
+		{
+			std::memcpy( GetRowData( target, targetRow, componentId ), GetRowData( source, sourceRow, componentId ), dae::GetComponentSize( componentId ) );
+		}
+	}
+	FreeRow( sourceIdx, sourceRow );
+	m_Records[recordIdx].archetype = targetIdx;
+	m_Records[recordIdx].row = targetRow;
+}
+
+const World::Record* World::GetRecord( Entity entity ) const
+{
+	const unsigned int recordIdx{ entity.GetIndex( ) };
+	if ( !entity.IsValid( ) || recordIdx >= m_Records.size( ) )
+	{
+		return nullptr;
+	}
+	const Record& record{ m_Records[recordIdx] };
+	if ( record.generation != entity.GetGeneration( ) || record.archetype < 0 )
+	{
+		return nullptr;
+	}
+	return &record;
+}
+
+bool World::IsChangeAllowed( const char* pFunctionName ) const
+{
+	if ( m_QueryDepth > 0 )
+	{
+		std::cerr << pFunctionName << ", structural change during ForEach, use a CommandBuffer\n";
+		return false;
+	}
+	return true;
+}
+
+Entity World::CreateEntity( Uint64 mask, bool isZeroed )
+{
+	if ( !IsChangeAllowed( "World::Create( )" ) )
+	{
+		return Entity{ };
+	}
+	int recordIdx{ m_FirstFreeRecord };
+	if ( recordIdx != m_NoRecord )
+	{
+		m_FirstFreeRecord = m_Records[recordIdx].row;
+	}
+	else if ( m_Records.size( ) < Entity::indexMask )
+	{
+		recordIdx = int( m_Records.size( ) );
+		m_Records.push_back( Record{ -1, m_NoRecord, 1 } );
+	}
+	else
+	{
+		std::cerr << "World::Create( ), the world is full, capacity: " << Entity::indexMask << '\n';
+		return Entity{ };
+	}
+
+	const int archetypeIdx{ GetArchetype( mask ) };
+	Record& record{ m_Records[recordIdx] };
+	record.archetype = archetypeIdx;
+	record.row = AllocateRow( archetypeIdx, isZeroed );
+	const Entity entity{ unsigned( recordIdx ), record.generation };
+	*reinterpret_cast<Entity*>( GetRowData( m_Archetypes[archetypeIdx], record.row, -1 ) ) = entity;
+	++m_NrEntities;
+	return entity;
+}
+
+bool World::AddComponent( Entity entity, int componentId, const void* pComponent )
+{
+	const Record* pRecord{ GetRecord( entity ) };
+	if ( pRecord == nullptr )
+	{
+		return false;
+	}
+	if ( m_Archetypes[pRecord->archetype].offsets[componentId] < 0 )
+	{
+		if ( !IsChangeAllowed( "World::Add( )" ) )
+		{
+			return false;
+		}
+		const int recordIdx{ int( entity.GetIndex( ) ) };
+		MoveEntity( recordIdx, GetAddTarget( pRecord->archetype, componentId ) );
+	}
+	std::memcpy( GetRowData( m_Archetypes[pRecord->archetype], pRecord->row, componentId ), pComponent, dae::GetComponentSize( componentId ) );
+	return true;
+}
+
+bool World::RemoveComponent( Entity entity, int componentId )
+{
+	const Record* pRecord{ GetRecord( entity ) };
+	if ( pRecord == nullptr || m_Archetypes[pRecord->archetype].offsets[componentId] < 0 || !IsChangeAllowed( "World::Remove( )" ) )
+	{
+		return false;
+	}
+	const int recordIdx{ int( entity.GetIndex( ) ) };
+	MoveEntity( recordIdx, GetRemoveTarget( pRecord->archetype, componentId ) );
+	return true;
+}
+
+void* World::GetComponent( Entity entity, int componentId )
+{
+	const Record* pRecord{ GetRecord( entity ) };
+	if ( pRecord == nullptr || m_Archetypes[pRecord->archetype].offsets[componentId] < 0 )
+	{
+		return nullptr;
+	}
+	return GetRowData( m_Archetypes[pRecord->archetype], pRecord->row, componentId );
+}
+
+const void* World::GetComponent( Entity entity, int componentId ) const
+{
+	const Record* pRecord{ GetRecord( entity ) };
+	if ( pRecord == nullptr || m_Archetypes[pRecord->archetype].offsets[componentId] < 0 )
+	{
+		return nullptr;
+	}
+	return GetRowData( m_Archetypes[pRecord->archetype], pRecord->row, componentId );
+}
@@ -0,0 +1,382 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <type_traits>
+#include <algorithm>
+#include <cstring>
+#include "GenerationalHandle.h"
+
+// Entity component storage, grouped by archetype.
+// An entity is a handle, its data are components: plain structs such as Point2f, Vector2f or Color4f.
+// All entities with the same set of component types (an archetype) are stored together, in chunks of 16 KB
+// holding one array per component type. A query only visits the chunks of the archetypes that have
+// all requested components and walks their arrays linearly, so it doesn't touch data it doesn't use.
+//		struct Radius { float value; };
+//		World world{ };
+//		Entity ball{ world.Create( Point2f{ 10, 20 }, Vector2f{ 50, 80 }, Radius{ 5 } ) };
+//		world.ForEach<Point2f, Vector2f>( [elapsedSec]( Entity entity, Point2f& position, Vector2f& velocity )
+//		{
+//			position.x += velocity.x * elapsedSec;
+//			position.y += velocity.y * elapsedSec;
+//		} );
+//
+// Components are moved with memcpy, so they have to be trivially copyable, and each type is one component:
+// wrap a float in a struct to give it a meaning. There are at most 64 component types.
+// Adding or removing components and creating or destroying entities (structural changes) moves entities
+// between chunks. That isn't allowed while a query runs: record them in a CommandBuffer and Playback it after.
+
+// 32-bit generational handle to an entity of a World, see GenerationalHandle.h
+struct Entity : GenerationalHandle<Entity>
+{
+	using GenerationalHandle::GenerationalHandle;
+};
+
+namespace dae
+{
+	const int g_MaxComponentTypes{ 64 };
+
+	// Called once per type by GetComponentId
+	int RegisterComponentType( size_t size, size_t alignment );
+	size_t GetComponentSize( int componentId );
+	size_t GetComponentAlignment( int componentId );
+
+	template <typename T>
+	int GetComponentId( )
+	{
+		static_assert( std::is_trivially_copyable_v<T>, "Components are moved with memcpy" );
+		static const int componentId{ RegisterComponentType( sizeof( T ), alignof( T ) ) };
+		return componentId;
+	}
+
+	template <typename... Ts>
+	Uint64 GetComponentMask( )
+	{
+		return ( Uint64( 0 ) | ... | ( Uint64( 1 ) << GetComponentId<Ts>( ) ) );
+	}
+}
+
+// Structural changes recorded during a query, applied in recording order by World::Playback
+class CommandBuffer
+{
+public:
+	CommandBuffer( ) = default;
+
+	// The Add commands recorded right after a Create go to the created entity
+	template <typename... Ts>
+	void Create( const Ts&... components );
+	void Destroy( Entity entity );
+	template <typename T>
+	void Add( Entity entity, const T& component );
+	template <typename T>
+	void Remove( Entity entity );
+
+	bool IsEmpty( ) const;
+	void Clear( );
+
+private:
+	friend class World;
+
+	enum class Type
+	{
+		create,
+		destroy,
+		add,
+		remove
+	};
+	// Followed by size bytes of component data
+	struct Command
+	{
+		Uint64 mask;
+		Type type;
+		int componentId;
+		// Invalid for the Add commands of a Create
+		Entity entity;
+		Uint32 size;
+	};
+
+	// DATA MEMBERS
+	std::vector<char> m_Data;
+
+	// FUNCTIONS
+	void Record( Type type, Uint64 mask, int componentId, Entity entity, const void* pComponent, size_t size );
+};
+
+class World
+{
+public:
+	World( );
+	World( const World& other ) = delete;
+	World& operator=( const World& other ) = delete;
+	~World( );
+
+	// Returns an invalid entity when there are already 2^20 - 1 entities
+	template <typename... Ts>
+	Entity Create( const Ts&... components );
+	// Returns false when the entity is stale
+	bool Destroy( Entity entity );
+	bool IsAlive( Entity entity ) const;
+
+	// Adding a component the entity already has overwrites it
+	template <typename T>
+	bool Add( Entity entity, const T& component );
+	template <typename T>
+	bool Remove( Entity entity );
+	template <typename T>
+	bool Has( Entity entity ) const;
+	// Returns nullptr when the entity is stale or doesn't have the component.
+	// The pointer is only valid until the next structural change.
+	template <typename T>
+	T* Get( Entity entity );
+
+	int GetNrEntities( ) const;
+	int GetNrArchetypes( ) const;
+	void Clear( );
+
+	// Calls function( Entity, Ts&... ) for each entity that has all components Ts
+	template <typename... Ts, typename Function>
+	void ForEach( Function&& function );
+	// Same, spreading the chunks over nrThreads threads (0: one per core).
+	// function( CommandBuffer&, Entity, Ts&... ) gets the command buffer of its thread,
+	// they are played back in thread order when all threads are done, so the result doesn't depend on timing.
+	// Does nothing when called inside another query, as that playback would be a structural change during the query
+	template <typename... Ts, typename Function>
+	void ParallelForEach( Function&& function, int nrThreads = 0 );
+
+	// Applies the recorded changes and clears the buffer
+	void Playback( CommandBuffer& commands );
+
+private:
+	struct Archetype
+	{
+		Uint64 mask;
+		size_t chunkBytes;
+		// Entities per chunk
+		int capacity;
+		// The entities are packed: all chunks are full except the last ones
+		int nrEntities;
+		std::vector<char*> chunks;
+		// The component types of the archetype, in id order
+		std::vector<int> componentIds;
+		// Byte offset of the array of each component type in a chunk, -1 when the archetype doesn't have it.
+		// The Entity array is at offset 0.
+		int offsets[dae::g_MaxComponentTypes];
+		// Archetype with one component type more or less, -1 when not looked up yet
+		int addEdges[dae::g_MaxComponentTypes];
+		int removeEdges[dae::g_MaxComponentTypes];
+	};
+	struct Record
+	{
+		int archetype;
+		// Row in the archetype while alive, next free record while free
+		int row;
+		unsigned int generation;
+	};
+	struct ChunkJob
+	{
+		int archetype;
+		int chunk;
+	};
+
+	static const int m_NoRecord{ -1 };
+	static const size_t m_ChunkBytes{ 16 * 1024 };
+
+	// DATA MEMBERS
+	std::vector<Archetype> m_Archetypes;
+	std::unordered_map<Uint64, int> m_ArchetypeIndices;
+	std::vector<Record> m_Records;
+	int m_FirstFreeRecord;
+	int m_NrEntities;
+	// Structural changes are refused while > 0
+	int m_QueryDepth;
+	std::vector<ChunkJob> m_Jobs;
+	std::vector<CommandBuffer> m_ThreadCommands;
+
+	// FUNCTIONS
+	int GetArchetype( Uint64 mask );
+	int GetAddTarget( int archetypeIdx, int componentId );
+	int GetRemoveTarget( int archetypeIdx, int componentId );
+	void Layout( Archetype& archetype ) const;
+	// The components of the new row are zeroed unless the caller overwrites all of them
+	int AllocateRow( int archetypeIdx, bool isZeroed );
+	void FreeRow( int archetypeIdx, int row );
+	char* GetRowData( const Archetype& archetype, int row, int componentId ) const;
+	int GetChunkSize( const Archetype& archetype, int chunkIdx ) const;
+	void MoveEntity( int recordIdx, int targetIdx );
+
+	const Record* GetRecord( Entity entity ) const;
+	bool IsChangeAllowed( const char* pFunctionName ) const;
+	Entity CreateEntity( Uint64 mask, bool isZeroed );
+	bool AddComponent( Entity entity, int componentId, const void* pComponent );
+	bool RemoveComponent( Entity entity, int componentId );
+	void* GetComponent( Entity entity, int componentId );
+	const void* GetComponent( Entity entity, int componentId ) const;
+
+	template <typename... Ts, typename Function>
+	void ForEachInChunk( const Archetype& archetype, int chunkIdx, Function& function );
+};
+
+template <typename... Ts>
+void CommandBuffer::Create( const Ts&... components )
+{
+	Record( Type::create, dae::GetComponentMask<Ts...>( ), -1, Entity{ }, nullptr, 0 );
+	( Add( Entity{ }, components ), ... );
+}
+
+template <typename T>
+void CommandBuffer::Add( Entity entity, const T& component )
+{
+	Record( Type::add, 0, dae::GetComponentId<T>( ), entity, &component, sizeof( T ) );
+}
+
+template <typename T>
+void CommandBuffer::Remove( Entity entity )
+{
+	Record( Type::remove, 0, dae::GetComponentId<T>( ), entity, nullptr, 0 );
+}
+
+template <typename... Ts>
+Entity World::Create( const Ts&... components )
+{
+	// Created directly in its final archetype, the components are then copied in place
+	Entity entity{ CreateEntity( dae::GetComponentMask<Ts...>( ), false ) };
+	if ( entity.IsValid( ) )
+	{
+		const Record& record{ m_Records[entity.GetIndex( )] };
+		const Archetype& archetype{ m_Archetypes[record.archetype] };
+		char* pChunk{ archetype.chunks[record.row / archetype.capacity] };
+		const int idx{ record.row % archetype.capacity };
+		( std::memcpy( pChunk + archetype.offsets[dae::GetComponentId<Ts>( )] + idx * sizeof( Ts ), &components, sizeof( Ts ) ), ... );
+	}
+	return entity;
+}
+
+template <typename T>
+bool World::Add( Entity entity, const T& component )
+{
+	return AddComponent( entity, dae::GetComponentId<T>( ), &component );
+}
+
+template <typename T>
+bool World::Remove( Entity entity )
+{
+	return RemoveComponent( entity, dae::GetComponentId<T>( ) );
+}
+
+template <typename T>
+bool World::Has( Entity entity ) const
+{
+	return GetComponent( entity, dae::GetComponentId<T>( ) ) != nullptr;
+}
+
+template <typename T>
+T* World::Get( Entity entity )
+{
+	return static_cast<T*>( GetComponent( entity, dae::GetComponentId<T>( ) ) );
+}
+
+template <typename... Ts, typename Function>
+void World::ForEach( Function&& function )
+{
+	const Uint64 mask{ dae::GetComponentMask<Ts...>( ) };
+	++m_QueryDepth;
+	for ( const Archetype& archetype : m_Archetypes )
+	{
+		if ( ( archetype.mask & mask ) != mask )
+		{
+			continue;
+		}
+		for ( int chunkIdx{ 0 }; chunkIdx < int( archetype.chunks.size( ) ); ++chunkIdx )
+		{
+			ForEachInChunk<Ts...>( archetype, chunkIdx, function );
+		}
+	}
+	--m_QueryDepth;
+}
+
+template <typename... Ts, typename Function>
+void World::ParallelForEach( Function&& function, int nrThreads )
+{
+	// Also keeps a nested call from replacing the jobs of the running one
+	if ( !IsChangeAllowed( "World::ParallelForEach( )" ) )
+	{
+		return;
+	}
+	const Uint64 mask{ dae::GetComponentMask<Ts...>( ) };
+	m_Jobs.clear( );
+	for ( int archetypeIdx{ 0 }; archetypeIdx < int( m_Archetypes.size( ) ); ++archetypeIdx )
+	{
+		const Archetype& archetype{ m_Archetypes[archetypeIdx] };
+		if ( ( archetype.mask & mask ) != mask )
+		{
+			continue;
+		}
+		for ( int chunkIdx{ 0 }; chunkIdx < int( archetype.chunks.size( ) ); ++chunkIdx )
+		{
+			if ( GetChunkSize( archetype, chunkIdx ) > 0 )
+			{
+				m_Jobs.push_back( ChunkJob{ archetypeIdx, chunkIdx } );
+			}
+		}
+	}
+
+	const int nrJobs{ int( m_Jobs.size( ) ) };
+	if ( nrThreads <= 0 )
+	{
+		nrThreads = std::max( 1, int( std::thread::hardware_concurrency( ) ) );
+	}
+	nrThreads = std::max( 1, std::min( nrThreads, nrJobs ) );
+	if ( int( m_ThreadCommands.size( ) ) < nrThreads )
+	{
+		m_ThreadCommands.resize( nrThreads );
+	}
+
+	// Each thread gets a contiguous range of chunks, the calling thread does the first one
+	++m_QueryDepth;
+	auto runJobs = [this, &function, nrJobs, nrThreads]( int threadIdx )
+	{
+		CommandBuffer& commands{ m_ThreadCommands[threadIdx] };
+		auto withCommands = [&function, &commands]( Entity entity, Ts&... components )
+		{
+			function( commands, entity, components... );
+		};
+		const int lastJob{ nrJobs * ( threadIdx + 1 ) / nrThreads };
+		for ( int jobIdx{ nrJobs * threadIdx / nrThreads }; jobIdx < lastJob; ++jobIdx )
+		{
+			ForEachInChunk<Ts...>( m_Archetypes[m_Jobs[jobIdx].archetype], m_Jobs[jobIdx].chunk, withCommands );
+		}
+	};
+	std::vector<std::thread> threads{ };
+	threads.reserve( nrThreads - 1 );
+	for ( int threadIdx{ 1 }; threadIdx < nrThreads; ++threadIdx )
+	{
+		threads.emplace_back( runJobs, threadIdx );
+	}
+	runJobs( 0 );
+	for ( std::thread& thread : threads )
+	{
+		thread.join( );
+	}
+	--m_QueryDepth;
+
+	for ( int threadIdx{ 0 }; threadIdx < nrThreads; ++threadIdx )
+	{
+		Playback( m_ThreadCommands[threadIdx] );
+	}
+}
+
+template <typename... Ts, typename Function>
+void World::ForEachInChunk( const Archetype& archetype, int chunkIdx, Function& function )
+{
+	char* pChunk{ archetype.chunks[chunkIdx] };
+	const Entity* pEntities{ reinterpret_cast<const Entity*>( pChunk ) };
+	const int size{ GetChunkSize( archetype, chunkIdx ) };
+	// The array pointers are looked up once per chunk, the loop itself only indexes them
+	[pEntities, size, &function]( Ts*... pArrays )
+	{
+		for ( int idx{ 0 }; idx < size; ++idx )
+		{
+			function( pEntities[idx], pArrays[idx]... );
+		}
+	}( reinterpret_cast<Ts*>( pChunk + archetype.offsets[dae::GetComponentId<Ts>( )] )... );
+}
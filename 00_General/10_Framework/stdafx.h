@@ -0,0 +1,29 @@
+// stdafx.h : include file for standard system include files,
+// or project specific include files that are used frequently, but
+// are changed infrequently
+//
+#pragma once
+
+#include "targetver.h"
+
+// TODO: reference additional headers your program requires here
+// SDL libs
+#pragma comment(lib, "sdl2.lib")
+#pragma comment(lib, "SDL2main.lib")
+
+// OpenGL libs
+#pragma comment (lib,"opengl32.lib")
+#pragma comment (lib,"Glu32.lib")
+
+// SDL extension libs 
+#pragma comment(lib, "SDL2_image.lib")  
+#pragma comment(lib, "SDL2_ttf.lib") 
+
+// SDL and OpenGL Includes
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <GL\GLU.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h> 
+
+#include "structs.h"
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "stdafx.h"
+#include "structs.h"
+
+//-----------------------------------------------------------------
+// Window Constructors
+//-----------------------------------------------------------------
+Window::Window( const std::string& title , float width , float height , bool isVSyncOn , float maxFps , bool isLowLatencyOn , float simulationRate )
+	:title{ title }
+	,width{ width }
+	,height{ height }
+	,isVSyncOn{ isVSyncOn }
+	,maxFps{ maxFps }
+	,isLowLatencyOn{ isLowLatencyOn }
+	,simulationRate{ simulationRate }
+{
+}
+
+//-----------------------------------------------------------------
+// Point2f Constructors
+//-----------------------------------------------------------------
+Point2f::Point2f( )
+	:Point2f{ 0.0f, 0.0f }
+{
+}
+Point2f::Point2f( float x, float y )
+	:x{ x }, y{ y }
+{
+}
+
+//-----------------------------------------------------------------
+// Rectf Constructors
+//-----------------------------------------------------------------
+Rectf::Rectf( )
+	:Rectf{ 0.0f, 0.0f, 0.0f, 0.0f }
+{
+}
+
+Rectf::Rectf( float left, float bottom, float width, float height )
+	:left{ left }
+	,bottom{ bottom }
+	,width{ width }
+	,height{ height }
+{
+}
+
+//-----------------------------------------------------------------
+// Color4f Constructors
+//-----------------------------------------------------------------
+Color4f::Color4f( )
+	:Color4f{ 0.0f, 0.0f, 0.0f, 1.0f }
+{
+}
+
+Color4f::Color4f( float r, float g, float b, float a )
+	:r{ r }
+	,g{ g }
+	,b{ b }
+	,a{ a }
+{
+}
+
+//-----------------------------------------------------------------
+// Circlef Constructors
+//-----------------------------------------------------------------
+Circlef::Circlef( )
+	:Circlef{ 0.0f, 0.0f, 0.0f }
+{
+}
+
+Circlef::Circlef( float centerX, float centerY, float radius )
+	:Circlef{ Point2f{ centerX, centerY }, radius }
+{
+}
+
+Circlef::Circlef( const Point2f& center, float radius )
+	:center{ center }
+	,radius{ radius }
+{
+}
+
@@ -0,0 +1,62 @@
+#pragma once
+#include <string>
+
+struct Window
+{
+	Window( const std::string& title = "Title", float width = 320.0f, 
+		float height = 180.0f, bool isVSyncOn = true, float maxFps = 0.0f, bool isLowLatencyOn = false, float simulationRate = 0.0f );
+
+	std::string title;
+	float width;
+	float height;
+	bool isVSyncOn;
+	// Frame rate cap, 0 for none
+	float maxFps;
+	// Sample input and update as late as possible before the next swap, see FramePacer.h
+	bool isLowLatencyOn;
+	// Updates per second on a separate simulation thread, 0 to update on the render thread.
+	// The game then draws snapshots, see Game::MakeSnapshot, and can't make OpenGL calls or create and destroy Textures in Update (see GameSnapshot)
+	float simulationRate;
+};
+struct Point2f
+{
+	Point2f( );
+	Point2f( float x, float y );
+
+	float x;
+	float y;
+};
+
+struct Rectf
+{
+	Rectf( );
+	Rectf( float left, float bottom, float width, float height );
+
+	float left;
+	float bottom;
+	float width;
+	float height;
+};
+
+
+struct Color4f
+{
+	Color4f( );
+	Color4f( float r, float g, float b, float a );
+	
+	float r;
+	float g;
+	float b;
+	float a;
+};
+
+struct Circlef
+{
+	Circlef( );
+	Circlef( const Point2f& center, float radius );
+	Circlef( float centerX, float centerY, float radius );
+
+	Point2f center;
+	float radius;
+};
+
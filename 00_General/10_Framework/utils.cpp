@@ -0,0 +1,397 @@
+#include "stdafx.h"
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+#include <cfloat>
+#include "utils.h"
+#include "RenderBackend.h"
+
+namespace dae
+{
+	// Vertices of the ellipses and arcs, reused to avoid an allocation per draw
+	static std::vector<Point2f> s_Vertices;
+
+	// Vertices on the ellipse from fromAngle till tillAngle (included), about one per pixel of the largest radius
+	static void AddArcVertices( float centerX, float centerY, float radX, float radY, float fromAngle, float tillAngle, float dAngle )
+	{
+		for ( float angle = fromAngle; angle < tillAngle; angle += dAngle )
+		{
+			s_Vertices.push_back( Point2f{ centerX + radX * float( cos( angle ) ), centerY + radY * float( sin( angle ) ) } );
+		}
+		s_Vertices.push_back( Point2f{ centerX + radX * float( cos( tillAngle ) ), centerY + radY * float( sin( tillAngle ) ) } );
+	}
+
+	void SetColor( const Color4f& color )
+	{
+		SetRenderColor( color );
+	}
+
+	void DrawPoint( float x, float y, float pointSize )
+	{
+		SetRenderPointSize( pointSize );
+		const Point2f vertex{ x, y };
+		RenderVertices( GL_POINTS, &vertex, 1 );
+	}
+
+	void DrawPoint( const Point2f & p, float pointSize )
+	{
+		DrawPoint( p.x, p.y, pointSize );
+	}
+
+	void DrawPoints( Point2f *pVertices, int nrVertices, float pointSize )
+	{
+		SetRenderPointSize( pointSize );
+		RenderVertices( GL_POINTS, pVertices, nrVertices );
+	}
+
+	void DrawLine(float x1, float y1, float x2, float y2, float lineWidth)
+	{
+		SetRenderLineWidth( lineWidth );
+		const Point2f vertices[]{ Point2f{ x1, y1 }, Point2f{ x2, y2 } };
+		RenderVertices( GL_LINES, vertices, 2 );
+	}
+
+	void DrawLine( const Point2f & p1, const Point2f & p2, float lineWidth )
+	{
+		DrawLine( p1.x, p1.y, p2.x, p2.y, lineWidth );
+	}
+
+	void DrawRect(float left, float bottom, float width, float height, float lineWidth)
+	{
+		SetRenderLineWidth( lineWidth );
+		const Point2f vertices[]
+		{
+			Point2f{ left, bottom },
+			Point2f{ left + width, bottom },
+			Point2f{ left + width, bottom + height },
+			Point2f{ left, bottom + height }
+		};
+		RenderVertices( GL_LINE_LOOP, vertices, 4 );
+	}
+
+	void DrawRect(const Point2f & bottomLeft, float width, float height, float lineWidth)
+	{
+		DrawRect(bottomLeft.x, bottomLeft.y, width, height, lineWidth);
+	}
+
+	void DrawRect(const Rectf & rect, float lineWidth)
+	{
+		DrawRect(rect.left, rect.bottom, rect.width, rect.height, lineWidth);
+	}
+
+	void FillRect(float left, float bottom, float width, float height)
+	{
+		const Point2f vertices[]
+		{
+			Point2f{ left, bottom },
+			Point2f{ left + width, bottom },
+			Point2f{ left + width, bottom + height },
+			Point2f{ left, bottom + height }
+		};
+		RenderVertices( GL_POLYGON, vertices, 4 );
+	}
+
+	void FillRect(const Point2f & bottomLeft, float width, float height)
+	{
+		FillRect(bottomLeft.x, bottomLeft.y, width, height);
+	}
+
+	void FillRect(const Rectf & rect)
+	{
+		FillRect(rect.left, rect.bottom, rect.width, rect.height);
+	}
+
+	void DrawEllipse( float centerX, float centerY, float radX, float radY, float lineWidth )
+	{
+		float dAngle{ radX > radY ? float( M_PI / radX ) : float( M_PI / radY ) };
+
+		SetRenderLineWidth( lineWidth );
+		s_Vertices.clear( );
+		for ( float angle = 0.0; angle < float( 2 * M_PI + dAngle ); angle += dAngle )
+		{
+			s_Vertices.push_back( Point2f{ centerX + radX * float( cos( angle ) ), centerY + radY * float( sin( angle ) ) } );
+		}
+		RenderVertices( GL_LINE_LOOP, s_Vertices.data( ), int( s_Vertices.size( ) ) );
+	}
+
+	void DrawEllipse( const Point2f & center, float radX, float radY, float lineWidth )
+	{
+		DrawEllipse( center.x, center.y, radX, radY, lineWidth );
+	}
+
+	void FillEllipse(float centerX, float centerY, float radX, float radY)
+	{
+		float dAngle{ radX > radY ? float( M_PI / radX ): float( M_PI / radY ) };
+
+		s_Vertices.clear( );
+		for ( float angle = 0.0; angle < float( 2 * M_PI + dAngle ); angle += dAngle )
+		{
+			s_Vertices.push_back( Point2f{ centerX + radX * float( cos( angle ) ), centerY + radY * float( sin( angle ) ) } );
+		}
+		RenderVertices( GL_POLYGON, s_Vertices.data( ), int( s_Vertices.size( ) ) );
+	}
+
+	void FillEllipse(const Point2f & center, float radX, float radY)
+	{
+		FillEllipse(center.x, center.y, radX, radY);
+	}
+
+	void DrawArc( float centerX, float centerY, float radX, float radY, float fromAngle, float tillAngle, float lineWidth )
+	{
+		if ( fromAngle > tillAngle )
+		{
+			return;
+		}
+
+		float dAngle{ radX > radY ? float( M_PI / radX ) : float( M_PI / radY ) };
+
+		SetRenderLineWidth( lineWidth );
+		s_Vertices.clear( );
+		AddArcVertices( centerX, centerY, radX, radY, fromAngle, tillAngle, dAngle );
+		RenderVertices( GL_LINE_STRIP, s_Vertices.data( ), int( s_Vertices.size( ) ) );
+	}
+	
+	void DrawArc( const Point2f & center, float radX, float radY, float fromAngle, float tillAngle, float lineWidth )
+	{
+		DrawArc( center.x, center.y, radX, radY, fromAngle, tillAngle, lineWidth );
+	}
+
+	void FillArc( float centerX, float centerY, float radX, float radY, float fromAngle, float tillAngle )
+	{
+		if ( fromAngle > tillAngle )
+		{
+			return;
+		}
+		float dAngle{ radX > radY ? float( M_PI / radX ) : float( M_PI / radY ) };
+
+		s_Vertices.clear( );
+		s_Vertices.push_back( Point2f{ centerX, centerY } );
+		AddArcVertices( centerX, centerY, radX, radY, fromAngle, tillAngle, dAngle );
+		RenderVertices( GL_POLYGON, s_Vertices.data( ), int( s_Vertices.size( ) ) );
+	}
+
+	void FillArc( const Point2f & center, float radX, float radY, float fromAngle, float tillAngle )
+	{
+		FillArc( center.x, center.y, radX, radY, fromAngle, tillAngle );
+	}
+
+	void DrawPolygon( Point2f *pVertices, int nrVertices, bool closed, float lineWidth  )
+	{
+		SetRenderLineWidth( lineWidth );
+		RenderVertices( closed ? GL_LINE_LOOP : GL_LINE_STRIP, pVertices, nrVertices );
+	}
+
+	void FillPolygon( Point2f *pVertices, int nrVertices )
+	{
+		RenderVertices( GL_POLYGON, pVertices, nrVertices );
+	}
+
+	// Outward normal of the face of the box [minX,maxX]x[minY,maxY] that is closest to a point inside it
+	static Vector2f NearestFaceNormal( const Point2f& point, float minX, float minY, float maxX, float maxY )
+	{
+		Vector2f normal{ -1.0f, 0.0f };
+		float minDist{ point.x - minX };
+		if ( maxX - point.x < minDist )
+		{
+			minDist = maxX - point.x;
+			normal.Set( 1.0f, 0.0f );
+		}
+		if ( point.y - minY < minDist )
+		{
+			minDist = point.y - minY;
+			normal.Set( 0.0f, -1.0f );
+		}
+		if ( maxY - point.y < minDist )
+		{
+			normal.Set( 0.0f, 1.0f );
+		}
+		return normal;
+	}
+
+	// Ray from origin over displacement against the box [minX,maxX]x[minY,maxY]
+	static bool RaycastBox( const Point2f& origin, const Vector2f& displacement, float minX, float minY, float maxX, float maxY, HitInfo& hitInfo )
+	{
+		// Origin already inside the box: report the nearest face, unless moving out of the box
+		if ( origin.x > minX && origin.x < maxX && origin.y > minY && origin.y < maxY )
+		{
+			Vector2f normal{ NearestFaceNormal( origin, minX, minY, maxX, maxY ) };
+			if ( displacement.DotProduct( normal ) >= 0.0f )
+			{
+				return false;
+			}
+			hitInfo.lambda = 0.0f;
+			hitInfo.intersectPoint = origin;
+			hitInfo.normal = normal;
+			return true;
+		}
+
+		// Slab test, keeping track of the face through which the ray enters
+		float tEnter{ -FLT_MAX };
+		float tExit{ FLT_MAX };
+		Vector2f normal{};
+		if ( displacement.x == 0.0f )
+		{
+			if ( origin.x < minX || origin.x > maxX )
+			{
+				return false;
+			}
+		}
+		else
+		{
+			float t1{ ( minX - origin.x ) / displacement.x };
+			float t2{ ( maxX - origin.x ) / displacement.x };
+			tEnter = std::min( t1, t2 );
+			tExit = std::max( t1, t2 );
+			normal.Set( displacement.x > 0.0f ? -1.0f : 1.0f, 0.0f );
+		}
+		if ( displacement.y == 0.0f )
+		{
+			if ( origin.y < minY || origin.y > maxY )
+			{
+				return false;
+			}
+		}
+		else
+		{
+			float t1{ ( minY - origin.y ) / displacement.y };
+			float t2{ ( maxY - origin.y ) / displacement.y };
+			if ( std::min( t1, t2 ) > tEnter )
+			{
+				tEnter = std::min( t1, t2 );
+				normal.Set( 0.0f, displacement.y > 0.0f ? -1.0f : 1.0f );
+			}
+			tExit = std::min( tExit, std::max( t1, t2 ) );
+		}
+
+		if ( tEnter > tExit || tEnter < 0.0f || tEnter > 1.0f )
+		{
+			return false;
+		}
+		hitInfo.lambda = tEnter;
+		hitInfo.intersectPoint = Point2f{ origin.x + displacement.x * tEnter, origin.y + displacement.y * tEnter };
+		hitInfo.normal = normal;
+		return true;
+	}
+
+	bool SweptAABB( const Rectf& movingRect, const Vector2f& displacement, const Rectf& staticRect, HitInfo& hitInfo )
+	{
+		// Minkowski sum: sweep the bottom-left corner against the static rect grown by the moving rect's size
+		return RaycastBox( Point2f{ movingRect.left, movingRect.bottom }, displacement,
+			staticRect.left - movingRect.width, staticRect.bottom - movingRect.height,
+			staticRect.left + staticRect.width, staticRect.bottom + staticRect.height, hitInfo );
+	}
+
+	bool SweptCircle( const Circlef& movingCircle, const Vector2f& displacement, const Rectf& staticRect, HitInfo& hitInfo )
+	{
+		const Point2f& center{ movingCircle.center };
+		const float radius{ movingCircle.radius };
+		const float left{ staticRect.left };
+		const float bottom{ staticRect.bottom };
+		const float right{ staticRect.left + staticRect.width };
+		const float top{ staticRect.bottom + staticRect.height };
+
+		// Already overlapping: push out along the direction from the closest point on the rect
+		Point2f closest{ std::max( left, std::min( center.x, right ) ), std::max( bottom, std::min( center.y, top ) ) };
+		Vector2f toCenter{ closest, center };
+		if ( toCenter.SquaredLength( ) < radius * radius )
+		{
+			Vector2f normal{ toCenter.SquaredLength( ) > 0.0f ? toCenter.Normalized( 0.0f ) : NearestFaceNormal( center, left, bottom, right, top ) };
+			if ( displacement.DotProduct( normal ) >= 0.0f )
+			{
+				return false;
+			}
+			hitInfo.lambda = 0.0f;
+			hitInfo.intersectPoint = center;
+			hitInfo.normal = normal;
+			return true;
+		}
+
+		// Minkowski sum of rect and circle: a rect grown by the radius with rounded corners.
+		// First find where the center enters the grown rect.
+		Point2f entry{ center };
+		bool isInGrownRect{ center.x > left - radius && center.x < right + radius && center.y > bottom - radius && center.y < top + radius };
+		if ( !isInGrownRect )
+		{
+			if ( !RaycastBox( center, displacement, left - radius, bottom - radius, right + radius, top + radius, hitInfo ) )
+			{
+				return false;
+			}
+			entry = hitInfo.intersectPoint;
+		}
+
+		// Not in a corner region: the straight edge is hit
+		// (a center inside the grown rect but outside the corners overlaps, which is handled above)
+		bool isLeftOrRight{ entry.x < left || entry.x > right };
+		bool isBelowOrAbove{ entry.y < bottom || entry.y > top };
+		if ( !( isLeftOrRight && isBelowOrAbove ) )
+		{
+			return !isInGrownRect;
+		}
+
+		// Corner region: intersect with the circle around that corner
+		Point2f corner{ entry.x < left ? left : right, entry.y < bottom ? bottom : top };
+		Vector2f fromCorner{ corner, center };
+		float a{ displacement.SquaredLength( ) };
+		float b{ fromCorner.DotProduct( displacement ) };
+		float c{ fromCorner.SquaredLength( ) - radius * radius };
+		float discriminant{ b * b - a * c };
+		if ( a == 0.0f || discriminant < 0.0f )
+		{
+			return false;
+		}
+		float lambda{ ( -b - sqrtf( discriminant ) ) / a };
+		if ( lambda < 0.0f || lambda > 1.0f )
+		{
+			return false;
+		}
+		hitInfo.lambda = lambda;
+		hitInfo.intersectPoint = Point2f{ center.x + displacement.x * lambda, center.y + displacement.y * lambda };
+		hitInfo.normal = Vector2f{ corner, hitInfo.intersectPoint } / radius;
+		return true;
+	}
+
+	bool ResolveSweptCircle( Circlef& circle, Vector2f& velocity, float elapsedSec, const Rectf *pRects, int nrRects, int maxSubSteps )
+	{
+		// Distance kept from a surface after a hit, so the next sub-step does not start inside it
+		const float skinWidth{ 0.01f };
+
+		bool isHit{ false };
+		float remainingSec{ elapsedSec };
+		for ( int step{ 0 }; step < maxSubSteps && remainingSec > 0.0f; ++step )
+		{
+			Vector2f displacement{ velocity * remainingSec };
+
+			// Find the earliest time of impact
+			HitInfo firstHit{};
+			firstHit.lambda = FLT_MAX;
+			for ( int idx{ 0 }; idx < nrRects; ++idx )
+			{
+				HitInfo hitInfo{};
+				if ( SweptCircle( circle, displacement, pRects[idx], hitInfo ) && hitInfo.lambda < firstHit.lambda )
+				{
+					firstHit = hitInfo;
+				}
+			}
+
+			if ( firstHit.lambda == FLT_MAX )
+			{
+				circle.center.x += displacement.x;
+				circle.center.y += displacement.y;
+				return isHit;
+			}
+			isHit = true;
+
+			// Sub-step till the time of impact and reflect the velocity on the contact normal
+			circle.center.x = firstHit.intersectPoint.x + firstHit.normal.x * skinWidth;
+			circle.center.y = firstHit.intersectPoint.y + firstHit.normal.y * skinWidth;
+			float normalSpeed{ velocity.DotProduct( firstHit.normal ) };
+			if ( normalSpeed < 0.0f )
+			{
+				velocity -= 2 * normalSpeed * firstHit.normal;
+			}
+			remainingSec *= 1.0f - firstHit.lambda;
+		}
+		return isHit;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+#include "Vector2f.h"
+
+namespace dae
+{
+	void SetColor( const Color4f& color );
+	
+	void DrawPoint( float x, float y, float pointSize = 1.0f );
+	void DrawPoint( const Point2f & p, float pointSize = 1.0f );
+	void DrawPoints( Point2f *pVertices, int nrVertices, float pointSize = 1.0f );
+
+	void DrawLine( float x1, float y1, float x2, float y2, float lineWidth = 1.0f );
+	void DrawLine( const Point2f & p1, const Point2f & p2, float lineWidth = 1.0f );
+
+	void DrawRect(float left, float bottom, float width, float height, float lineWidth = 1.0f);
+	void DrawRect(const Point2f & bottomLeft, float width, float height, float lineWidth = 1.0f);
+	void DrawRect(const Rectf & rect, float lineWidth = 1.0f);
+	void FillRect(float left, float bottom, float width, float height);
+	void FillRect(const Point2f & bottomLeft, float width, float height);
+	void FillRect(const Rectf & rect);
+
+	void DrawEllipse(float centerX, float centerY, float radX, float radY, float lineWidth = 1.0f);
+	void DrawEllipse(const Point2f & center, float radX, float radY, float lineWidth = 1.0f);
+	void FillEllipse(float centerX, float centerY, float radX, float radY);
+	void FillEllipse(const Point2f & center, float radX, float radY);
+
+	void DrawArc( float centerX, float centerY, float radX, float radY, float fromAngle, float tillAngle, float lineWidth = 1.0f );
+	void DrawArc( const Point2f & center, float radX, float radY, float fromAngle, float tillAngle, float lineWidth = 1.0f );
+	void FillArc( float centerX, float centerY, float radX, float radY, float fromAngle, float tillAngle );
+	void FillArc( const Point2f & center, float radX, float radY, float fromAngle, float tillAngle );
+
+	void DrawPolygon( Point2f *pVertices, int nrVertices, bool closed = true, float lineWidth = 1.0f );
+	void FillPolygon( Point2f *pVertices, int nrVertices);
+
+	// Collision: result of a sweep test
+	// lambda: time of impact as fraction [0,1] of the displacement
+	// intersectPoint: position of the moving shape (rect bottom-left, circle center) at the time of impact
+	// normal: surface normal of the obstacle at the contact point
+	struct HitInfo
+	{
+		float lambda;
+		Point2f intersectPoint;
+		Vector2f normal;
+	};
+
+	// Swept tests: does the shape, moving over displacement, hit the static rect?
+	// A shape that already overlaps the rect reports a hit with lambda 0.
+	bool SweptAABB( const Rectf& movingRect, const Vector2f& displacement, const Rectf& staticRect, HitInfo& hitInfo );
+	bool SweptCircle( const Circlef& movingCircle, const Vector2f& displacement, const Rectf& staticRect, HitInfo& hitInfo );
+
+	// Moves the circle over velocity * elapsedSec, stopping at each time of impact with one of the rects,
+	// reflecting the velocity and continuing with the remaining time (at most maxSubSteps times).
+	// Returns true when at least one rect was hit.
+	bool ResolveSweptCircle( Circlef& circle, Vector2f& velocity, float elapsedSec, const Rectf *pRects, int nrRects, int maxSubSteps = 4 );
+}
\ No newline at end of file
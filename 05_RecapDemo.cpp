@@ -23,7 +23,10 @@
 
 #include <iostream>
 #include <string>
+// structs.h and Random.h are in 00_General/10_Framework: copy them next to this file,
+// or add that folder to the include directories of the project
 #include "structs.h"
+#include "Random.h"
 #include <ctime>
 
 #pragma region windowInformation
@@ -92,6 +95,7 @@ const int g_NumBalls{ 20 };
 Ball g_Balls[g_NumBalls]{};
 const float g_VelocityScale{ 1.1f };
 bool g_IsGravityEnabled{ false };
+Random g_Random{ };
 const float g_Gravity{ -9.81f * 100};
 #pragma endregion gameDeclarations
 
@@ -99,7 +103,7 @@ const float g_Gravity{ -9.81f * 100};
 
 int main( int argc, char* args[] )
 {
-	srand( unsigned int( time( nullptr ) ) );
+	g_Random.Seed( Uint64( time( nullptr ) ) );
 
 	// Initialize SDL and OpenGL
 	Initialize( );
@@ -121,12 +125,12 @@ void InitGameResources( )
 		// vel [50,150]
 		// radius [5,50]
 		// color [0.0f,1.0f]
-		g_Balls[idx].velocity.x = rand( ) % ( 150 + 1 - 50 ) + 50.f;
-		g_Balls[idx].velocity.y = rand( ) % 101 + 50.f;
-		g_Balls[idx].radius = rand( ) % 46 + 5.0f;
-		g_Balls[idx].color.r = rand( ) % 101 / 100.f;
-		g_Balls[idx].color.g = rand( ) % 101 / 100.f;
-		g_Balls[idx].color.b = rand( ) % 101 / 100.f;
+		g_Balls[idx].velocity.x = float( g_Random.GetInt( 50, 150 ) );
+		g_Balls[idx].velocity.y = float( g_Random.GetInt( 50, 150 ) );
+		g_Balls[idx].radius = float( g_Random.GetInt( 5, 50 ) );
+		g_Balls[idx].color.r = g_Random.GetInt( 0, 100 ) / 100.f;
+		g_Balls[idx].color.g = g_Random.GetInt( 0, 100 ) / 100.f;
+		g_Balls[idx].color.b = g_Random.GetInt( 0, 100 ) / 100.f;
 		g_Balls[idx].color.a = 1.0f;
 	}
 }